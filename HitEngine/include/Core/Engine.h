@@ -8,6 +8,7 @@
 
 #include "Platform/Event.h"
 #include "Renderer/Renderer.h"
+#include "Utils/FrameAllocator.h"
 
 #include <string>
 
@@ -21,6 +22,24 @@ namespace hit
         ui16 main_window_height;
 
         RendererConfiguration renderer_config;
+
+        // per frame scratch memory, one arena per frame in flight
+        ui32 frame_allocator_count = 2;
+        ui64 frame_allocator_size = 64 * 1024 * 1024;
+
+        // memory statistics are appended to this file every memory_statistics_interval frames, 0 disables it
+        std::string memory_statistics_file = "memory_statistics.csv";
+        ui32 memory_statistics_interval = 0;
+
+        // a memory snapshot is taken every memory_snapshot_interval frames and its diff with the previous one is appended to the file
+        std::string memory_snapshot_file = "memory_snapshots.txt";
+        ui32 memory_snapshot_interval = 0;
+
+        // 1 in memory_trace_sample_rate allocations has its call site traced, 0 disables it
+        ui32 memory_trace_sample_rate = 0;
+
+        // budgets of the built in usages, no limits by default
+        Memory::UsageBudget memory_budgets[Memory::Usage::MaxUsageCount] = { };
     };
 
     class Engine final
@@ -44,6 +63,8 @@ namespace hit
 
         inline const RendererConfiguration& get_renderer_config() const { return m_engine_data.renderer_config; }
 
+        inline FrameAllocator& get_frame_allocator() { return m_frame_allocator; }
+
         EventCallback get_event_callback();
 
     private:
@@ -51,9 +72,13 @@ namespace hit
         bool handle_window_resize_event(WindowResizeEvent& event);
         bool handle_window_close_event(WindowCloseEvent& event);
 
+        void update_memory_snapshot();
+
     private:
         EngineData m_engine_data;
         ModulePipeline m_modules;
+        FrameAllocator m_frame_allocator;
+        Memory::MemorySnapshot m_memory_snapshot;
         bool m_invalid_window_size;
     };
 }
\ No newline at end of file
@@ -3,9 +3,16 @@
 #include "Types.h"
 #include "Log.h"
 
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <source_location>
+#include <string_view>
+#include <vector>
+
 namespace hit
 {
-    // TODO: make it thread safe
+    // all functions are thread safe, allocations carry an inline header with its usage and size
     namespace Memory
     {
         struct Usage
@@ -16,6 +23,8 @@ namespace hit
                 Handle_List,
                 Platform,
                 Renderer,
+
+                MaxUsageCount
             };
 
             Type usage = Any;
@@ -23,21 +32,225 @@ namespace hit
             ui8* memory = nullptr;
         };
 
+        constexpr ui32 default_alignment = 16;
+
+        // user tags are registered after the built in usages, up to max_usage_count usages in total
+        constexpr ui32 max_usage_count = 32;
+        constexpr ui32 max_usage_name_length = 32;
+
+        // allocation sizes are counted in power of two buckets from 16 bytes to 8MB, the last one counts bigger sizes too
+        constexpr ui32 size_histogram_bucket_count = 20;
+
+        struct UsageStatistics
+        {
+            Usage::Type usage = Usage::Any;
+
+            ui64 live_bytes = 0;
+            // threads publish its live bytes in 64KB steps, so a peak can be missed by up to 64KB per thread
+            ui64 peak_bytes = 0;
+            i64 live_allocations = 0;
+
+            ui64 total_allocations = 0;
+            ui64 total_frees = 0;
+
+            // counts of the last frame closed by end_memory_frame
+            ui64 frame_allocations = 0;
+            ui64 frame_frees = 0;
+
+            ui64 size_histogram[size_histogram_bucket_count] = { };
+        };
+
+        constexpr ui32 max_backtrace_depth = 16;
+
+        // counts of a traced call site. when sampling, every sampled allocation stands for sample_rate ones,
+        // so the counts are estimations of the real ones
+        struct AllocationSite
+        {
+            std::source_location location;
+            Usage::Type usage = Usage::Any;
+
+            // return addresses, only captured when asked for
+            void* backtrace[max_backtrace_depth] = { };
+            ui32 backtrace_depth = 0;
+
+            ui64 total_allocations = 0;
+            ui64 total_bytes = 0;
+            ui64 live_allocations = 0;
+            ui64 live_bytes = 0;
+
+            // counts of the last frame closed by end_memory_frame
+            ui64 frame_allocations = 0;
+            ui64 frame_bytes = 0;
+        };
+
+        // limits are in bytes, 0 is no limit. crossing the soft limit calls the eviction callbacks of the usage once,
+        // until it goes under it again. an allocation which would cross the hard limit fails and returns null.
+        // threads publish its live bytes in 64KB steps, so a limit can be crossed by up to 64KB per thread
+        struct UsageBudget
+        {
+            ui64 soft_limit = 0;
+            ui64 hard_limit = 0;
+        };
+
+        // excess_bytes are the bytes the usage is over its soft limit, or over its hard limit when an allocation
+        // would fail. callbacks run on the allocating thread and may release memory of any usage
+        using EvictionCallback = std::function<void(Usage::Type usage, ui64 excess_bytes)>;
+
+        // state of every usage, and of every traced site when tracing is on
+        struct MemorySnapshot
+        {
+            ui64 frame = 0;
+            std::vector<UsageStatistics> usages;
+            std::vector<AllocationSite> sites;
+        };
+
+        // new and freed are the allocations made and released between the snapshots, grown bytes go negative on shrinking
+        struct UsageDiff
+        {
+            Usage::Type usage = Usage::Any;
+            ui64 new_allocations = 0;
+            ui64 freed_allocations = 0;
+            i64 grown_bytes = 0;
+        };
+
+        struct AllocationSiteDiff
+        {
+            AllocationSite site;
+            ui64 new_allocations = 0;
+            ui64 freed_allocations = 0;
+            i64 grown_bytes = 0;
+        };
+
+        // sorted by grown bytes, the biggest growth first
+        struct MemorySnapshotDiff
+        {
+            ui64 first_frame = 0;
+            ui64 last_frame = 0;
+            std::vector<UsageDiff> usages;
+            std::vector<AllocationSiteDiff> sites;
+        };
+
+        struct AllocationOptions
+        {
+            // when false the memory content is left as it comes from the allocator
+            bool zeroed = true;
+
+            // power of two, values lower than default_alignment are rounded up
+            ui32 alignment = default_alignment;
+
+            // asks the os to back big blocks(2MB or more) with transparent huge pages, ignored where not supported
+            bool huge_pages = false;
+        };
+
+        constexpr AllocationOptions uninitialized_allocation = { false };
+
+        // resets the counters of every thread too, so no other thread may allocate or free while it runs
         bool initialize_memory_system();
         bool shutdown_memory_system();
 
-        ui8* allocate_memory(ui64 size, Usage::Type usage);
+        // the location is only read when the allocation is traced
+        ui8* allocate_memory(ui64 size, Usage::Type usage, std::source_location location = std::source_location::current());
+        ui8* allocate_memory(ui64 size, Usage::Type usage, const AllocationOptions& options,
+            std::source_location location = std::source_location::current());
         void deallocate_memory(ui8* memory);
 
+        // keeps the alignment the memory was allocated with, grown bytes are not initialized
         ui8* reallocate_memory(ui8* memory, ui64 new_size);
         ui8* copy_memory(ui8* dst, const ui8* src, ui64 copy_size);
 
         ui8* set_memory(ui8* memory, i32 value, ui64 size);
 
         Usage get_usage(ui8* memory);
+        // memory must be a pointer returned by the memory system or at least a readable one
         bool has_memory(ui8* memory);
 
-        Usage allocate_usage(ui64 size, Usage::Type usage);
+        ui64 get_memory_used(Usage::Type usage);
+        ui64 get_total_memory_used();
+
+        void set_usage_budget(Usage::Type usage, const UsageBudget& budget);
+        UsageBudget get_usage_budget(Usage::Type usage);
+
+        // returns an id to remove the callback with
+        ui32 add_eviction_callback(Usage::Type usage, const EvictionCallback& callback);
+        void remove_eviction_callback(ui32 callback_id);
+
+        // registering a name twice returns the same tag, Usage::Any is returned when every tag is taken
+        Usage::Type register_usage_tag(std::string_view name);
+        std::string_view get_usage_name(Usage::Type usage);
+        // built in usages included
+        ui32 get_usage_count();
+
+        // telemetry is always on, every thread counts on its own and the counters are summed when queried
+        UsageStatistics get_usage_statistics(Usage::Type usage);
+        constexpr ui64 get_size_histogram_bucket_size(ui32 bucket) { return (ui64)16 << bucket; }
+
+        // closes the frame counters, statistics are appended to the dump file every frame_interval frames
+        void end_memory_frame();
+        ui64 get_memory_frame();
+
+        // appends a csv row per usage to filename, set a 0 interval to stop the periodic dump
+        bool dump_memory_statistics(std::string_view filename);
+        void set_memory_statistics_dump(std::string_view filename, ui32 frame_interval);
+
+        // allocation tracing records the call site of 1 in sample_rate allocations, 1 traces all of them.
+        // an allocation made by a container is located inside of it, a backtrace tells who used the container
+        void enable_allocation_tracing(ui32 sample_rate = 1, bool capture_backtrace = false);
+        void disable_allocation_tracing();
+        bool is_allocation_tracing_enabled();
+
+        std::vector<AllocationSite> get_allocation_sites();
+
+        // ranks the sites by allocations in the last frame and by live bytes, at most site_count of each
+        bool write_allocation_report(std::string_view filename, ui32 site_count = 20);
+
+        MemorySnapshot take_snapshot();
+        // first must be taken before last, unchanged usages and sites are left out
+        MemorySnapshotDiff diff(const MemorySnapshot& first, const MemorySnapshot& last);
+        // appended to filename
+        bool write_snapshot_diff(std::string_view filename, const MemorySnapshotDiff& snapshot_diff, ui32 site_count = 20);
+
+        // virtual memory, a reserved range is only backed by memory once committed.
+        // ranges must be page aligned and committed bytes are accounted to the given usage
+        ui64 get_page_size();
+        ui8* reserve_virtual_memory(ui64 size, Usage::Type usage);
+        bool commit_virtual_memory(ui8* memory, ui64 size, Usage::Type usage);
+        void decommit_virtual_memory(ui8* memory, ui64 size, Usage::Type usage);
+        void release_virtual_memory(ui8* memory, ui64 reserved_size, ui64 committed_size, Usage::Type usage);
+
+        // allocations and reallocations made by the calling thread since it started, global operator new ones
+        // are included when the program counts them with hit_count_global_new
+        ui64 get_thread_allocation_count();
+
+        // global operator new and delete of hit_count_global_new, out of line so the compiler always pairs
+        // the malloc and free behind them. allocating counts for the calling thread and throws std::bad_alloc on failure
+        void* allocate_global_memory(std::size_t size);
+        void deallocate_global_memory(void* memory) noexcept;
+
+        // AllocationGuard checks a scope doesn't allocate more than its budget on the calling thread.
+        // an exceeded budget is logged when the guard ends, and asserts too when fail_on_exceed is set
+        class AllocationGuard
+        {
+        public:
+            AllocationGuard(std::string_view name, ui64 budget = 0, bool fail_on_exceed = true);
+            AllocationGuard(const AllocationGuard& other) = delete;
+
+            ~AllocationGuard();
+
+            AllocationGuard& operator=(const AllocationGuard& other) = delete;
+
+            ui64 allocation_count() const;
+            inline bool exceeded() const { return allocation_count() > m_budget; }
+
+        private:
+            std::string_view m_name;
+            ui64 m_budget;
+            ui64 m_first_count;
+            bool m_fail_on_exceed;
+        };
+
+        Usage allocate_usage(ui64 size, Usage::Type usage, std::source_location location = std::source_location::current());
+        Usage allocate_usage(ui64 size, Usage::Type usage, const AllocationOptions& options,
+            std::source_location location = std::source_location::current());
         void deallocate_usage(Usage& usage);
 
         Usage reallocate_usage(Usage& usage, ui64 new_size);
@@ -48,7 +261,10 @@ namespace hit
         template<typename T, typename... Args>
         T* allocate_initialized_memory(Usage::Type usage = Usage::Any, Args&&... args)
         {
+            // null when the usage is over its hard limit
             auto memory = (T*)allocate_memory(sizeof(T), usage);
+            if(!memory) return nullptr;
+
             new (memory) T(std::forward<Args>(args)...);
             return memory;
         }
@@ -64,6 +280,15 @@ namespace hit
     using MemoryUsage = Memory::Usage::Type;
 }
 
+// replaces global operator new so AllocationGuard counts it too, expand it once in the program at global scope
+#define hit_count_global_new()                                                                                  \
+    void* operator new(std::size_t size) { return hit::Memory::allocate_global_memory(size); }                  \
+    void* operator new[](std::size_t size) { return hit::Memory::allocate_global_memory(size); }                \
+    void operator delete(void* memory) noexcept { hit::Memory::deallocate_global_memory(memory); }              \
+    void operator delete[](void* memory) noexcept { hit::Memory::deallocate_global_memory(memory); }            \
+    void operator delete(void* memory, std::size_t) noexcept { hit::Memory::deallocate_global_memory(memory); } \
+    void operator delete[](void* memory, std::size_t) noexcept { hit::Memory::deallocate_global_memory(memory); }
+
 //Usage custom string format
 template<>
 struct std::formatter<hit::MemoryUsage>
@@ -88,7 +313,7 @@ struct std::formatter<hit::MemoryUsage>
                 return std::format_to(ctx.out(), "Renderer");
 
             default: 
-                return std::format_to(ctx.out(), "None");
+                return std::format_to(ctx.out(), "{}", hit::Memory::get_usage_name(usage));
         }
     }
 };
@@ -2,14 +2,21 @@
 
 #include "Core/Types.h"
 #include "Utils/Ref.h"
+#include "Utils/Arena.h"
+#include "Utils/MemoryResource.h"
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <variant>
 #include <map>
+#include <memory_resource>
 
 namespace hit::config
 {
+	// every container of a configuration is allocated from the memory resource of its file
+	using Allocator = std::pmr::polymorphic_allocator<>;
+
 	class Value
 	{
 	public:
@@ -18,20 +25,29 @@ namespace hit::config
 			String, Number
 		};
 
+		using allocator_type = Allocator;
+
 	public:
-		Value() : m_type(Number), m_value(0.0) { }
-		Value(const std::string& str) : m_type(String), m_value(str) { }
-		Value(f64 number) : m_type(Number), m_value(number) { }
+		Value(const Allocator& = { }) : m_type(Number), m_value(0.0) { }
+		Value(std::string_view str, const Allocator& allocator = { }) : m_type(String), m_value(std::in_place_index<String>, str, allocator) { }
+		Value(f64 number, const Allocator& = { }) : m_type(Number), m_value(number) { }
+
+		Value(const Value& other, const Allocator& allocator = { });
+		Value(Value&& other, const Allocator& allocator);
+		Value(Value&& other) noexcept = default;
+
+		Value& operator=(const Value& other) = default;
+		Value& operator=(Value&& other) = default;
 
 		inline bool is_string() const { return m_type == String; }
 		inline bool is_number() const { return m_type == Number; }
 
-		constexpr const std::string& get_string() const { return std::get<String>(m_value); }
+		constexpr const std::pmr::string& get_string() const { return std::get<String>(m_value); }
 		constexpr f64 get_number() const { return std::get<Number>(m_value); }
 
 	private:
 		Type m_type;
-		std::variant<std::string, f64> m_value;
+		std::variant<std::pmr::string, f64> m_value;
 	};
 
 	class Property
@@ -42,58 +58,89 @@ namespace hit::config
 			Single, List
 		};
 
+		using allocator_type = Allocator;
+
 	public:
-		Property() : m_identifier(""), m_type(Single), m_value(Value()) { }
-		Property(const std::string& identifier, const Value& value) : m_identifier(identifier), m_type(Single), m_value(value) { }
-		Property(const std::string& identifier, const std::vector<Value>& values) : m_identifier(identifier), m_type(List), m_value(values) { }
+		Property(const Allocator& allocator = { }) : m_identifier(allocator), m_type(Single), m_value(std::in_place_index<Single>, allocator) { }
+		Property(std::string_view identifier, const Value& value, const Allocator& allocator = { })
+			: m_identifier(identifier, allocator), m_type(Single), m_value(std::in_place_index<Single>, value, allocator) { }
+		Property(std::string_view identifier, const std::pmr::vector<Value>& values, const Allocator& allocator = { })
+			: m_identifier(identifier, allocator), m_type(List), m_value(std::in_place_index<List>, values, allocator) { }
+
+		Property(const Property& other, const Allocator& allocator = { });
+		Property(Property&& other, const Allocator& allocator);
+		Property(Property&& other) noexcept = default;
+
+		Property& operator=(const Property& other) = default;
+		Property& operator=(Property&& other) = default;
 
 		inline bool is_single() const { return m_type == Single; }
 		inline bool is_list() const { return m_type == List; }
 
-		void set_value(const Value& value) { m_type = Single; m_value = value; }
-		void set_value(const std::vector<Value>& values) { m_type = List; m_value = values; }
+		void set_value(const Value& value) { m_type = Single; m_value.emplace<Single>(value, get_allocator()); }
+		void set_value(Value&& value) { m_type = Single; m_value.emplace<Single>(std::move(value), get_allocator()); }
+		void set_value(const std::pmr::vector<Value>& values) { m_type = List; m_value.emplace<List>(values, get_allocator()); }
+		void set_value(std::pmr::vector<Value>&& values) { m_type = List; m_value.emplace<List>(std::move(values), get_allocator()); }
 		constexpr const Value& get_single_value() const { return std::get<Single>(m_value); }
-		constexpr const std::vector<Value>& get_list_value() const { return std::get<List>(m_value); }
+		constexpr const std::pmr::vector<Value>& get_list_value() const { return std::get<List>(m_value); }
 
-		void set_identifier(const std::string& identifier) { m_identifier = identifier; }
-		const std::string& get_identifier() const { return m_identifier; }
+		void set_identifier(std::string_view identifier) { m_identifier = identifier; }
+		const std::pmr::string& get_identifier() const { return m_identifier; }
+
+		inline Allocator get_allocator() const { return m_identifier.get_allocator(); }
 
 	private:
+		std::pmr::string m_identifier;
 		Type m_type;
-		std::variant <Value, std::vector<Value>> m_value;
-		std::string m_identifier;
+		std::variant<Value, std::pmr::vector<Value>> m_value;
 	};
 
 	class Block
 	{
 	public:
-		Block(const std::string& identifier = "") : m_identifier(identifier) { }
+		using allocator_type = Allocator;
+
+	public:
+		Block(std::string_view identifier = "", const Allocator& allocator = { })
+			: m_identifier(identifier, allocator), m_source_content(allocator), m_properties(allocator), m_inner_blocks(allocator) { }
+
+		Block(const Block& other, const Allocator& allocator = { });
+		Block(Block&& other, const Allocator& allocator);
+		Block(Block&& other) noexcept = default;
+
+		Block& operator=(const Block& other) = default;
+		Block& operator=(Block&& other) = default;
 
 		bool is_source_block() const;
 
-		void set_source_block_content(const std::string& source) { m_source_content = source; }
+		void set_source_block_content(std::string_view source) { m_source_content = source; }
 		std::string get_source_block_content() const;
 
-		bool has_property(const std::string& identifier) const;
-		Property get_property(const std::string& identifier) const;
+		bool has_property(std::string_view identifier) const;
+		Property get_property(std::string_view identifier) const;
 
-		bool has_inner_block(const std::string& identifier) const;
-		const Block* get_inner_block(const std::string& identifier) const;
+		bool has_inner_block(std::string_view identifier) const;
+		const Block* get_inner_block(std::string_view identifier) const;
 
-		void set_identifier(const std::string& identifier) { m_identifier = identifier; }
-		const std::string& get_identifier() const { return m_identifier; }
+		void set_identifier(std::string_view identifier) { m_identifier = identifier; }
+		const std::pmr::string& get_identifier() const { return m_identifier; }
 
 		void add_property(const Property& property);
+		void add_property(Property&& property);
+
 		void add_inner_block(const Block& block);
+		void add_inner_block(Block&& block);
+
+		const std::pmr::map<std::pmr::string, Property, std::less<>>& get_properties() const { return m_properties; }
 
-		const std::map<std::string, Property>& get_properties() const { return m_properties; }
+		inline Allocator get_allocator() const { return m_identifier.get_allocator(); }
 
 	private:
-		std::string m_identifier;
+		std::pmr::string m_identifier;
 
-		std::string m_source_content;
-		std::map<std::string, Property> m_properties;
-		std::map<std::string, Ref<Block>> m_inner_blocks;
+		std::pmr::string m_source_content;
+		std::pmr::map<std::pmr::string, Property, std::less<>> m_properties;
+		std::pmr::map<std::pmr::string, Ref<Block>, std::less<>> m_inner_blocks;
 	};
 
 	struct Token
@@ -113,13 +160,13 @@ namespace hit::config
 		Type type;
 		ui32 line;
 		ui32 column;
-		std::string value;
+		std::string_view value; // points into the parsed source
 	};
 
 	class SourceReader
 	{
 	public:
-		SourceReader(const std::string& source);
+		SourceReader(std::string_view source);
 
 		Token get_next(bool reading_source_content = false);
 
@@ -152,16 +199,16 @@ namespace hit::config
 		ui32 m_line;
 		ui32 m_column;
 		ui64 m_current;
-		std::string m_source;
+		std::string_view m_source;
 	};
 
 	class TokenReader
 	{
 	public:
-		TokenReader(const std::string& source);
+		TokenReader(std::string_view source, Arena* scratch_arena);
 
-		Token get_current();
-		Token get_past();
+		const Token& get_current();
+		const Token& get_past();
 
 		bool has_next();
 		bool has_past();
@@ -179,15 +226,19 @@ namespace hit::config
 
 	private:
 		ui64 m_current;
-		std::vector<Token> m_tokens;
+		ArenaVector<Token> m_tokens;
 	};
 
 	class Parser
 	{
 	public:
-		Parser(const std::string& source);
+		// source must outlive the parser. temporaries are pushed to scratch_arena when given
+		// and the caller rewinds it, otherwise they come from the memory system.
+		// blocks are allocated from resource
+		Parser(std::string_view source, Arena* scratch_arena = nullptr, 
+			   std::pmr::memory_resource* resource = get_usage_memory_resource(MemoryUsage::Any));
 
-		std::vector<Block> build_block_tree();
+		std::pmr::vector<Block> build_block_tree();
 
 	private:
 		Block parse_block();
@@ -198,19 +249,22 @@ namespace hit::config
 
 	private:
 		TokenReader m_reader;
+		Allocator m_allocator;
 	};
 
 	class StandardConfigurationFile
 	{
 	public:
-		StandardConfigurationFile(const std::string& source);
+		// the whole configuration is allocated from a pool accounted to usage
+		StandardConfigurationFile(std::string_view source, MemoryUsage usage = MemoryUsage::Any);
 
 		bool has_configuration();
 
-		bool has_block(const std::string& identifier);
-		Block* get_block(const std::string& identifier);
+		bool has_block(std::string_view identifier);
+		Block* get_block(std::string_view identifier);
 
 	private:
-		std::map<std::string, Block> m_root_blocks;
+		Scope<PoolMemoryResource> m_resource;
+		std::pmr::map<std::pmr::string, Block, std::less<>> m_root_blocks;
 	};
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "Vec4.h"
 #include "Vec3.h"
 
+#include <span>
+
 namespace hit
 {
     union Mat4
@@ -40,8 +42,13 @@ namespace hit
         inline Vec4& operator[](ui64 index);
         inline const Vec4& operator[](ui64 index) const;
 
+        inline bool compare_to(const Mat4& other, f32 tolerance = 0.001f) const;
+
         Mat4 transposed() const;
         Mat4 inverse() const;
+
+        // cheaper inverse of translation, rotation and scale only matrices, the last row must be (0, 0, 0, 1)
+        Mat4 affine_inverse() const;
     };
 
     inline constexpr Mat4::Mat4() : data {} { }
@@ -58,7 +65,16 @@ namespace hit
         return columns[index];
     }
 
+    inline bool Mat4::compare_to(const Mat4& other, f32 tolerance) const
+    {
+        return columns[0].compare_to(other.columns[0], tolerance) &&
+               columns[1].compare_to(other.columns[1], tolerance) &&
+               columns[2].compare_to(other.columns[2], tolerance) &&
+               columns[3].compare_to(other.columns[3], tolerance);
+    }
+
     // Mat4 helper functions
+    // multiplies, inverses, transposes and Vec4 transforms run on the kernels of get_simd_level()
     Mat4 mat4_add(const Mat4& m1, const Mat4& m2);
     Mat4 mat4_sub(const Mat4& m1, const Mat4& m2);
     Mat4 mat4_mul(const Mat4& m1, const Mat4& m2);
@@ -71,6 +87,13 @@ namespace hit
     Vec3 mat4_mult_vec3(const Mat4& m, const Vec3& v);
     Vec3 mat4_mult_vec3(const Vec3& v, const Mat4& m);
 
+    // batches of points as structure of arrays, out = m * (x, y, z, 1) like v * m.
+    // all spans have the same size, the outputs may be the inputs
+    void transform_points(const Mat4& m, std::span<const f32> xs, std::span<const f32> ys, std::span<const f32> zs, std::span<f32> out_xs, std::span<f32> out_ys, std::span<f32> out_zs);
+
+    // out_m[i] = m1[i] * m2[i], out_m may be one of the inputs
+    void mat4_mul_batch(std::span<const Mat4> m1, std::span<const Mat4> m2, std::span<Mat4> out_m);
+
     Mat4 mat4_orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 near, f32 far);
     Mat4 mat4_perspective(f32 fov, f32 aspect_ratio, f32 near, f32 far);
 
@@ -9,4 +9,8 @@
 #include "Vec4.h"
 
 // matrix
-#include "Mat4.h"
\ No newline at end of file
+#include "Mat4.h"
+
+// rotation
+#include "Quat.h"
+#include "Transform.h"
\ No newline at end of file
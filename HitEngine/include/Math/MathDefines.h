@@ -25,6 +25,9 @@ namespace hit
     inline auto htan(f32 value) { return std::tan(value); }
     inline auto htan(f64 value) { return std::tan(value); }
 
+    inline auto hacos(f32 value) { return std::acos(value); }
+    inline auto hacos(f64 value) { return std::acos(value); }
+
     inline auto hsqrt(f32 value) { return std::sqrt(value); }
     inline auto hsqrt(f64 value) { return std::sqrt(value); }
 }
\ No newline at end of file
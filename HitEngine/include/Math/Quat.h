@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Core/Assert.h"
+#include "Core/Types.h"
+#include "MathDefines.h"
+#include "Vec3.h"
+#include "Mat4.h"
+
+namespace hit
+{
+    // rotation as a unit quaternion, x, y and z are the vector part
+    union Quat
+    {
+        f32 elements[4];
+        struct
+        {
+            f32 x, y, z, w;
+        };
+
+        // the identity rotation, a zero quaternion isn't a rotation
+        constexpr inline Quat();
+        inline Quat(f32 x, f32 y, f32 z, f32 w);
+        inline Quat(const Quat&) = default;
+
+        inline Quat& operator=(const Quat&) = default;
+
+        inline f32& operator[](ui64 index);
+        inline const f32& operator[](ui64 index) const;
+
+        inline bool operator==(const Quat& other) const;
+        inline bool operator!=(const Quat& other) const;
+        inline bool compare_to(const Quat& other, f32 tolerance = 0.001f) const;
+
+        inline f32 length() const;
+        inline Quat& normalize();
+
+        inline f32 dot(const Quat& other) const;
+
+        // the inverse of a unit quaternion
+        inline Quat conjugate() const;
+        inline Quat inverse() const;
+    };
+
+    constexpr inline Quat::Quat() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) { }
+
+    inline Quat::Quat(f32 x, f32 y, f32 z, f32 w) : x(x), y(y), z(z), w(w) { }
+
+    inline f32& Quat::operator[](ui64 index)
+    {
+        hit_assert(index <= 3, "Invalid Quat index!");
+        return elements[index];
+    }
+
+    inline const f32& Quat::operator[](ui64 index) const
+    {
+        hit_assert(index <= 3, "Invalid Quat index!");
+        return elements[index];
+    }
+
+    inline bool Quat::operator==(const Quat& other) const
+    {
+        return compare_to(other);
+    }
+
+    inline bool Quat::operator!=(const Quat& other) const
+    {
+        return !compare_to(other);
+    }
+
+    inline bool Quat::compare_to(const Quat& other, f32 tolerance) const
+    {
+        return (std::abs(x - other.x) <= tolerance) &&
+               (std::abs(y - other.y) <= tolerance) &&
+               (std::abs(z - other.z) <= tolerance) &&
+               (std::abs(w - other.w) <= tolerance);
+    }
+
+    inline f32 Quat::length() const
+    {
+        return (f32)hsqrt(x * x + y * y + z * z + w * w);
+    }
+
+    inline Quat& Quat::normalize()
+    {
+        const f32 len = length();
+        x /= len;
+        y /= len;
+        z /= len;
+        w /= len;
+        return *this;
+    }
+
+    inline f32 Quat::dot(const Quat& other) const
+    {
+        return x * other.x + y * other.y + z * other.z + w * other.w;
+    }
+
+    inline Quat Quat::conjugate() const
+    {
+        return { -x, -y, -z, w };
+    }
+
+    inline Quat Quat::inverse() const
+    {
+        const f32 length_squared = dot(*this);
+        return { -x / length_squared, -y / length_squared, -z / length_squared, w / length_squared };
+    }
+
+    // Quat helper functions
+    // multiplies and rotations run on the kernels of get_simd_level(), angles are in degrees like the Mat4 ones
+    Quat quat_identity();
+
+    // axis must be normalized
+    Quat quat_from_axis_angle(const Vec3& axis, f32 angle);
+
+    // the same rotation as mat4_euler_rotation
+    Quat quat_from_euler(const Vec3& v);
+    Quat quat_from_euler(f32 x, f32 y, f32 z);
+
+    // q1 * q2 rotates by q2 first
+    Quat quat_mul(const Quat& q1, const Quat& q2);
+    Vec3 quat_rotate(const Quat& q, const Vec3& v);
+
+    // interpolate the shorter way around, nlerp is cheaper but doesn't keep a constant speed
+    Quat quat_nlerp(const Quat& q1, const Quat& q2, f32 t);
+    Quat quat_slerp(const Quat& q1, const Quat& q2, f32 t);
+
+    Mat4 quat_to_mat4(const Quat& q);
+
+    // Quat operators
+    inline Quat operator*(const Quat& q1, const Quat& q2)
+    {
+        return quat_mul(q1, q2);
+    }
+
+    inline Vec3 operator*(const Quat& q, const Vec3& v)
+    {
+        return quat_rotate(q, v);
+    }
+}
\ No newline at end of file
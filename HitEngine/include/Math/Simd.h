@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Core/Types.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define HIT_SIMD_X64
+#include <immintrin.h>
+#endif
+
+// kernels of a higher level are compiled for their instruction set only, the rest of the
+// engine keeps the x64 baseline and they are picked at runtime. msvc doesn't need it for intrinsics
+#if defined(HIT_SIMD_X64) && !defined(MSVC)
+#define HIT_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define HIT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define HIT_TARGET_SSE41
+#define HIT_TARGET_AVX2
+#endif
+
+namespace hit
+{
+    enum class SimdLevel : ui8
+    {
+        Scalar,
+        Sse41,
+        Avx2,
+
+        Count
+    };
+
+    // the best level of the cpu, avx2 is only used together with fma
+    SimdLevel get_supported_simd_level();
+
+    // level used by the math kernels, detected at startup.
+    // it's Scalar until then, so math used by static initializers still works
+    SimdLevel get_simd_level();
+
+    // lowers the level to compare or benchmark kernels, it can't go above the supported one
+    void set_simd_level(SimdLevel level);
+
+    const char* get_simd_level_name(SimdLevel level);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Vec3.h"
+#include "Quat.h"
+#include "Mat4.h"
+
+#include <span>
+
+namespace hit
+{
+    // translation, rotation and scale, applied as T * R * S like the Mat4 it turns into.
+    // 40 bytes against the 64 of a Mat4
+    struct Transform
+    {
+        Vec3 translation;
+        Quat rotation;
+        Vec3 scale = Vec3(1.0f);
+
+        inline bool compare_to(const Transform& other, f32 tolerance = 0.001f) const;
+    };
+
+    inline bool Transform::compare_to(const Transform& other, f32 tolerance) const
+    {
+        return translation.compare_to(other.translation, tolerance) &&
+               rotation.compare_to(other.rotation, tolerance) &&
+               scale.compare_to(other.scale, tolerance);
+    }
+
+    // Transform helper functions
+    // composition, inverse and conversion run on the kernels of get_simd_level()
+    Transform transform_identity();
+
+    // parent * child, the child transform inside of the parent one.
+    // exact for uniform scales, a non uniform parent scale can't skew a rotated child and is applied per axis
+    Transform transform_mul(const Transform& parent, const Transform& child);
+
+    // exact for uniform scales, like transform_mul
+    Transform transform_inverse(const Transform& t);
+
+    // lerps translation and scale, nlerps the rotation
+    Transform transform_lerp(const Transform& t1, const Transform& t2, f32 t);
+
+    Vec3 transform_point(const Transform& t, const Vec3& v);
+
+    // T * R * S without building the three matrices
+    Mat4 transform_to_mat4(const Transform& t);
+
+    // transforms and out_m have the same size
+    void transform_to_mat4_batch(std::span<const Transform> transforms, std::span<Mat4> out_m);
+
+    // Transform operators
+    inline Transform operator*(const Transform& parent, const Transform& child)
+    {
+        return transform_mul(parent, child);
+    }
+
+    inline Vec3 operator*(const Transform& t, const Vec3& v)
+    {
+        return transform_point(t, v);
+    }
+}
\ No newline at end of file
@@ -3,11 +3,15 @@
 #include "Core/Types.h"
 #include "Utils/SerializableObject.h"
 #include "Utils/Freelist.h"
+#include "Utils/Tlsf.h"
+#include "Utils/Buddy.h"
 #include "Utils/Ref.h"
 
 #include <vector>
 #include <initializer_list>
 #include <string>
+#include <span>
+#include <functional>
 
 namespace hit
 {
@@ -83,13 +87,19 @@ namespace hit
     enum class BufferAllocationType : ui8
     {
         None,
-        FreeList
+        FreeList,
+        Tlsf,
+        Buddy
     };
 
+    // called for each allocation moved by a defragmentation
+    using BufferRemapCallback = std::function<void(ui64 old_offset, ui64 new_offset)>;
+
     class Buffer
     {
     public:
-        virtual bool create(ui64 initial_size, BufferType type, BufferAllocationType allocation) = 0;
+        // buffers sub-allocate with tlsf unless they ask for another allocation type, None is a single resource
+        virtual bool create(ui64 initial_size, BufferType type, BufferAllocationType allocation = BufferAllocationType::Tlsf) = 0;
         virtual void destroy() = 0;
 
         virtual bool bind(ui64 offset = 0) = 0;
@@ -109,7 +119,14 @@ namespace hit
 
         virtual bool copy(Buffer& other, ui64 size, ui64 dest_offset = 0, ui64 src_offset = 0) = 0;
 
+        // copies every region from other in a single command
+        virtual bool copy(Buffer& other, std::span<const SubAllocationCopy> regions) = 0;
+
+        // compacts the given live allocations to the start of the buffer, every other range is freed
+        virtual bool defragment(std::span<const SubAllocation> allocations, const BufferRemapCallback& remap) = 0;
+
         inline ui64 get_total_size() { return m_total_size; }
+        inline ui64 get_min_alignment() { return m_min_alignment; }
 
         inline bool is_valid() { return m_type != BufferType::Unknown; }
         inline bool is_vertex() { return m_type == BufferType::Vertex; }
@@ -120,6 +137,13 @@ namespace hit
         inline bool is_storage() { return m_type == BufferType::Storage; }
 
         inline bool use_freelist() { return m_allocation_type == BufferAllocationType::FreeList; }
+        inline bool use_tlsf() { return m_allocation_type == BufferAllocationType::Tlsf; }
+        inline bool use_buddy() { return m_allocation_type == BufferAllocationType::Buddy; }
+
+        // sub-allocates a range of the buffer with its allocation type,
+        // the offset is aligned at least to the minimum offset alignment of the buffer type
+        bool allocate(ui64 size, ui64& out_offset, ui64 alignment = 1);
+        bool deallocate(ui64 size, ui64 offset);
 
     public:
         Buffer() = default;
@@ -136,7 +160,10 @@ namespace hit
         BufferAllocationType m_allocation_type;
 
         ui64 m_total_size;
+        ui64 m_min_alignment = 1;
         Scope<FreelistCore> m_freelist = nullptr;
+        Scope<TlsfAllocator> m_tlsf = nullptr;
+        Scope<BuddyAllocator> m_buddy = nullptr;
 
         bool m_is_locked;
     };
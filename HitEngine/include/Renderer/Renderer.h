@@ -27,6 +27,10 @@ namespace hit
         bool power_save_mode;
     };
 
+    // frames rendered after initializing or resizing, before rendering one must not allocate anymore.
+    // it's only checked on debug builds
+    constexpr ui32 render_warmup_frame_count = 3;
+
     class Renderer : public Module
     {
     public:
@@ -53,6 +57,7 @@ namespace hit
         ui16 m_frame_height;
         ui64 m_frame_generation;
         ui64 m_frame_last_generation;
+        ui32 m_warmup_frames_left = render_warmup_frame_count;
 
     private:
         void resize(ui16 width, ui16 height);
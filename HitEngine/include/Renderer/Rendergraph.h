@@ -3,12 +3,15 @@
 #include "Core/Types.h"
 #include "Renderer/Renderpass.h"
 #include "Utils/Ref.h"
+#include "Utils/FrameAllocator.h"
+#include "Utils/MemoryResource.h"
 
 #include <vector>
 #include <array>
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include <map>
+#include <memory_resource>
 
 namespace hit
 {
@@ -16,7 +19,11 @@ namespace hit
 	class Rendergraph;
 	class UnbakedRendergraph;
 
-	struct FrameData { };
+	struct FrameData
+	{
+		// transient memory, valid until the end of the frame
+		FrameAllocator* frame_allocator = nullptr;
+	};
 
 	struct RendergraphResource
 	{
@@ -110,21 +117,25 @@ namespace hit
 		std::vector<RendergraphPassDependency> pass_dependencies;
 	};
 
+	// pass names are looked up by string_view, so the locators don't build temporary strings
+	using RendergraphPassLocator = std::pmr::map<std::pmr::string, ui32, std::less<>>;
+
 	class UnbakedRendergraph
 	{
 	public:
-		UnbakedRendergraph() = default;
+		// it only lives while the graph is built, so a monotonic resource fits it
+		UnbakedRendergraph(std::pmr::memory_resource* resource = get_usage_memory_resource(MemoryUsage::Renderer));
 		~UnbakedRendergraph() = default;
 
-		bool add_pass(const std::string& name, const UnbakedPass& pass);
+		bool add_pass(std::string_view name, const UnbakedPass& pass);
 
 	private:
-		bool has_pass(const std::string& pass_name) const;
-		bool has_pass_resource(const std::string& pass_name, const std::string& resource_name) const;
+		bool has_pass(std::string_view pass_name) const;
+		bool has_pass_resource(std::string_view pass_name, std::string_view resource_name) const;
 
 	private:
-		std::vector<UnbakedPass> m_passes;
-		std::unordered_map<std::string, ui32> m_passes_name_locator;
+		std::pmr::vector<UnbakedPass> m_passes;
+		RendergraphPassLocator m_passes_name_locator;
 
 		friend Rendergraph;
 	};
@@ -132,7 +143,7 @@ namespace hit
 	class Rendergraph
 	{
 	public:
-		Rendergraph() = default;
+		Rendergraph();
 		~Rendergraph() = default;
 
 		bool initialize(const Renderer* renderer, const UnbakedRendergraph& unbaked);
@@ -141,13 +152,13 @@ namespace hit
 		bool on_render(FrameData* frame_data);
 		bool on_resize(ui32 new_width, ui32 new_height);
 
-		bool has_pass(const std::string& pass_name) const;
-		const Ref<RendergraphPass> get_pass(const std::string& pass_name) const;
+		bool has_pass(std::string_view pass_name) const;
+		const Ref<RendergraphPass> get_pass(std::string_view pass_name) const;
 
 	private:
 		std::array<RendergraphResource, RendergraphGlobalDependency::MaxGlobalBufferCount> m_global_resources;
 
-		std::vector<Ref<RendergraphPass>> m_passes;
-		std::unordered_map<std::string, ui32> m_passes_name_locator;
+		std::pmr::vector<Ref<RendergraphPass>> m_passes;
+		RendergraphPassLocator m_passes_name_locator;
 	};
 }
\ No newline at end of file
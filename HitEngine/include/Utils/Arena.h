@@ -2,13 +2,32 @@
 
 #include "Core/Memory.h"
 
+#include <type_traits>
+#include <vector>
+#include <new>
+
 namespace hit
 {
+    // growth policy shared by the arenas, 1.5x the current capacity or the required one when it's bigger
+    constexpr ui64 arena_grow_capacity(ui64 capacity, ui64 required_capacity)
+    {
+        const ui64 grown_capacity = capacity + capacity / 2;
+        return grown_capacity > required_capacity ? grown_capacity : required_capacity;
+    }
+
+    // types which can be moved to another address with a plain memcpy. it can be specialized
+    // for types which own memory but never point to themselves
+    template<typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> { };
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
     class Arena
     {
     public:
         Arena() = default;
-        Arena(ui64 size, MemoryUsage usage = MemoryUsage::Any);
+        Arena(ui64 size, MemoryUsage usage = MemoryUsage::Any, const Memory::AllocationOptions& options = { });
         Arena(const Arena& other);
         Arena(Arena&& other) noexcept;
 
@@ -17,24 +36,107 @@ namespace hit
         Arena& operator=(const Arena& other);
         Arena& operator=(Arena&& other) noexcept;
 
-        bool create(ui64 size, MemoryUsage usage = MemoryUsage::Any);
+        bool create(ui64 size, MemoryUsage usage = MemoryUsage::Any, const Memory::AllocationOptions& options = { });
+
+        // reserves address space up front and commits it while pushing, so the memory never moves.
+        // pushing more than reserve_size is an error
+        bool create_virtual(ui64 reserve_size, MemoryUsage usage = MemoryUsage::Any, bool decommit_on_reset = false);
 		void destroy();
 
+        // null when the arena can't grow, past its reserve or its usage hard limit
 		ui8* push_memory(ui64 size);
+		ui8* push_memory(ui64 size, ui64 alignment);
 		void pop_memory(ui64 size);
-		void increment_memory(ui64 size);
+		bool increment_memory(ui64 size);
 
         void reset();
         void copy_to(Arena* other) const;
 
+        // a marker is the arena position, rewinding to it releases everything pushed after it
+        inline ui64 get_marker() const { return m_used; }
+        void rewind(ui64 marker);
+
         inline ui64 size() const { return m_used; }
-        inline ui64 capacity() const { return m_usage.size; }
+        inline ui64 capacity() const { return m_reserved ? m_reserved : m_usage.size; }
+        inline ui64 committed() const { return m_usage.size; }
         inline const ui8* memory() const { return m_usage.memory; }
 
+        inline bool is_virtual() const { return m_reserved > 0; }
+
         inline MemoryUsage usage() const { return m_usage.usage; }
+        inline const Memory::AllocationOptions& options() const { return m_options; }
+
+    private:
+        bool commit_memory(ui64 size);
 
     private:
         Memory::Usage m_usage;
+        Memory::AllocationOptions m_options;
         ui64 m_used = 0;
+
+        // virtual arenas only
+        ui64 m_reserved = 0;
+        bool m_decommit_on_reset = false;
+    };
+
+    // rewinds an arena to where it was when the scope was created, scopes must end in reverse order
+    template<typename ArenaType>
+    class ArenaScope
+    {
+    public:
+        ArenaScope(ArenaType& arena) : m_arena(arena), m_marker(arena.get_marker()) { }
+        ArenaScope(const ArenaScope& other) = delete;
+
+        ~ArenaScope() { m_arena.rewind(m_marker); }
+
+        ArenaScope& operator=(const ArenaScope& other) = delete;
+
+        inline ArenaType& arena() { return m_arena; }
+
+    private:
+        ArenaType& m_arena;
+        ui64 m_marker;
     };
+
+    // thread local virtual arena for temporary work, it must be used inside an ArenaScope
+    Arena& get_scratch_arena();
+
+    // releases the calling thread scratch arena, it's created again on its next use
+    void release_scratch_arena();
+
+    // stl allocator adapter, memory is given back only when the arena is rewound.
+    // without an arena it allocates from the memory system, running out of either throws std::bad_alloc
+    template<typename T>
+    struct ArenaStlAllocator
+    {
+        using value_type = T;
+
+        Arena* arena = nullptr;
+
+        ArenaStlAllocator(Arena* arena = nullptr) noexcept : arena(arena) { }
+
+        template<typename U>
+        ArenaStlAllocator(const ArenaStlAllocator<U>& other) noexcept : arena(other.arena) { }
+
+        inline T* allocate(ui64 count)
+        {
+            auto memory = arena ? (T*)arena->push_memory(count * sizeof(T), alignof(T))
+                                : (T*)Memory::allocate_memory(count * sizeof(T), MemoryUsage::Any, { false, alignof(T) });
+
+            if(!memory) throw std::bad_alloc();
+
+            return memory;
+        }
+
+        inline void deallocate(T* memory, ui64) noexcept
+        {
+            if(!arena) Memory::deallocate_memory((ui8*)memory);
+        }
+
+        template<typename U>
+        inline bool operator==(const ArenaStlAllocator<U>& other) const noexcept { return arena == other.arena; }
+    };
+
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaStlAllocator<T>>;
 }
\ No newline at end of file
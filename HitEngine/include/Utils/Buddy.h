@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Freelist.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace hit
+{
+	// binary buddy allocator of offsets, like FreelistCore it only hands out ranges.
+	// blocks are powers of two of the minimum block size, aligned to their own size.
+	// the blocks form a complete binary tree stored in one flat array, each node keeps the
+	// order of the biggest free block below it (plus one, 0 when full), so push_size descends
+	// once to a fitting block and pop_size merges buddies back on the way up, both O(log n).
+	// a size which isn't a power of two is rounded up, the part past it is kept allocated
+	class BuddyAllocator
+	{
+	public:
+		// min_block_size must be a power of two
+		BuddyAllocator(ui64 initial_size = sizeof(ui64), ui64 min_block_size = 16);
+
+		// alignment must be a power of two
+		bool push_size(ui64 size, ui64& out_offset, ui64 alignment = 1);
+		bool pop_size(ui64 size, ui64 offset);
+
+		// the allocations must be aligned to their block size, see get_block_size
+		bool rebuild(std::span<const SubAllocation> allocations);
+
+		bool resize(ui64 new_size);
+		void clear();
+
+		// whole blocks are counted, so the rounding of sizes isn't free space
+		inline ui64 get_free_space() { return get_usable_size() - m_used; }
+
+		inline ui64 get_largest_free_block() { return !m_tree.empty() && m_tree[0] ? get_order_size(m_tree[0] - 1) : 0; }
+
+		inline ui64 get_block_size(ui64 size, ui64 alignment = 1) { return get_order_size(get_order(std::max(size, alignment))); }
+
+	private:
+		ui32 get_order(ui64 size);
+		inline ui64 get_order_size(ui32 order) { return m_min_block_size << order; }
+
+		// the size rounded down to whole minimum blocks
+		inline ui64 get_usable_size() { return m_size & ~(m_min_block_size - 1); }
+
+		void update_node(ui64 node, ui32 order);
+		void update_parents(ui64 node, ui32 order);
+
+		// marks every block within [begin, end) used or free, for the part past the usable size
+		void mark_range(ui64 node, ui64 node_offset, ui32 order, ui64 begin, ui64 end, bool used);
+
+	private:
+		std::vector<ui8> m_tree;
+
+		ui64 m_min_block_size;
+		ui32 m_min_block_log2;
+
+		// order of the root, the capacity is the minimum block size shifted by it
+		ui32 m_root_order;
+
+		ui64 m_size;
+		ui64 m_used;
+	};
+}
\ No newline at end of file
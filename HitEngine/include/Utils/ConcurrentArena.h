@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Core/Memory.h"
+
+#include <atomic>
+
+namespace hit
+{
+    // ConcurrentArena is an Arena many threads can push to at the same time. a push is one atomic add on the
+    // current block, when it fills a new block is chained with a compare exchange, previous memory never moves.
+    // small pushes are carved from a thread local sub-block, so threads don't touch the shared offset most of the time
+    class ConcurrentArena
+    {
+    public:
+        ConcurrentArena() = default;
+        ConcurrentArena(ui64 block_size, MemoryUsage usage = MemoryUsage::Any, ui64 thread_cache_size = default_thread_cache_size);
+        ConcurrentArena(const ConcurrentArena& other) = delete;
+
+        ~ConcurrentArena();
+
+        ConcurrentArena& operator=(const ConcurrentArena& other) = delete;
+
+        // thread_cache_size is the sub-block taken by each thread, 0 makes every push go to the shared block
+        bool create(ui64 block_size, MemoryUsage usage = MemoryUsage::Any, ui64 thread_cache_size = default_thread_cache_size);
+        void destroy();
+
+        // thread safe
+        ui8* push_memory(ui64 size, ui64 alignment = Memory::default_alignment);
+
+        // like Arena::reset, all memory is given back at once. it must not run while other threads push.
+        // chained blocks are merged in one, so the next use fits without chaining
+        void reset();
+
+        // not exact while threads are pushing
+        ui64 size() const;
+        ui64 capacity() const;
+        ui32 block_count() const;
+
+        static constexpr ui64 default_thread_cache_size = 16 * 1024;
+
+    private:
+        struct alignas(16) Block
+        {
+            std::atomic<ui64> used;
+            ui64 capacity;
+            Block* next;
+
+            inline ui8* memory() { return (ui8*)(this + 1); }
+        };
+
+        Block* allocate_block(ui64 capacity);
+        void deallocate_blocks(Block* block);
+
+        ui8* push_shared_memory(ui64 size, ui64 alignment);
+
+    private:
+        std::atomic<Block*> m_current = nullptr;
+        MemoryUsage m_usage = MemoryUsage::Any;
+        ui64 m_block_size = 0;
+        ui64 m_thread_cache_size = 0;
+
+        // unique for each arena and reset, thread caches of an older epoch are stale
+        ui64 m_epoch = 0;
+    };
+}
\ No newline at end of file
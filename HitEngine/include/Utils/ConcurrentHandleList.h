@@ -0,0 +1,353 @@
+#pragma once
+
+#include "Core/Assert.h"
+#include "Core/Memory.h"
+#include "HandleList.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
+namespace hit
+{
+    // ConcurrentHandleList is a HandleList many threads can add to, remove from and read at the same time.
+    // resources live in their slot, slots are allocated in chunks which never move.
+    // free slots are a lock-free stack, its head carries a tag bumped by every pop so a slot popped and pushed
+    // back between a load and a compare exchange doesn't match anymore (ABA).
+    // a slot version is odd while its resource is alive and even once it's removed, get() is a single acquire load.
+    // removing only bumps the version, the resource is destroyed by collect() at a safe point, so a reader which got
+    // a pointer before the removal keeps reading valid data until then
+    template<typename T>
+    class ConcurrentHandleList
+    {
+    public:
+        ConcurrentHandleList() = default;
+        ConcurrentHandleList(ui64 chunk_size, MemoryUsage usage = MemoryUsage::Any);
+        ConcurrentHandleList(const ConcurrentHandleList& other) = delete;
+
+        ~ConcurrentHandleList();
+
+        ConcurrentHandleList& operator=(const ConcurrentHandleList& other) = delete;
+
+        // chunk_size is rounded up to a power of two, the list holds at most max_chunk_count chunks.
+        // the list registers itself as a handle pool, see resolve_handle
+        bool create(ui64 chunk_size, MemoryUsage usage = MemoryUsage::Any);
+        void destroy();
+
+        // thread safe, an invalid handle is returned when the list is full
+        template<typename... Args>
+        Handle<T> emplace(Args&&... args);
+        Handle<T> add(const T& t);
+
+        // thread safe, the resource can't be got anymore but it's destroyed by the next collect()
+        bool remove(const Handle<T>& handle);
+
+        // wait-free
+        inline T* get(const Handle<T>& handle) const;
+
+        // destroys removed resources and gives their slots back. it must not run while a thread still
+        // uses a pointer to a removed resource, usually it's called once a frame
+        void collect();
+
+        // not exact while threads are adding or removing
+        inline ui64 size() const;
+        inline ui64 slot_count() const;
+
+        static constexpr ui32 max_chunk_count = 4096;
+        static constexpr ui64 default_chunk_size = 1024;
+
+    private:
+        struct Slot
+        {
+            std::atomic<ui32> version;
+            std::atomic<ui32> next_free;
+            std::atomic<ui32> next_removed;
+
+            alignas(T) ui8 resource[sizeof(T)];
+        };
+
+        static constexpr ui32 invalid_slot = UINT32_MAX;
+
+        static constexpr ui64 pack_head(ui32 slot_index, ui32 tag) { return ((ui64)tag << 32) | slot_index; }
+        static constexpr ui32 head_slot(ui64 head) { return (ui32)head; }
+        static constexpr ui32 head_tag(ui64 head) { return (ui32)(head >> 32); }
+
+        inline Slot* get_slot(ui32 slot_index) const;
+
+        ui32 pop_free_slot();
+        void push_free_slot(ui32 slot_index);
+        ui32 allocate_slot();
+
+        static void* resolve(void* list, ui64 handle);
+
+    private:
+        std::atomic<Slot*>* m_chunks = nullptr;
+        MemoryUsage m_usage = MemoryUsage::Any;
+        ui64 m_chunk_shift = 0;
+        ui64 m_chunk_mask = 0;
+
+        std::atomic<ui64> m_free_head = pack_head(invalid_slot, 0);
+        std::atomic<ui32> m_removed_head = invalid_slot;
+        std::atomic<ui32> m_slot_count = 0;
+        std::atomic<ui64> m_size = 0;
+
+        ui32 m_pool = 0;
+    };
+
+    template<typename T>
+    ConcurrentHandleList<T>::ConcurrentHandleList(ui64 chunk_size, MemoryUsage usage)
+    {
+        bool creation_result = create(chunk_size, usage);
+        hit_assert(creation_result, "Failed to create ConcurrentHandleList!");
+    }
+
+    template<typename T>
+    ConcurrentHandleList<T>::~ConcurrentHandleList()
+    {
+        destroy();
+    }
+
+    template<typename T>
+    bool ConcurrentHandleList<T>::create(ui64 chunk_size, MemoryUsage usage)
+    {
+        if(!chunk_size)
+        {
+            hit_warning("Attempting to create a ConcurrentHandleList with no chunk size!");
+            return false;
+        }
+
+        if(m_chunks)
+        {
+            hit_warning("ConcurrentHandleList is already created!");
+            return true;
+        }
+
+        // the chunk table never grows, so readers don't need to synchronize with it
+        m_chunks = (std::atomic<Slot*>*)Memory::allocate_memory(max_chunk_count * sizeof(std::atomic<Slot*>), MemoryUsage::Handle_List);
+        if(!m_chunks)
+        {
+            hit_error("Failed to allocate ConcurrentHandleList chunk table!");
+            return false;
+        }
+
+        for(ui32 i = 0; i < max_chunk_count; i++) new (&m_chunks[i]) std::atomic<Slot*>(nullptr);
+
+        m_usage = usage;
+        m_chunk_shift = std::countr_zero(std::bit_ceil(chunk_size));
+        m_chunk_mask = (1ull << m_chunk_shift) - 1;
+
+        m_free_head.store(pack_head(invalid_slot, 0), std::memory_order_relaxed);
+        m_removed_head.store(invalid_slot, std::memory_order_relaxed);
+        m_slot_count.store(0, std::memory_order_relaxed);
+        m_size.store(0, std::memory_order_relaxed);
+
+        m_pool = register_handle_pool(this, &resolve, get_handle_type_id<T>());
+
+        return true;
+    }
+
+    template<typename T>
+    void ConcurrentHandleList<T>::destroy()
+    {
+        if(!m_chunks) return;
+
+        collect();
+
+        const ui64 count = slot_count();
+        for(ui64 i = 0; i < count; i++)
+        {
+            Slot* slot = get_slot((ui32)i);
+            if(slot && slot->version.load(std::memory_order_relaxed) & 1) ((T*)slot->resource)->~T();
+        }
+
+        for(ui32 i = 0; i < max_chunk_count; i++)
+        {
+            if(Slot* chunk = m_chunks[i].load(std::memory_order_relaxed)) Memory::deallocate_memory((ui8*)chunk);
+        }
+
+        Memory::deallocate_memory((ui8*)m_chunks);
+
+        unregister_handle_pool(m_pool);
+        m_pool = 0;
+
+        m_chunks = nullptr;
+        m_chunk_shift = 0;
+        m_chunk_mask = 0;
+        m_slot_count.store(0, std::memory_order_relaxed);
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    template<typename... Args>
+    Handle<T> ConcurrentHandleList<T>::emplace(Args&&... args)
+    {
+        hit_assert(m_chunks, "Attempting to add to a not created ConcurrentHandleList!");
+
+        ui32 slot_index = pop_free_slot();
+        if(slot_index == invalid_slot) slot_index = allocate_slot();
+
+        if(slot_index == invalid_slot)
+        {
+            hit_error("ConcurrentHandleList is full!");
+            return { };
+        }
+
+        Slot* slot = get_slot(slot_index);
+        new (slot->resource) T(std::forward<Args>(args)...);
+
+        // the slot is owned by this thread until the version is published, invalid_handle_version is kept for invalid handles
+        ui32 version = slot->version.load(std::memory_order_relaxed) + 1;
+        if(version == invalid_handle_version) version = 1;
+
+        slot->version.store(version, std::memory_order_release);
+        m_size.fetch_add(1, std::memory_order_relaxed);
+
+        return { slot_index, version, m_pool };
+    }
+
+    template<typename T>
+    Handle<T> ConcurrentHandleList<T>::add(const T& t)
+    {
+        return emplace(t);
+    }
+
+    template<typename T>
+    bool ConcurrentHandleList<T>::remove(const Handle<T>& handle)
+    {
+        Slot* slot = get_slot(handle.index());
+        if(!slot || !(handle.version() & 1) || handle.pool() != m_pool) return false;
+
+        // only one thread moves the version from alive to removed, stale and repeated handles fail here
+        ui32 version = handle.version();
+        if(!slot->version.compare_exchange_strong(version, handle.version() + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) return false;
+
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+
+        // removed slots are only pushed, collect() takes them all at once, so this stack has no ABA
+        ui32 removed_head = m_removed_head.load(std::memory_order_relaxed);
+        do
+        {
+            slot->next_removed.store(removed_head, std::memory_order_relaxed);
+        }
+        while(!m_removed_head.compare_exchange_weak(removed_head, handle.index(), std::memory_order_release, std::memory_order_relaxed));
+
+        return true;
+    }
+
+    template<typename T>
+    inline T* ConcurrentHandleList<T>::get(const Handle<T>& handle) const
+    {
+        Slot* slot = get_slot(handle.index());
+        if(!slot || slot->version.load(std::memory_order_acquire) != handle.version() || !(handle.version() & 1) || handle.pool() != m_pool) return nullptr;
+
+        return (T*)slot->resource;
+    }
+
+    template<typename T>
+    void ConcurrentHandleList<T>::collect()
+    {
+        ui32 slot_index = m_removed_head.exchange(invalid_slot, std::memory_order_acquire);
+
+        while(slot_index != invalid_slot)
+        {
+            Slot* slot = get_slot(slot_index);
+            const ui32 next_index = slot->next_removed.load(std::memory_order_relaxed);
+
+            ((T*)slot->resource)->~T();
+            push_free_slot(slot_index);
+
+            slot_index = next_index;
+        }
+    }
+
+    template<typename T>
+    inline ui64 ConcurrentHandleList<T>::size() const
+    {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    inline ui64 ConcurrentHandleList<T>::slot_count() const
+    {
+        return std::min((ui64)m_slot_count.load(std::memory_order_relaxed), (ui64)max_chunk_count << m_chunk_shift);
+    }
+
+    template<typename T>
+    inline typename ConcurrentHandleList<T>::Slot* ConcurrentHandleList<T>::get_slot(ui32 slot_index) const
+    {
+        const ui64 chunk_index = slot_index >> m_chunk_shift;
+        if(chunk_index >= max_chunk_count) return nullptr;
+
+        Slot* chunk = m_chunks[chunk_index].load(std::memory_order_acquire);
+        return chunk ? chunk + (slot_index & m_chunk_mask) : nullptr;
+    }
+
+    template<typename T>
+    void* ConcurrentHandleList<T>::resolve(void* list, ui64 handle)
+    {
+        return ((ConcurrentHandleList<T>*)list)->get(Handle<T>::from_value(handle));
+    }
+
+    template<typename T>
+    ui32 ConcurrentHandleList<T>::pop_free_slot()
+    {
+        ui64 head = m_free_head.load(std::memory_order_acquire);
+
+        while(head_slot(head) != invalid_slot)
+        {
+            // the slot may be popped by another thread meanwhile, then the tag doesn't match and next_free is read again
+            const ui32 next_index = get_slot(head_slot(head))->next_free.load(std::memory_order_relaxed);
+
+            if(m_free_head.compare_exchange_weak(head, pack_head(next_index, head_tag(head) + 1), std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return head_slot(head);
+            }
+        }
+
+        return invalid_slot;
+    }
+
+    template<typename T>
+    void ConcurrentHandleList<T>::push_free_slot(ui32 slot_index)
+    {
+        Slot* slot = get_slot(slot_index);
+        ui64 head = m_free_head.load(std::memory_order_relaxed);
+
+        do
+        {
+            slot->next_free.store(head_slot(head), std::memory_order_relaxed);
+        }
+        while(!m_free_head.compare_exchange_weak(head, pack_head(slot_index, head_tag(head)), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    template<typename T>
+    ui32 ConcurrentHandleList<T>::allocate_slot()
+    {
+        const ui32 slot_index = m_slot_count.fetch_add(1, std::memory_order_relaxed);
+
+        const ui64 chunk_index = slot_index >> m_chunk_shift;
+        if(chunk_index >= max_chunk_count || slot_index == invalid_slot) return invalid_slot;
+
+        if(m_chunks[chunk_index].load(std::memory_order_acquire)) return slot_index;
+
+        // the first slot of a chunk may not be the first one to get there, whoever publishes the chunk first wins
+        const ui64 chunk_size = m_chunk_mask + 1;
+        auto chunk = (Slot*)Memory::allocate_memory(chunk_size * sizeof(Slot), m_usage, { false, alignof(Slot) });
+        hit_assert(chunk, "Failed to allocate ConcurrentHandleList chunk!");
+
+        for(ui64 i = 0; i < chunk_size; i++)
+        {
+            new (&chunk[i].version) std::atomic<ui32>(0);
+            new (&chunk[i].next_free) std::atomic<ui32>(invalid_slot);
+            new (&chunk[i].next_removed) std::atomic<ui32>(invalid_slot);
+        }
+
+        Slot* expected = nullptr;
+        if(!m_chunks[chunk_index].compare_exchange_strong(expected, chunk, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            Memory::deallocate_memory((ui8*)chunk);
+        }
+
+        return slot_index;
+    }
+}
\ No newline at end of file
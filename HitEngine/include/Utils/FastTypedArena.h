@@ -7,13 +7,16 @@
 
 namespace hit
 {
-    // FastTypedArena is a TypedArena which does not initialize its elements
+    // FastTypedArena is a TypedArena which does not initialize its elements. they are never
+    // destroyed either, so it only holds trivially copyable types, which are copied and grown with memcpy/realloc
     template <typename T>
     class FastTypedArena
     {
+        static_assert(std::is_trivially_copyable_v<T>, "FastTypedArena holds only trivially copyable types, use TypedArena instead!");
+
     public:
         FastTypedArena() = default;
-        FastTypedArena(ui64 size, MemoryUsage usage = MemoryUsage::Any);
+        FastTypedArena(ui64 size, MemoryUsage usage = MemoryUsage::Any, const Memory::AllocationOptions& options = default_options());
         FastTypedArena(const FastTypedArena& other);
         FastTypedArena(FastTypedArena&& other) noexcept;
 
@@ -22,10 +25,14 @@ namespace hit
         FastTypedArena& operator=(const FastTypedArena& other);
         FastTypedArena& operator=(FastTypedArena&& other) noexcept;
 
-        bool create(ui64 size, MemoryUsage usage = MemoryUsage::Any);
+        bool create(ui64 size, MemoryUsage usage = MemoryUsage::Any, const Memory::AllocationOptions& options = default_options());
+
+        // reserves room for max_size elements, memory is committed while pushing and elements never move
+        bool create_virtual(ui64 max_size, MemoryUsage usage = MemoryUsage::Any, bool decommit_on_reset = false);
         void destroy();
 
-        void reserve_space(ui64 size);
+        // false when the memory can't grow, like a usage over its hard limit
+        bool reserve_space(ui64 size);
 
         template<typename... Args>
         T* emplace_back(Args&&... args);
@@ -42,6 +49,10 @@ namespace hit
         void clear();
         inline bool empty() const;
 
+        // a marker is the element count, rewinding to it pops every element pushed after it
+        inline ui64 get_marker() const;
+        void rewind(ui64 marker);
+
         inline T* get(ui64 index);
         inline const T* get(ui64 index) const;
 
@@ -53,6 +64,12 @@ namespace hit
         inline ui64 size() const;
         inline ui64 capacity() const;
 
+        // the elements are not initialized, neither is the memory
+        static constexpr Memory::AllocationOptions default_options() { return { false, alignof(T) }; }
+
+    private:
+        bool grow(ui64 required_capacity);
+
     private:
         Arena m_arena;
         ui64 m_capacity = 0;
@@ -60,9 +77,9 @@ namespace hit
     };
 
     template <typename T>
-    FastTypedArena<T>::FastTypedArena(ui64 size, MemoryUsage usage)
+    FastTypedArena<T>::FastTypedArena(ui64 size, MemoryUsage usage, const Memory::AllocationOptions& options)
     {
-        bool creation_result = create(size, usage);
+        bool creation_result = create(size, usage, options);
         hit_assert(creation_result, "Failed to create FastTypedArena!");
     }
 
@@ -112,9 +129,9 @@ namespace hit
     }
 
     template <typename T>
-    bool FastTypedArena<T>::create(ui64 size, MemoryUsage usage)
+    bool FastTypedArena<T>::create(ui64 size, MemoryUsage usage, const Memory::AllocationOptions& options)
     {
-        if(!m_arena.create(size * sizeof(T), usage))
+        if(!m_arena.create(size * sizeof(T), usage, options))
         {
             hit_error("Failed to allocate TypedArena memory!");
             return false;
@@ -126,6 +143,21 @@ namespace hit
         return true;
     }
 
+    template <typename T>
+    bool FastTypedArena<T>::create_virtual(ui64 max_size, MemoryUsage usage, bool decommit_on_reset)
+    {
+        if(!m_arena.create_virtual(max_size * sizeof(T), usage, decommit_on_reset))
+        {
+            hit_error("Failed to reserve FastTypedArena memory!");
+            return false;
+        }
+
+        m_capacity = max_size;
+        m_size = 0;
+
+        return true;
+    }
+
     template <typename T>
     void FastTypedArena<T>::destroy()
     {
@@ -135,7 +167,7 @@ namespace hit
     }
 
     template <typename T>
-    void FastTypedArena<T>::reserve_space(ui64 size)
+    bool FastTypedArena<T>::reserve_space(ui64 size)
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
@@ -144,10 +176,17 @@ namespace hit
         if(new_total_size > m_arena.capacity())
         {
             const ui64 increment_size = size * sizeof(T);
-            m_arena.increment_memory(increment_size);
+            if(!m_arena.increment_memory(increment_size)) return false;
         }
 
         m_capacity += size;
+        return true;
+    }
+
+    template <typename T>
+    bool FastTypedArena<T>::grow(ui64 required_capacity)
+    {
+        return reserve_space(arena_grow_capacity(m_capacity, required_capacity) - m_capacity);
     }
 
     template <typename T>
@@ -156,15 +195,13 @@ namespace hit
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + 1 > m_capacity)
-        {
-            // increments capacity by 1 + 25% of current capacity
-            reserve_space(1 + (ui64)(m_capacity / 4));
-        }
+        if(m_size + 1 > m_capacity && !grow(m_size + 1)) return nullptr;
 
         // allocate and initialize element
         auto out_value = (T*)m_arena.push_memory(sizeof(T));
-        *out_value = T(std::forward<Args>(args)...);
+        if(!out_value) return nullptr;
+
+        new (out_value) T(std::forward<Args>(args)...);
 
         // increment size
         m_size++;
@@ -177,14 +214,11 @@ namespace hit
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + 1 > m_capacity)
-        {
-            // increments capacity by 1 + 25% of current capacity
-            reserve_space(1 + (ui64)(m_capacity / 4));
-        }
+        if(m_size + 1 > m_capacity && !grow(m_size + 1)) return nullptr;
 
         // allocate and initialize element
         auto out_value = (T*)m_arena.push_memory(sizeof(T));
+        if(!out_value) return nullptr;
 
         // increment size
         m_size++;
@@ -197,14 +231,12 @@ namespace hit
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + 1 > m_capacity)
-        {
-            // increments capacity by 1 + 25% of current capacity
-            reserve_space(1 + (ui64)(m_capacity / 4));
-        }
+        if(m_size + 1 > m_capacity && !grow(m_size + 1)) return nullptr;
 
         // allocate and copy element
         auto out_value = (T*)m_arena.push_memory(sizeof(T));
+        if(!out_value) return nullptr;
+
         Memory::copy_memory((ui8*)out_value, (ui8*)&t, sizeof(T));
 
         // increment size
@@ -218,14 +250,11 @@ namespace hit
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + 1 > m_capacity)
-        {
-            // increments capacity by 1 + 25% of current capacity
-            reserve_space(1 + (ui64)(m_capacity / 4));
-        }
+        if(m_size + 1 > m_capacity && !grow(m_size + 1)) return nullptr;
 
         // allocate and initialize element
         auto out_value = (T*)m_arena.push_memory(sizeof(T));
+        if(!out_value) return nullptr;
 
         Memory::copy_memory((ui8*)out_value, (ui8*)&t, sizeof(T));
         Memory::set_memory((ui8*)&t, 0, sizeof(T));
@@ -242,14 +271,11 @@ namespace hit
         hit_assert(count > 0, "Attempting to push an array in a TypedArena with 0 elements!");
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + count > m_capacity)
-        {
-            // increments capacity by cout + 25% of current capacity
-            reserve_space(count + (ui64)(m_capacity / 4));
-        }
+        if(m_size + count > m_capacity && !grow(m_size + count)) return nullptr;
 
         // allocate elements
         auto out_array = (T*)m_arena.push_memory(count * sizeof(T));
+        if(!out_array) return nullptr;
 
         // increment size
         m_size += count;
@@ -280,9 +306,24 @@ namespace hit
     template <typename T>
     void FastTypedArena<T>::clear()
     {
+        m_arena.reset();
         m_size = 0;
     }
 
+    template <typename T>
+    inline ui64 FastTypedArena<T>::get_marker() const
+    {
+        return m_size;
+    }
+
+    template <typename T>
+    void FastTypedArena<T>::rewind(ui64 marker)
+    {
+        hit_assert(marker <= m_size, "Attempting to rewind FastTypedArena to {} elements, but it has just {}!", marker, m_size);
+
+        if(marker < m_size) pop_array_back(m_size - marker);
+    }
+
     template <typename T>
     inline bool FastTypedArena<T>::empty() const
     {
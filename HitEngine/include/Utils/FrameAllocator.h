@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Core/Memory.h"
+#include "Arena.h"
+
+#include <vector>
+#include <algorithm>
+#include <new>
+
+namespace hit
+{
+    // FrameAllocator has one linear arena per frame in flight, the current one is reset at the beginning of its frame.
+    // memory is valid until the same arena is used again, frame_count frames later, it's never released individually
+    class FrameAllocator
+    {
+    public:
+        FrameAllocator() = default;
+        FrameAllocator(ui32 frame_count, ui64 frame_size, MemoryUsage usage = MemoryUsage::Any);
+        FrameAllocator(const FrameAllocator& other) = delete;
+
+        ~FrameAllocator();
+
+        FrameAllocator& operator=(const FrameAllocator& other) = delete;
+
+        // frame_size is reserved per frame and committed on demand
+        bool create(ui32 frame_count, ui64 frame_size, MemoryUsage usage = MemoryUsage::Any);
+        void destroy();
+
+        void begin_frame();
+
+        ui8* allocate(ui64 size, ui64 alignment = Memory::default_alignment);
+
+        // nothing can be constructed in a used up frame reserve, so they throw std::bad_alloc like FrameStlAllocator
+        template<typename T, typename... Args>
+        T* allocate_object(Args&&... args);
+
+        template<typename T>
+        T* allocate_array(ui64 count);
+
+        inline ui64 frame_used() const { return m_frames.empty() ? 0 : m_frames[m_frame_index].size(); }
+        inline ui64 high_water_mark() const { return std::max(m_high_water_mark, frame_used()); }
+
+        inline ui32 frame_count() const { return (ui32)m_frames.size(); }
+        inline ui64 frame_number() const { return m_frame_number; }
+
+    private:
+        std::vector<Arena> m_frames;
+        ui32 m_frame_index = 0;
+        ui64 m_frame_number = 0;
+        ui64 m_high_water_mark = 0;
+    };
+
+    template<typename T, typename... Args>
+    T* FrameAllocator::allocate_object(Args&&... args)
+    {
+        auto memory = (T*)allocate(sizeof(T), alignof(T));
+        if(!memory) throw std::bad_alloc();
+
+        new (memory) T(std::forward<Args>(args)...);
+        return memory;
+    }
+
+    template<typename T>
+    T* FrameAllocator::allocate_array(ui64 count)
+    {
+        auto memory = (T*)allocate(count * sizeof(T), alignof(T));
+        if(!memory) throw std::bad_alloc();
+
+        for(ui64 i = 0; i < count; i++) new (&memory[i]) T();
+        return memory;
+    }
+
+    // stl allocator adapter, deallocations are ignored, memory goes away with its frame.
+    // containers can't handle a null allocation, so a used up frame reserve throws std::bad_alloc
+    template<typename T>
+    struct FrameStlAllocator
+    {
+        using value_type = T;
+
+        FrameAllocator* frame_allocator = nullptr;
+
+        FrameStlAllocator(FrameAllocator* allocator) noexcept : frame_allocator(allocator) { }
+
+        template<typename U>
+        FrameStlAllocator(const FrameStlAllocator<U>& other) noexcept : frame_allocator(other.frame_allocator) { }
+
+        inline T* allocate(ui64 count)
+        {
+            auto memory = (T*)frame_allocator->allocate(count * sizeof(T), alignof(T));
+            if(!memory) throw std::bad_alloc();
+
+            return memory;
+        }
+
+        inline void deallocate(T*, ui64) noexcept { }
+
+        template<typename U>
+        inline bool operator==(const FrameStlAllocator<U>& other) const noexcept { return frame_allocator == other.frame_allocator; }
+    };
+
+    template<typename T>
+    using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+}
\ No newline at end of file
@@ -2,22 +2,62 @@
 
 #include "Core/Types.h"
 #include <map>
+#include <span>
+#include <vector>
 
 namespace hit
 {
+	// a range handed out by a sub-allocator
+	struct SubAllocation
+	{
+		ui64 offset;
+		ui64 size;
+		ui64 alignment = 1;
+	};
+
+	// the regions of a plan don't overlap each other, so they can be copied by a single command
+	struct SubAllocationCopy
+	{
+		ui64 src_offset;
+		ui64 dst_offset;
+		ui64 size;
+	};
+
+	struct DefragmentationPlan
+	{
+		// the compacted allocations, in the order they were given
+		std::vector<SubAllocation> allocations;
+
+		// allocations next to each other before and after compaction are copied in one region
+		std::vector<SubAllocationCopy> copies;
+
+		// end of the last compacted allocation
+		ui64 used_size = 0;
+	};
+
+	// packs the live allocations from offset 0 in their offset order, keeping their alignment.
+	// a compacted allocation may overlap its old place, so the copies go to another buffer
+	DefragmentationPlan plan_defragmentation(std::span<const SubAllocation> allocations);
+
 	class FreelistCore
 	{
 	public:
 		FreelistCore(ui64 initial_size = sizeof(ui64));
 
-		bool push_size(ui64 size, ui64& out_offset);
+		// alignment must be a power of two
+		bool push_size(ui64 size, ui64& out_offset, ui64 alignment = 1);
 		bool pop_size(ui64 size, ui64 offset);
 
+		// the given allocations are the only used memory afterwards, like after a defragmentation
+		bool rebuild(std::span<const SubAllocation> allocations);
+
 		bool resize(ui64 new_size);
 		void clear();
 
 		inline ui64 get_free_space() { return m_size - m_used; }
 
+		ui64 get_largest_free_block();
+
 	private:
 		std::map<ui64, ui64> m_memory_dist;
 		ui64 m_size;
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Core/Types.h"
+
+#include <compare>
+#include <functional>
+
+namespace hit
+{
+    // a handle is packed in 64 bits, from the highest: pool id, slot index and version.
+    // sorting handles groups them by pool, then by slot, so they can be used as radix keys
+    constexpr ui32 handle_version_bits = 24;
+    constexpr ui32 handle_index_bits = 32;
+    constexpr ui32 handle_pool_bits = 8;
+
+    constexpr ui32 handle_version_shift = 0;
+    constexpr ui32 handle_index_shift = handle_version_bits;
+    constexpr ui32 handle_pool_shift = handle_version_bits + handle_index_bits;
+
+    // all ones are kept for invalid handles, slot versions wrap before reaching invalid_handle_version
+    constexpr ui32 invalid_handle_version = (1u << handle_version_bits) - 1;
+    constexpr ui32 invalid_handle_index = UINT32_MAX;
+    constexpr ui32 invalid_handle_pool = (1u << handle_pool_bits) - 1;
+    constexpr ui64 invalid_handle_value = UINT64_MAX;
+
+    // pool 0 is for handles of lists which aren't registered
+    constexpr ui32 max_handle_pool_count = invalid_handle_pool;
+
+    constexpr ui64 pack_handle(ui32 index, ui32 version, ui32 pool)
+    {
+        return ((ui64)pool << handle_pool_shift) | ((ui64)index << handle_index_shift) | ((ui64)(version & invalid_handle_version) << handle_version_shift);
+    }
+
+    constexpr ui32 unpack_handle_index(ui64 value) { return (ui32)(value >> handle_index_shift); }
+    constexpr ui32 unpack_handle_version(ui64 value) { return (ui32)(value >> handle_version_shift) & invalid_handle_version; }
+    constexpr ui32 unpack_handle_pool(ui64 value) { return (ui32)(value >> handle_pool_shift); }
+
+    template<typename T>
+    struct Handle
+    {
+        inline constexpr Handle() : value(invalid_handle_value) { }
+        inline constexpr Handle(ui32 index, ui32 version, ui32 pool = 0) : value(pack_handle(index, version, pool)) { }
+
+        // handles are cast between types, the packed value is kept as it is.
+        // explicit, so a handle never changes type without spelling it out
+        template <typename U>
+        inline constexpr explicit Handle(const Handle<U>& other) : value(other.value) { }
+
+        static inline constexpr Handle<T> from_value(ui64 value) { Handle<T> handle; handle.value = value; return handle; }
+
+        inline constexpr ui32 index() const { return unpack_handle_index(value); }
+        inline constexpr ui32 version() const { return unpack_handle_version(value); }
+        inline constexpr ui32 pool() const { return unpack_handle_pool(value); }
+
+        inline constexpr bool valid() const { return index() != invalid_handle_index && version() != invalid_handle_version; }
+
+        inline constexpr bool compare_to(const Handle<T>& other) const { return value == other.value; }
+
+        inline constexpr bool operator==(const Handle<T>& other) const { return compare_to(other); }
+        inline constexpr auto operator<=>(const Handle<T>& other) const { return value <=> other.value; }
+
+        using type = T;
+
+        ui64 value;
+    };
+
+    // lists register themselves as handle pools, so a handle can be resolved without knowing its list.
+    // a resolver gets the resource of a packed handle from its pool
+    using HandleResolver = void* (*)(void* pool, ui64 handle);
+
+    // unique address for each handle type, resolving checks the handle type against the pool one
+    template<typename T>
+    inline const void* get_handle_type_id()
+    {
+        static const ui8 id = 0;
+        return &id;
+    }
+
+    // returns 0 when every pool id is taken, the list handles still work but can't be resolved
+    ui32 register_handle_pool(void* pool, HandleResolver resolver, const void* type_id);
+
+    // a moved list keeps its pool id
+    void update_handle_pool(ui32 pool_id, void* pool);
+    void unregister_handle_pool(ui32 pool_id);
+
+    // O(1), nullptr for unregistered pools
+    void* get_handle_pool(ui32 pool_id);
+    void* resolve_handle(ui64 handle, const void* type_id);
+
+    template<typename T>
+    inline T* resolve_handle(const Handle<T>& handle)
+    {
+        return (T*)resolve_handle(handle.value, get_handle_type_id<T>());
+    }
+}
+
+template<typename T>
+struct std::hash<hit::Handle<T>>
+{
+    // packed values are mostly zero bits, they are mixed like splitmix64 does
+    inline size_t operator()(const hit::Handle<T>& handle) const noexcept
+    {
+        hit::ui64 value = handle.value;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return (size_t)(value ^ (value >> 31));
+    }
+};
\ No newline at end of file
@@ -1,370 +1,397 @@
 #pragma once
 
 #include "Core/Types.h"
+#include "Handle.h"
 #include "TypedArena.h"
 #include "FastTypedArena.h"
+#include "SegmentedArena.h"
 
 namespace hit
 {
-    template<typename T>
-    struct Handle
-    {
-        inline constexpr Handle(ui32 index = UINT32_MAX, ui32 verison = UINT32_MAX);
-
-        template <typename U>
-        inline constexpr Handle(const Handle<U>& other);
-
-        inline bool valid() const;
-        inline bool compare_to(const Handle<T>& other) const;
-
-        inline bool operator==(const Handle<T>& other) const;
-        inline bool operator!=(const Handle<T>& other) const;
-
-        using type = T;
-
-        ui32 index;
-        ui32 version;
-    };
-
-    template<typename T>
+    // resources are packed in Storage.
+    // it's a sparse set: a handle indexes a slot, the slot knows where its resource is in the dense Storage
+    // and every dense resource knows its slot back, so add, remove and get are O(1).
+    // removing moves the last resource in the hole, with a SegmentedArena get() pointers stay valid while adding
+    template<typename T, typename Storage = TypedArena<T>>
     class HandleList
     {
     public:
+        // the list registers itself as a handle pool, see resolve_handle
         inline constexpr HandleList(ui64 initial_capacity = 32, MemoryUsage usage = MemoryUsage::Any);
-        HandleList(HandleList<T>&& other) noexcept;
+        HandleList(HandleList<T, Storage>&& other) noexcept;
 
         ~HandleList();
 
-        HandleList<T>& operator=(HandleList<T>&& other) noexcept;
+        HandleList<T, Storage>& operator=(HandleList<T, Storage>&& other) noexcept;
 
+        // an invalid handle when the storages can't grow, like a usage over its hard limit
         template<typename... Args>
         Handle<T> emplace(Args&&... args);
         Handle<T> add(const T& t);
 
+        // handles are pushed to arena, the scratch one by default, so the call must be inside an ArenaScope.
+        // init is a value every resource is constructed from, or a function of the resource number.
+        // the span is shorter than count when the storages can't grow
+        template<typename Init>
+        std::span<Handle<T>> emplace_n(ui64 count, const Init& init, Arena& arena = get_scratch_arena());
+
         void remove(const Handle<T>& handle);
+
+        // the dense storage is compacted once instead of filling every hole, invalid and repeated handles are skipped
+        void remove_many(std::span<const Handle<T>> handles);
+
+        // room for count resources, adding up to it doesn't grow the storages
+        void reserve(ui64 count);
         
         inline T* get(const Handle<T>& handle);
 
         void reset();
 
         inline ui64 size();
+
+        // contiguous storages only, a SegmentedArena is iterated through resources() chunks
         inline std::span<T> data();
+        inline const Storage& resources() const;
 
-    private:
-        struct Slot
+        struct Entry
         {
-            ui32 resource_index;
-			ui32 version;
-
-			i32 next;
-			i32 back;
+            Handle<T> handle;
+            T& value;
         };
 
-        void link_slots(Slot* a, Slot* b);
-        void remove_slot(Slot* slot);
-        void replace_slot(Slot* old_slot, Slot* new_slot);
+        // iterates the dense storage in order, every resource comes with its handle
+        class Iterator
+        {
+        public:
+            inline Iterator(HandleList<T, Storage>* list, ui64 index) : m_list(list), m_index(index) { }
 
-    private:
-        TypedArena<T> m_resources;
-        FastTypedArena<Slot> m_slots;
+            inline Entry operator*() const
+            {
+                const ui32 slot_index = *m_list->m_dense_slots[m_index];
+                return { { slot_index, m_list->m_slots[slot_index]->version, m_list->m_pool }, *(T*)m_list->m_resources[m_index] };
+            }
 
-        i32 m_free_slot_count;
-		i32 m_free_slot_start;
-		i32 m_last_slot;
-		i32 m_penultimate_slot;
-    };
+            inline Iterator& operator++() { m_index++; return *this; }
 
-    template<typename T>
-    inline constexpr Handle<T>::Handle(ui32 index, ui32 verison) : index(index), version(version) { }
+            inline bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+            inline bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
 
-    template<typename T>
-    template<typename U>
-    inline constexpr Handle<T>::Handle(const Handle<U>& other) : index(other.index), version(other.version)
-    { }
+        private:
+            HandleList<T, Storage>* m_list;
+            ui64 m_index;
+        };
 
-    template<typename T>
-    inline bool Handle<T>::valid() const
-    {
-        return index != UINT32_MAX && version != UINT32_MAX;
-    }
+        inline Iterator begin();
+        inline Iterator end();
 
-    template<typename T>
-    inline bool Handle<T>::compare_to(const Handle<T>& other) const
-    {
-        return index == other.valid && version == other.index;
-    }
+    private:
+        // invalid_slot when the slots can't grow
+        inline ui32 acquire_slot();
+        inline void release_slot(ui32 slot_index);
 
-    template<typename T>
-    inline bool Handle<T>::operator==(const Handle<T>& other) const
-    {
-        return compare_to(other);
-    }
+        static void* resolve(void* list, ui64 handle);
 
-    template<typename T>
-    inline bool Handle<T>::operator!=(const Handle<T>& other) const
-    {
-        return !compare_to(other);
-    }
+    private:
+        // a free slot links the next free one with its dense_index
+        struct Slot
+        {
+            ui32 dense_index;
+            ui32 version;
+        };
+
+        static constexpr ui32 invalid_slot = UINT32_MAX;
+
+    private:
+        Storage m_resources;
+        FastTypedArena<ui32> m_dense_slots;
+        FastTypedArena<Slot> m_slots;
+
+        ui32 m_free_slot_start;
+        ui32 m_pool;
+    };
 
-    template<typename T>
-    inline constexpr HandleList<T>::HandleList(ui64 initial_capacity, MemoryUsage usage)
+    template<typename T, typename Storage>
+    inline constexpr HandleList<T, Storage>::HandleList(ui64 initial_capacity, MemoryUsage usage)
         : m_resources(initial_capacity, usage),
+        m_dense_slots(initial_capacity, MemoryUsage::Handle_List),
         m_slots(initial_capacity, MemoryUsage::Handle_List),
-        m_free_slot_count(0),
-		m_free_slot_start(-1),
-		m_last_slot(-1),
-		m_penultimate_slot(-1) { }
+        m_free_slot_start(invalid_slot),
+        m_pool(register_handle_pool(this, &resolve, get_handle_type_id<T>())) { }
 
-    template<typename T>
-    HandleList<T>::HandleList(HandleList<T>&& other) noexcept
+    template<typename T, typename Storage>
+    HandleList<T, Storage>::HandleList(HandleList<T, Storage>&& other) noexcept
         : m_resources(std::move(other.m_resources)), 
+        m_dense_slots(std::move(other.m_dense_slots)),
         m_slots(std::move(other.m_slots)),
-        m_free_slot_count(other.m_free_slot_count),
         m_free_slot_start(other.m_free_slot_start),
-        m_last_slot(other.m_last_slot),
-        m_penultimate_slot(other.m_penultimate_slot)
+        m_pool(other.m_pool)
     {
-        other.m_free_slot_count = 0;
-		other.m_free_slot_start = -1;
-		other.m_last_slot = -1;
-		other.m_penultimate_slot = -1;
+        other.m_free_slot_start = invalid_slot;
+        other.m_pool = 0;
 
-		return *this;
+        update_handle_pool(m_pool, this);
     }
 
-    template<typename T>
-    HandleList<T>::~HandleList()
+    template<typename T, typename Storage>
+    HandleList<T, Storage>::~HandleList()
     {
         reset();
+        unregister_handle_pool(m_pool);
     }
 
-    template<typename T>
-    HandleList<T>& HandleList<T>::operator=(HandleList<T>&& other) noexcept
+    template<typename T, typename Storage>
+    HandleList<T, Storage>& HandleList<T, Storage>::operator=(HandleList<T, Storage>&& other) noexcept
     {
         reset();
 
-        m_resources == std::move(other.m_resources);
-		m_slots == std::move(other.m_slots);
+        m_resources = std::move(other.m_resources);
+        m_dense_slots = std::move(other.m_dense_slots);
+        m_slots = std::move(other.m_slots);
+        m_free_slot_start = other.m_free_slot_start;
 
-		m_free_slot_count = other.m_free_slot_count;
-		m_free_slot_start = other.m_free_slot_start;
-		m_last_slot = other.m_last_slot;
-		m_penultimate_slot = other.m_penultimate_slot;
+        other.m_free_slot_start = invalid_slot;
 
-		other.m_free_slot_count = 0;
-		other.m_free_slot_start = -1;
-		other.m_last_slot = -1;
-		other.m_penultimate_slot = -1;
+        // the handles of other keep resolving to this list
+        unregister_handle_pool(m_pool);
+        m_pool = other.m_pool;
+        other.m_pool = 0;
 
-		return *this;
+        update_handle_pool(m_pool, this);
+
+        return *this;
     }
 
-    template<typename T>
+    template<typename T, typename Storage>
     template<typename... Args>
-    Handle<T> HandleList<T>::emplace(Args&&... args)
+    Handle<T> HandleList<T, Storage>::emplace(Args&&... args)
     {
-        Slot* slot;
-
-		if(m_free_slot_count > 0)
-		{
-			m_free_slot_count--;
-			slot = (Slot*)m_slots[m_free_slot_start];
-			m_free_slot_start = slot->next;
-		}
-		else
-		{
-			slot = (Slot*)m_slots.push_back();
-			slot->version = 0;
-		}
+        const ui32 slot_index = acquire_slot();
+        if(slot_index == invalid_slot) return Handle<T>();
 
-		slot->next = -1;
-		slot->back = -1;
+        // the resource is constructed last, so a failed push rolls back without destroying it
+        if(!m_dense_slots.push_back(slot_index))
+        {
+            release_slot(slot_index);
+            return Handle<T>();
+        }
 
-		auto resource = m_resources.emplace_back(std::forward<Args>(args)...);
-		slot->resource_index = m_resources.size() - 1;
+        if(!m_resources.emplace_back(std::forward<Args>(args)...))
+        {
+            m_dense_slots.pop_back();
+            release_slot(slot_index);
+            return Handle<T>();
+        }
 
-		Slot* back = nullptr;
+        return { slot_index, m_slots[slot_index]->version, m_pool };
+    }
 
-		if(m_last_slot != m_penultimate_slot)
-		{
-			m_penultimate_slot = m_last_slot;
-			slot->back = m_penultimate_slot;
-			back = (Slot*)m_slots[m_penultimate_slot];
-		}
+    template<typename T, typename Storage>
+    template<typename Init>
+    std::span<Handle<T>> HandleList<T, Storage>::emplace_n(ui64 count, const Init& init, Arena& arena)
+    {
+        auto handles = (Handle<T>*)arena.push_memory(count * sizeof(Handle<T>), alignof(Handle<T>));
+        if(!handles) return { };
 
-		m_last_slot = (i32)((i32)((ui8*)slot - (ui8*)m_slots.data().data()) / sizeof(Slot));
+        reserve(m_resources.size() + count);
 
-		if(back) back->next = m_last_slot;
+        for(ui64 i = 0; i < count; i++)
+        {
+            if constexpr (std::is_invocable_v<const Init&, ui64>) handles[i] = emplace(init(i));
+            else handles[i] = emplace(init);
 
-		Handle<T> handle;
-		handle.index = m_last_slot;
-		handle.version = slot->version;
+            if(!handles[i].valid()) return { handles, i };
+        }
 
-		return handle;
+        return { handles, count };
     }
 
-    template<typename T>
-    Handle<T> HandleList<T>::add(const T& t)
+    template<typename T, typename Storage>
+    Handle<T> HandleList<T, Storage>::add(const T& t)
     {
         return emplace(t);
     }
 
-    template<typename T>
-    void HandleList<T>::remove(const Handle<T>& handle)
+    template<typename T, typename Storage>
+    void HandleList<T, Storage>::remove(const Handle<T>& handle)
     {
-        if(m_last_slot == -1) return;
+        T* resource = get(handle);
+        if(!resource) return;
+
+        Slot* slot = m_slots[handle.index()];
+        const ui32 last_index = (ui32)m_resources.size() - 1;
+
+        // the last resource fills the hole, so the dense storage stays packed
+        if(slot->dense_index != last_index)
+        {
+            // the removed resource is alive, so the last one is move assigned to it
+            *resource = std::move(*(T*)m_resources[last_index]);
 
-		auto resource = get(handle);
+            const ui32 last_slot_index = *m_dense_slots[last_index];
+            *m_dense_slots[slot->dense_index] = last_slot_index;
+            m_slots[last_slot_index]->dense_index = slot->dense_index;
+        }
 
-		if(!resource) return;
+        m_resources.pop_back();
+        m_dense_slots.pop_back();
 
-		Slot* last_slot = (Slot*)m_slots[m_last_slot];
-		Slot* removed_slot = (Slot*)m_slots[handle.index];
+        // old handles of the slot don't match anymore, invalid_handle_version is kept for invalid handles
+        if(++slot->version == invalid_handle_version) slot->version = 0;
 
-		removed_slot->version++;
+        slot->dense_index = m_free_slot_start;
+        m_free_slot_start = handle.index();
+    }
 
-		if(last_slot == removed_slot)
-		{
-			m_resources.pop_back();
-		}
-		else
-		{
-			T* last_resource = (T*)m_resources[last_slot->resource_index];
+    template<typename T, typename Storage>
+    void HandleList<T, Storage>::remove_many(std::span<const Handle<T>> handles)
+    {
+        // a few handles are cheaper to remove one by one than to walk the whole dense storage
+        if(handles.size() < m_resources.size() / 8)
+        {
+            for(const auto& handle : handles) remove(handle);
+            return;
+        }
 
-			resource->~T();
+        // removed resources are marked in the dense slots, bumping the version right away skips repeated handles
+        for(const auto& handle : handles)
+        {
+            if(!get(handle)) continue;
 
-			*resource = std::move(*last_resource);
+            Slot* slot = m_slots[handle.index()];
+            *m_dense_slots[slot->dense_index] = invalid_slot;
 
-			m_resources.pop_back();
+            if(++slot->version == invalid_handle_version) slot->version = 0;
 
-			last_slot->resource_index = removed_slot->resource_index;
-		}
+            slot->dense_index = m_free_slot_start;
+            m_free_slot_start = handle.index();
+        }
 
-		if(handle.index == m_penultimate_slot)
-		{
-			m_penultimate_slot = removed_slot->back;
-			last_slot->back = m_penultimate_slot;
-		}
-		else
-		{
-			m_last_slot = last_slot->back;
+        // the remaining resources are packed to the front in one pass and keep their order
+        const ui32 size = (ui32)m_resources.size();
+        ui32 packed_size = 0;
 
-			replace_slot(removed_slot, last_slot);
+        for(ui32 i = 0; i < size; i++)
+        {
+            const ui32 slot_index = *m_dense_slots[i];
+            if(slot_index == invalid_slot) continue;
 
-			if(m_last_slot >= 0)
-			{
-				last_slot = (Slot*)m_slots[m_last_slot];
+            if(i != packed_size)
+            {
+                *(T*)m_resources[packed_size] = std::move(*(T*)m_resources[i]);
+                *m_dense_slots[packed_size] = slot_index;
+                m_slots[slot_index]->dense_index = packed_size;
+            }
 
-				m_penultimate_slot = last_slot->back;
-			}
-		}
+            packed_size++;
+        }
 
-		removed_slot->next = m_free_slot_start;
-		removed_slot->back = -1;
+        if(packed_size == size) return;
 
-		m_free_slot_start = handle.index;
-		m_free_slot_count++;
+        m_resources.pop_array_back(size - packed_size);
+        m_dense_slots.pop_array_back(size - packed_size);
     }
-        
-    template<typename T>
-    inline T* HandleList<T>::get(const Handle<T>& handle)
-    {
-        if(handle.index >= m_slots.size()) return nullptr;
 
-		const Slot* slot = m_slots[handle.index];
+    template<typename T, typename Storage>
+    void HandleList<T, Storage>::reserve(ui64 count)
+    {
+        // a SegmentedArena reserves a total size, the typed arenas reserve on top of their capacity
+        if constexpr (requires(Storage& storage, ui64 size) { storage.reserve(size); }) m_resources.reserve(count);
+        else if(m_resources.capacity() < count) m_resources.reserve_space(count - m_resources.capacity());
 
-		T* resource = nullptr;
+        if(m_dense_slots.capacity() < count) m_dense_slots.reserve_space(count - m_dense_slots.capacity());
+        if(m_slots.capacity() < count) m_slots.reserve_space(count - m_slots.capacity());
+    }
+        
+    template<typename T, typename Storage>
+    inline T* HandleList<T, Storage>::get(const Handle<T>& handle)
+    {
+        if(handle.index() >= m_slots.size() || handle.pool() != m_pool) return nullptr;
 
-		if(handle.version == slot->version)
-			resource = (T*)m_resources[slot->resource_index];
+        const Slot* slot = m_slots[handle.index()];
+        if(handle.version() != slot->version) return nullptr;
 
-		return resource;
+        return (T*)m_resources[slot->dense_index];
     }
 
-    template<typename T>
-    void HandleList<T>::reset()
+    template<typename T, typename Storage>
+    void HandleList<T, Storage>::reset()
     {
         m_resources.clear();
-        m_slots.clear();
+        m_dense_slots.clear();
+
+        // the slots are kept with a new version, so handles from before the reset don't resolve to the next resources
+        m_free_slot_start = invalid_slot;
 
-        m_free_slot_count = 0;
-		m_free_slot_start = -1;
-		m_last_slot = -1;
-		m_penultimate_slot = -1;
+        for(ui32 i = (ui32)m_slots.size(); i-- > 0;)
+        {
+            Slot* slot = m_slots[i];
+            if(++slot->version == invalid_handle_version) slot->version = 0;
+
+            slot->dense_index = m_free_slot_start;
+            m_free_slot_start = i;
+        }
     }
 
-    template<typename T>
-    inline ui64 HandleList<T>::size()
+    template<typename T, typename Storage>
+    inline ui64 HandleList<T, Storage>::size()
     {
         return m_resources.size();
     }
 
-    template<typename T>
-    inline std::span<T> HandleList<T>::data()
+    template<typename T, typename Storage>
+    inline std::span<T> HandleList<T, Storage>::data()
     {
         return m_resources.data();
     }
 
-    template<typename T>
-    void HandleList<T>::link_slots(Slot* a, Slot* b)
+    template<typename T, typename Storage>
+    inline const Storage& HandleList<T, Storage>::resources() const
     {
-        a->next = (i32)((i32)((ui8*)b - (ui8*)m_slots.data().data()) / sizeof(Slot));
-		b->back = (i32)((i32)((ui8*)a - (ui8*)m_slots.data().data()) / sizeof(Slot));
+        return m_resources;
     }
 
-    template<typename T>
-    void HandleList<T>::remove_slot(Slot* slot)
+    template<typename T, typename Storage>
+    inline typename HandleList<T, Storage>::Iterator HandleList<T, Storage>::begin()
     {
-        Slot* next = nullptr;
-		Slot* back = nullptr;
-
-		if(slot->next != -1)
-			next = (Slot*)m_slots[slot->next];
-
-		if(slot->back != -1)
-			back = (Slot*)m_slots[slot->back];
-
-		if(next && back)
-		{
-			link_slots(back, next);
-		}
-		else
-		{
-			if(next) next->back = -1;
-
-			if(back) back->next = -1;
-		}
-
-		slot->next = -1;
-		slot->back = -1;
+        return { this, 0 };
     }
 
-    template<typename T>
-    void HandleList<T>::replace_slot(Slot* old_slot, Slot* new_slot)
+    template<typename T, typename Storage>
+    inline typename HandleList<T, Storage>::Iterator HandleList<T, Storage>::end()
     {
-        remove_slot(new_slot);
-
-		if(old_slot == new_slot) return;
-
-		Slot* next = nullptr;
-		Slot* back = nullptr;
+        return { this, m_resources.size() };
+    }
 
-		new_slot->next = old_slot->next;
-		new_slot->back = old_slot->back;
+    template<typename T, typename Storage>
+    void* HandleList<T, Storage>::resolve(void* list, ui64 handle)
+    {
+        return ((HandleList<T, Storage>*)list)->get(Handle<T>::from_value(handle));
+    }
 
-		if(old_slot->next != -1)
-			next = (Slot*)m_slots[old_slot->next];
+    template<typename T, typename Storage>
+    inline ui32 HandleList<T, Storage>::acquire_slot()
+    {
+        ui32 slot_index = m_free_slot_start;
 
-		if(old_slot->back != -1)
-			back = (Slot*)m_slots[old_slot->back];
+        if(slot_index != invalid_slot)
+        {
+            m_free_slot_start = m_slots[slot_index]->dense_index;
+        }
+        else
+        {
+            slot_index = (ui32)m_slots.size();
+            if(!m_slots.push_back({ 0, 0 })) return invalid_slot;
+        }
 
-		if(next)
-			link_slots(new_slot, next);
+        m_slots[slot_index]->dense_index = (ui32)m_resources.size();
 
-		if(back)
-			link_slots(back, new_slot);
+        return slot_index;
+    }
 
-		old_slot->back = -1;
-		old_slot->next = -1;
+    template<typename T, typename Storage>
+    inline void HandleList<T, Storage>::release_slot(ui32 slot_index)
+    {
+        // no handle of the slot was given out, so its version is kept
+        m_slots[slot_index]->dense_index = m_free_slot_start;
+        m_free_slot_start = slot_index;
     }
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Core/Memory.h"
+#include "Arena.h"
+
+#include <memory_resource>
+
+namespace hit
+{
+    // monotonic resource over an Arena, deallocations are ignored and the memory is given back when
+    // the arena is rewound or reset. the arena must be virtual, a heap arena moves its memory when it grows
+    class ArenaMemoryResource : public std::pmr::memory_resource
+    {
+    public:
+        ArenaMemoryResource(Arena& arena);
+
+        inline Arena& arena() { return m_arena; }
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override { }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    private:
+        Arena& m_arena;
+    };
+
+    // allocates from the memory system, so every byte shows up in the usage statistics
+    class UsageMemoryResource : public std::pmr::memory_resource
+    {
+    public:
+        UsageMemoryResource(MemoryUsage usage = MemoryUsage::Any) : m_usage(usage) { }
+
+        inline MemoryUsage usage() const { return m_usage; }
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* memory, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        MemoryUsage m_usage;
+    };
+
+    // shared resource of a usage, it lives for the whole program
+    UsageMemoryResource* get_usage_memory_resource(MemoryUsage usage);
+
+    // pools small blocks by size, pool chunks and bigger blocks come from the memory system accounted to usage.
+    // it's not thread safe, everything is released when it's destroyed
+    class PoolMemoryResource : public std::pmr::unsynchronized_pool_resource
+    {
+    public:
+        PoolMemoryResource(MemoryUsage usage = MemoryUsage::Any, ui64 largest_pooled_size = 1024);
+    };
+}
\ No newline at end of file
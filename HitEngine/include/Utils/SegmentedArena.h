@@ -0,0 +1,401 @@
+#pragma once
+
+#include "Core/Assert.h"
+#include "Core/Types.h"
+#include "FastTypedArena.h"
+
+#include <algorithm>
+#include <bit>
+#include <span>
+
+namespace hit
+{
+    // SegmentedArena is a TypedArena made of fixed size chunks, growing allocates a new chunk,
+    // so elements never move and pointers stay valid until they are popped.
+    // chunk size is a power of two, an index is turned into its chunk and offset with a shift and a mask
+    template<typename T>
+    class SegmentedArena
+    {
+    public:
+        SegmentedArena() = default;
+        SegmentedArena(ui64 chunk_size, MemoryUsage usage = MemoryUsage::Any, bool recycle_chunks = true);
+        SegmentedArena(const SegmentedArena& other);
+        SegmentedArena(SegmentedArena&& other) noexcept;
+
+        ~SegmentedArena();
+
+        SegmentedArena& operator=(const SegmentedArena& other);
+        SegmentedArena& operator=(SegmentedArena&& other) noexcept;
+
+        // chunk_size is rounded up to a power of two. when recycle_chunks is set, clear keeps the chunks for reuse
+        bool create(ui64 chunk_size, MemoryUsage usage = MemoryUsage::Any, bool recycle_chunks = true);
+        void destroy();
+
+        // allocates chunks ahead until size elements fit
+        void reserve(ui64 size);
+
+        template<typename... Args>
+        T* emplace_back(Args&&... args);
+
+        T* push_back(const T& t = T());
+        T* push_back(T&& t);
+
+        void pop_back();
+        void pop_array_back(ui64 count);
+
+        void clear();
+        inline bool empty() const;
+
+        // a marker is the element count, rewinding to it pops every element pushed after it
+        inline ui64 get_marker() const;
+        void rewind(ui64 marker);
+
+        inline T* get(ui64 index);
+        inline const T* get(ui64 index) const;
+
+        inline T* operator[](ui64 index);
+        inline const T* operator[](ui64 index) const;
+
+        // elements of a chunk are contiguous, chunks are iterated from 0 to chunk_count
+        inline std::span<T> chunk(ui64 chunk_index) const;
+        inline ui64 chunk_count() const;
+        inline ui64 chunk_size() const;
+
+        inline ui64 size() const;
+        inline ui64 capacity() const;
+
+    private:
+        inline T* get_unchecked(ui64 index) const;
+        T* push_memory();
+        void copy_from(const SegmentedArena& other);
+        void release_chunks();
+
+    private:
+        FastTypedArena<T*> m_chunks;
+        MemoryUsage m_usage = MemoryUsage::Any;
+        ui64 m_chunk_shift = 0;
+        ui64 m_chunk_mask = 0;
+        ui64 m_size = 0;
+        bool m_recycle_chunks = true;
+    };
+
+    template<typename T>
+    SegmentedArena<T>::SegmentedArena(ui64 chunk_size, MemoryUsage usage, bool recycle_chunks)
+    {
+        bool creation_result = create(chunk_size, usage, recycle_chunks);
+        hit_assert(creation_result, "Failed to create SegmentedArena!");
+    }
+
+    template<typename T>
+    SegmentedArena<T>::SegmentedArena(const SegmentedArena<T>& other)
+    {
+        copy_from(other);
+    }
+
+    template<typename T>
+    SegmentedArena<T>::SegmentedArena(SegmentedArena<T>&& other) noexcept
+        : m_chunks(std::move(other.m_chunks)), m_usage(other.m_usage), m_chunk_shift(other.m_chunk_shift),
+        m_chunk_mask(other.m_chunk_mask), m_size(other.m_size), m_recycle_chunks(other.m_recycle_chunks)
+    {
+        other.m_chunk_shift = 0;
+        other.m_chunk_mask = 0;
+        other.m_size = 0;
+    }
+
+    template<typename T>
+    SegmentedArena<T>::~SegmentedArena()
+    {
+        destroy();
+    }
+
+    template<typename T>
+    SegmentedArena<T>& SegmentedArena<T>::operator=(const SegmentedArena<T>& other)
+    {
+        if(this == &other) return *this;
+
+        destroy();
+        copy_from(other);
+
+        return *this;
+    }
+
+    template<typename T>
+    SegmentedArena<T>& SegmentedArena<T>::operator=(SegmentedArena<T>&& other) noexcept
+    {
+        destroy();
+
+        m_chunks = std::move(other.m_chunks);
+        m_usage = other.m_usage;
+        m_chunk_shift = other.m_chunk_shift;
+        m_chunk_mask = other.m_chunk_mask;
+        m_size = other.m_size;
+        m_recycle_chunks = other.m_recycle_chunks;
+
+        other.m_chunk_shift = 0;
+        other.m_chunk_mask = 0;
+        other.m_size = 0;
+
+        return *this;
+    }
+
+    template<typename T>
+    bool SegmentedArena<T>::create(ui64 chunk_size, MemoryUsage usage, bool recycle_chunks)
+    {
+        if(!chunk_size)
+        {
+            hit_warning("Attempting to create a SegmentedArena with no chunk size!");
+            return false;
+        }
+
+        if(m_chunks.capacity())
+        {
+            hit_warning("SegmentedArena is already created!");
+            return true;
+        }
+
+        // the chunk table is the only thing which is reallocated while growing
+        if(!m_chunks.create(8, usage))
+        {
+            hit_error("Failed to allocate SegmentedArena chunk table!");
+            return false;
+        }
+
+        m_usage = usage;
+        m_chunk_shift = std::countr_zero(std::bit_ceil(chunk_size));
+        m_chunk_mask = (1ull << m_chunk_shift) - 1;
+        m_size = 0;
+        m_recycle_chunks = recycle_chunks;
+
+        return true;
+    }
+
+    template<typename T>
+    void SegmentedArena<T>::destroy()
+    {
+        if(!m_chunks.capacity()) return;
+
+        clear();
+        release_chunks();
+
+        m_chunks.destroy();
+        m_chunk_shift = 0;
+        m_chunk_mask = 0;
+    }
+
+    template<typename T>
+    void SegmentedArena<T>::reserve(ui64 size)
+    {
+        hit_assert(m_chunks.capacity() > 0, "Can't reserve space to a not initialized yet SegmentedArena.");
+
+        const Memory::AllocationOptions options = { false, alignof(T) };
+
+        while(capacity() < size)
+        {
+            auto chunk = (T*)Memory::allocate_memory(chunk_size() * sizeof(T), m_usage, options);
+            hit_assert(chunk, "Failed to allocate SegmentedArena chunk!");
+
+            m_chunks.push_back(chunk);
+        }
+    }
+
+    template<typename T>
+    template<typename... Args>
+    T* SegmentedArena<T>::emplace_back(Args&&... args)
+    {
+        auto out_value = push_memory();
+        new (out_value) T(std::forward<Args>(args)...);
+
+        m_size++;
+
+        return out_value;
+    }
+
+    template<typename T>
+    T* SegmentedArena<T>::push_back(const T& t)
+    {
+        auto out_value = push_memory();
+        new (out_value) T(t);
+
+        m_size++;
+
+        return out_value;
+    }
+
+    template<typename T>
+    T* SegmentedArena<T>::push_back(T&& t)
+    {
+        auto out_value = push_memory();
+        new (out_value) T(std::move(t));
+
+        m_size++;
+
+        return out_value;
+    }
+
+    template<typename T>
+    void SegmentedArena<T>::pop_back()
+    {
+        hit_assert(m_size, "Attempting to pop an element from an empty SegmentedArena.");
+
+        m_size--;
+        get_unchecked(m_size)->~T();
+    }
+
+    template<typename T>
+    void SegmentedArena<T>::pop_array_back(ui64 count)
+    {
+        hit_assert(m_size >= count, "Attempting to pop more elements than exists in SegmentedArena.");
+
+        for(ui64 i = 0; i < count; i++) pop_back();
+    }
+
+    template<typename T>
+    void SegmentedArena<T>::clear()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for(ui64 i = 0; i < chunk_count(); i++)
+            {
+                for(auto& t : chunk(i)) t.~T();
+            }
+        }
+
+        m_size = 0;
+
+        if(!m_recycle_chunks) release_chunks();
+    }
+
+    template<typename T>
+    inline bool SegmentedArena<T>::empty() const
+    {
+        return m_size == 0;
+    }
+
+    template<typename T>
+    inline ui64 SegmentedArena<T>::get_marker() const
+    {
+        return m_size;
+    }
+
+    template<typename T>
+    void SegmentedArena<T>::rewind(ui64 marker)
+    {
+        hit_assert(marker <= m_size, "Attempting to rewind SegmentedArena to {} elements, but it has just {}!", marker, m_size);
+
+        if(marker < m_size) pop_array_back(m_size - marker);
+    }
+
+    template<typename T>
+    inline T* SegmentedArena<T>::get(ui64 index)
+    {
+        hit_assert(index < m_size, "Invalid SegmentedArena index!");
+        return get_unchecked(index);
+    }
+
+    template<typename T>
+    inline const T* SegmentedArena<T>::get(ui64 index) const
+    {
+        hit_assert(index < m_size, "Invalid SegmentedArena index!");
+        return get_unchecked(index);
+    }
+
+    template<typename T>
+    inline T* SegmentedArena<T>::operator[](ui64 index)
+    {
+        hit_assert(index < m_size, "Invalid SegmentedArena index!");
+        return get_unchecked(index);
+    }
+
+    template<typename T>
+    inline const T* SegmentedArena<T>::operator[](ui64 index) const
+    {
+        hit_assert(index < m_size, "Invalid SegmentedArena index!");
+        return get_unchecked(index);
+    }
+
+    template<typename T>
+    inline std::span<T> SegmentedArena<T>::chunk(ui64 chunk_index) const
+    {
+        hit_assert(chunk_index < chunk_count(), "Invalid SegmentedArena chunk index!");
+
+        const ui64 first = chunk_index << m_chunk_shift;
+        return { m_chunks.data()[chunk_index], std::min(chunk_size(), m_size - first) };
+    }
+
+    template<typename T>
+    inline ui64 SegmentedArena<T>::chunk_count() const
+    {
+        return (m_size + m_chunk_mask) >> m_chunk_shift;
+    }
+
+    template<typename T>
+    inline ui64 SegmentedArena<T>::chunk_size() const
+    {
+        return m_chunk_mask + 1;
+    }
+
+    template<typename T>
+    inline ui64 SegmentedArena<T>::size() const
+    {
+        return m_size;
+    }
+
+    template<typename T>
+    inline ui64 SegmentedArena<T>::capacity() const
+    {
+        return m_chunks.size() << m_chunk_shift;
+    }
+
+    template<typename T>
+    inline T* SegmentedArena<T>::get_unchecked(ui64 index) const
+    {
+        return m_chunks.data()[index >> m_chunk_shift] + (index & m_chunk_mask);
+    }
+
+    template<typename T>
+    T* SegmentedArena<T>::push_memory()
+    {
+        hit_assert(m_chunks.capacity() > 0, "Can't push to a not initialized yet SegmentedArena.");
+
+        if(m_size == capacity()) reserve(m_size + 1);
+
+        return get_unchecked(m_size);
+    }
+
+    template<typename T>
+    void SegmentedArena<T>::copy_from(const SegmentedArena<T>& other)
+    {
+        if(!other.m_chunks.capacity()) return;
+
+        bool creation_result = create(other.chunk_size(), other.m_usage, other.m_recycle_chunks);
+        hit_assert(creation_result, "Failed to create SegmentedArena!");
+
+        reserve(other.m_size);
+
+        for(ui64 i = 0; i < other.chunk_count(); i++)
+        {
+            auto other_chunk = other.chunk(i);
+            auto out_chunk = m_chunks.data()[i];
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                Memory::copy_memory((ui8*)out_chunk, (const ui8*)other_chunk.data(), other_chunk.size() * sizeof(T));
+            }
+            else
+            {
+                for(ui64 j = 0; j < other_chunk.size(); j++) new (&out_chunk[j]) T(other_chunk[j]);
+            }
+        }
+
+        m_size = other.m_size;
+    }
+
+    template<typename T>
+    void SegmentedArena<T>::release_chunks()
+    {
+        hit_assert(!m_size, "Attempting to release SegmentedArena chunks still in use!");
+
+        for(auto chunk : m_chunks.data()) Memory::deallocate_memory((ui8*)chunk);
+        m_chunks.clear();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "FastTypedArena.h"
+#include "Freelist.h"
+
+namespace hit
+{
+	// two level segregated fit allocator of offsets, like FreelistCore it only hands out ranges
+	// so its bookkeeping lives outside of the managed memory (GPU buffers).
+	// free blocks are binned by the highest bit of their size (first level) and 16 linear steps
+	// below it (second level), a bitmap of each level finds a fitting bin with two bit scans,
+	// so push_size and pop_size are O(1). freed blocks are merged with their free neighbours right away
+	class TlsfAllocator
+	{
+	public:
+		TlsfAllocator(ui64 initial_size = sizeof(ui64));
+
+		// alignment must be a power of two
+		bool push_size(ui64 size, ui64& out_offset, ui64 alignment = 1);
+		bool pop_size(ui64 size, ui64 offset);
+
+		// the given allocations are the only used memory afterwards, like after a defragmentation
+		bool rebuild(std::span<const SubAllocation> allocations);
+
+		bool resize(ui64 new_size);
+		void clear();
+
+		inline ui64 get_free_space() { return m_size - m_used; }
+
+		// walks the biggest bin, so it's not O(1)
+		ui64 get_largest_free_block();
+
+		static constexpr ui32 second_level_log2 = 4;
+		static constexpr ui32 second_level_count = 1 << second_level_log2;
+		static constexpr ui32 first_level_count = 64 - second_level_log2 + 1;
+
+	private:
+		struct Block
+		{
+			ui64 offset;
+			ui64 size;
+
+			// neighbours in memory, and in the bin list while free
+			ui32 prev_physical;
+			ui32 next_physical;
+			ui32 prev_free;
+			ui32 next_free;
+
+			bool free;
+		};
+
+		// an entry of the used block table, block_index is invalid_block while the entry is empty
+		struct UsedBlock
+		{
+			ui64 offset;
+			ui32 block_index;
+		};
+
+		static constexpr ui32 invalid_block = UINT32_MAX;
+		static constexpr ui64 used_table_initial_size = 64;
+
+		static void mapping(ui64 size, ui32& out_first_level, ui32& out_second_level);
+
+		ui32 find_free_block(ui64 size);
+
+		void insert_free_block(ui32 block_index);
+		void remove_free_block(ui32 block_index);
+
+		ui32 split_block(ui32 block_index, ui64 size);
+		void merge_block(ui32 block_index, ui32 next_index);
+
+		void append_block(ui64 offset, ui64 size, bool free);
+
+		ui32 create_block(ui64 offset, ui64 size);
+		void destroy_block(ui32 block_index);
+
+		// the entry of offset, or the empty one it would go in
+		ui64 find_used_block(ui64 offset);
+
+		// grows the table so count used blocks keep it at most half full, false when it can't grow
+		bool reserve_used_blocks(ui64 count);
+
+		void insert_used_block(ui64 offset, ui32 block_index);
+		void remove_used_block(ui64 entry_index);
+		void clear_used_blocks();
+
+	private:
+		FastTypedArena<Block> m_blocks;
+		ui32 m_unused_block = invalid_block;
+		ui32 m_last_block = invalid_block;
+
+		ui64 m_first_level_bitmap = 0;
+		ui32 m_second_level_bitmaps[first_level_count] = { };
+		ui32 m_free_heads[first_level_count][second_level_count];
+
+		// used blocks by offset, to find the block of pop_size. open addressed with linear probing,
+		// the size is a power of two
+		FastTypedArena<UsedBlock> m_used_blocks;
+		ui64 m_used_block_count = 0;
+
+		ui64 m_size;
+		ui64 m_used;
+	};
+}
\ No newline at end of file
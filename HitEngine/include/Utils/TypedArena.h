@@ -3,16 +3,19 @@
 #include "Core/Assert.h"
 #include "Core/Types.h"
 #include "Arena.h"
+#include <algorithm>
 #include <span>
 
 namespace hit
 {
+    // TypedArena constructs and destroys its elements. trivially relocatable types grow with realloc,
+    // other types are move constructed into a new block
     template<typename T>
     class TypedArena
     {
     public:
         TypedArena() = default;
-        TypedArena(ui64 size, MemoryUsage usage = MemoryUsage::Any);
+        TypedArena(ui64 size, MemoryUsage usage = MemoryUsage::Any, const Memory::AllocationOptions& options = default_options());
         TypedArena(const TypedArena& other);
         TypedArena(TypedArena&& other) noexcept;
 
@@ -21,10 +24,14 @@ namespace hit
         TypedArena& operator=(const TypedArena& other);
         TypedArena& operator=(TypedArena&& other) noexcept;
 
-        bool create(ui64 size, MemoryUsage usage = MemoryUsage::Any);
+        bool create(ui64 size, MemoryUsage usage = MemoryUsage::Any, const Memory::AllocationOptions& options = default_options());
+
+        // reserves room for max_size elements, memory is committed while pushing and elements never move
+        bool create_virtual(ui64 max_size, MemoryUsage usage = MemoryUsage::Any, bool decommit_on_reset = false);
         void destroy();
 
-        void reserve_space(ui64 size);
+        // false when the memory can't grow, like a usage over its hard limit
+        bool reserve_space(ui64 size);
 
         template<typename... Args>
         T* emplace_back(Args&&... args);
@@ -40,6 +47,10 @@ namespace hit
         void clear();
         inline bool empty() const;
 
+        // a marker is the element count, rewinding to it pops every element pushed after it
+        inline ui64 get_marker() const;
+        void rewind(ui64 marker);
+
         inline T* get(ui64 index);
         inline const T* get(ui64 index) const;
 
@@ -51,6 +62,14 @@ namespace hit
         inline ui64 size() const;
         inline ui64 capacity() const;
 
+        // elements are always constructed in place, so the memory doesn't need to be zeroed
+        static constexpr Memory::AllocationOptions default_options() { return { false, alignof(T) }; }
+
+    private:
+        bool grow(ui64 required_capacity);
+        bool relocate(ui64 new_capacity);
+        void copy_from(const TypedArena& other);
+
     private:
         Arena m_arena;
         ui64 m_capacity = 0;
@@ -58,19 +77,16 @@ namespace hit
     };
 
     template<typename T>
-    TypedArena<T>::TypedArena(ui64 size, MemoryUsage usage)
+    TypedArena<T>::TypedArena(ui64 size, MemoryUsage usage, const Memory::AllocationOptions& options)
     {
-        bool creation_result = create(size, usage);
+        bool creation_result = create(size, usage, options);
         hit_assert(creation_result, "Failed to create TypedArena!");
     }
 
     template<typename T>
     TypedArena<T>::TypedArena(const TypedArena<T>& other)
     {
-        bool creation_result = create(other.m_size, other.m_arena.usage());
-        hit_assert(creation_result, "Failed to create TypedArena!");
-
-        for(auto i = 0; i < other.m_size; i++) push_back(*other[i]);
+        copy_from(other);
     }
 
     template<typename T>
@@ -91,11 +107,7 @@ namespace hit
     TypedArena<T>& TypedArena<T>::operator=(const TypedArena<T>& other)
     {
         destroy();
-
-        bool creation_result = create(other.m_size, other.m_arena.usage());
-        hit_assert(creation_result, "Failed to create TypedArena!");
-
-        for(auto i = 0; i < other.m_size; i++) push_back(*other[i]);
+        copy_from(other);
 
         return *this;
     }
@@ -116,9 +128,9 @@ namespace hit
     }
 
     template<typename T>
-    bool TypedArena<T>::create(ui64 size, MemoryUsage usage)
+    bool TypedArena<T>::create(ui64 size, MemoryUsage usage, const Memory::AllocationOptions& options)
     {
-        if(!m_arena.create(size * sizeof(T), usage))
+        if(!m_arena.create(size * sizeof(T), usage, options))
         {
             hit_error("Failed to allocate TypedArena memory!");
             return false;
@@ -130,6 +142,21 @@ namespace hit
         return true;
     }
 
+    template<typename T>
+    bool TypedArena<T>::create_virtual(ui64 max_size, MemoryUsage usage, bool decommit_on_reset)
+    {
+        if(!m_arena.create_virtual(max_size * sizeof(T), usage, decommit_on_reset))
+        {
+            hit_error("Failed to reserve TypedArena memory!");
+            return false;
+        }
+
+        m_capacity = max_size;
+        m_size = 0;
+
+        return true;
+    }
+
     template<typename T>
     void TypedArena<T>::destroy()
     {
@@ -141,19 +168,82 @@ namespace hit
     }
 
     template<typename T>
-    void TypedArena<T>::reserve_space(ui64 size)
+    bool TypedArena<T>::reserve_space(ui64 size)
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        const ui64 new_total_size = (m_capacity + size) * sizeof(T);
+        const ui64 new_capacity = m_capacity + size;
 
-        if(new_total_size > m_arena.capacity())
+        if(new_capacity * sizeof(T) > m_arena.capacity())
         {
-            const ui64 increment_size = size * sizeof(T);
-            m_arena.increment_memory(increment_size);
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                if(!m_arena.increment_memory(new_capacity * sizeof(T) - m_arena.capacity())) return false;
+            }
+            else
+            {
+                if(!relocate(new_capacity)) return false;
+            }
         }
 
-        m_capacity += size;
+        m_capacity = new_capacity;
+        return true;
+    }
+
+    template<typename T>
+    bool TypedArena<T>::grow(ui64 required_capacity)
+    {
+        return reserve_space(arena_grow_capacity(m_capacity, required_capacity) - m_capacity);
+    }
+
+    template<typename T>
+    bool TypedArena<T>::relocate(ui64 new_capacity)
+    {
+        hit_assert(!m_arena.is_virtual(), "Virtual TypedArena can't grow beyond its reserve!");
+
+        // the elements stay where they are when the new block can't be allocated
+        Arena new_arena;
+        if(!new_arena.create(new_capacity * sizeof(T), m_arena.usage(), m_arena.options())) return false;
+
+        auto old_data = data();
+        auto new_data = (T*)new_arena.push_memory(m_size * sizeof(T));
+
+        for(ui64 i = 0; i < m_size; i++)
+        {
+            new (&new_data[i]) T(std::move(old_data[i]));
+            old_data[i].~T();
+        }
+
+        m_arena = std::move(new_arena);
+        return true;
+    }
+
+    template<typename T>
+    void TypedArena<T>::copy_from(const TypedArena<T>& other)
+    {
+        if(!other.m_capacity) return;
+
+        // a virtual arena is copied to a heap one sized to its elements, not to its whole reserve
+        const ui64 capacity = other.m_arena.is_virtual() ? std::max<ui64>(other.m_size, 1) : other.m_capacity;
+
+        bool creation_result = create(capacity, other.m_arena.usage(), other.m_arena.options());
+        hit_assert(creation_result, "Failed to create TypedArena!");
+
+        if(!other.m_size) return;
+
+        auto out_array = (T*)m_arena.push_memory(other.m_size * sizeof(T));
+        auto other_data = other.data();
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            Memory::copy_memory((ui8*)out_array, (const ui8*)other_data.data(), other.m_size * sizeof(T));
+        }
+        else
+        {
+            for(ui64 i = 0; i < other.m_size; i++) new (&out_array[i]) T(other_data[i]);
+        }
+
+        m_size = other.m_size;
     }
 
     template<typename T>
@@ -162,14 +252,12 @@ namespace hit
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + 1 > m_capacity)
-        {
-            // increments capacity by 1 + 25% of current capacity
-            reserve_space(1 + (ui64)(m_capacity / 4));
-        }
+        if(m_size + 1 > m_capacity && !grow(m_size + 1)) return nullptr;
 
         // allocate and initialize element
         auto out_value = (T*)m_arena.push_memory(sizeof(T));
+        if(!out_value) return nullptr;
+
         new (out_value) T(std::forward<Args>(args)...);
 
         // increment size
@@ -183,14 +271,12 @@ namespace hit
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + 1 > m_capacity)
-        {
-            // increments capacity by 1 + 25% of current capacity
-            reserve_space(1 + (ui64)(m_capacity / 4));
-        }
+        if(m_size + 1 > m_capacity && !grow(m_size + 1)) return nullptr;
 
         // allocate and initialize element
         auto out_value = (T*)m_arena.push_memory(sizeof(T));
+        if(!out_value) return nullptr;
+
         new (out_value) T(t);
 
         // increment size
@@ -204,14 +290,12 @@ namespace hit
     {
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + 1 > m_capacity)
-        {
-            // increments capacity by 1 + 25% of current capacity
-            reserve_space(1 + (ui64)(m_capacity / 4));
-        }
+        if(m_size + 1 > m_capacity && !grow(m_size + 1)) return nullptr;
 
         // allocate and initialize element
         auto out_value = (T*)m_arena.push_memory(sizeof(T));
+        if(!out_value) return nullptr;
+
         new (out_value) T(std::move(t));
 
         // increment size
@@ -226,14 +310,12 @@ namespace hit
         hit_assert(count > 0, "Attempting to push an array in a TypedArena with 0 elements!");
         hit_assert(m_capacity > 0, "Can't reserve space to a not initialized yet TypedArena.");
 
-        if(m_size + count > m_capacity)
-        {
-            // increments capacity by cout + 25% of current capacity
-            reserve_space(count + (ui64)(m_capacity / 4));
-        }
+        if(m_size + count > m_capacity && !grow(m_size + count)) return nullptr;
 
         // allocate and initialize elements
         auto out_array = (T*)m_arena.push_memory(count * sizeof(T));
+        if(!out_array) return nullptr;
+
         for(auto i = 0; i < count; i++)
             new (&out_array[i]) T();
 
@@ -280,6 +362,20 @@ namespace hit
         m_size = 0;
     }
 
+    template<typename T>
+    inline ui64 TypedArena<T>::get_marker() const
+    {
+        return m_size;
+    }
+
+    template<typename T>
+    void TypedArena<T>::rewind(ui64 marker)
+    {
+        hit_assert(marker <= m_size, "Attempting to rewind TypedArena to {} elements, but it has just {}!", marker, m_size);
+
+        if(marker < m_size) pop_array_back(m_size - marker);
+    }
+
     template<typename T>
     inline bool TypedArena<T>::empty() const
     {
@@ -14,7 +14,7 @@ namespace hit
 		VulkanBuffer(VulkanBuffer&& other) noexcept;
 		VulkanBuffer& operator=(VulkanBuffer&& other) noexcept;
 
-		bool create(ui64 initial_size, BufferType type, BufferAllocationType allocation) override;
+		bool create(ui64 initial_size, BufferType type, BufferAllocationType allocation = BufferAllocationType::Tlsf) override;
 		void destroy() override;
 
 		bool bind(ui64 offset = 0) override;
@@ -33,6 +33,9 @@ namespace hit
 		bool draw(ui64 offset, ui32 elem_count, bool bind_only) override;
 
 		bool copy(Buffer& other, ui64 size, ui64 dest_offset = 0, ui64 src_offset = 0) override;
+		bool copy(Buffer& other, std::span<const SubAllocationCopy> regions) override;
+
+		bool defragment(std::span<const SubAllocation> allocations, const BufferRemapCallback& remap) override;
 
 		inline const VkBuffer get_buffer() const { return m_buffer; }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Renderer/RendererAPI.h"
+#include "Utils/FrameAllocator.h"
 
 // Vulkan
 #include "VulkanCommon.h"
@@ -29,6 +30,9 @@ namespace hit
 
         inline const VulkanCommand& get_graphics_command() const { return m_graphics_commands[m_current_image_index]; }
 
+        // transient memory of the current frame
+        inline FrameAllocator* get_frame_allocator() const { return m_frame_allocator; }
+
         void set_viewport(i32 x, i32 y, i32 width, i32 height);
         void set_scissor(i32 x, i32 y, i32 width, i32 height);
 
@@ -62,6 +66,8 @@ namespace hit
         ui32 m_current_image_index;
         ui32 m_current_frame;
 
+        FrameAllocator* m_frame_allocator;
+
         // command buffers -> one per image count
         std::vector<VulkanCommand> m_graphics_commands;
 
@@ -14,7 +14,10 @@ namespace hit
         m_allocation_type = other.m_allocation_type;
 
         m_total_size = other.m_total_size;
+        m_min_alignment = other.m_min_alignment;
         m_freelist = std::move(other.m_freelist);
+        m_tlsf = std::move(other.m_tlsf);
+        m_buddy = std::move(other.m_buddy);
 
         m_is_locked = other.m_is_locked;
 
@@ -38,7 +41,10 @@ namespace hit
         m_allocation_type = other.m_allocation_type;
 
         m_total_size = other.m_total_size;
+        m_min_alignment = other.m_min_alignment;
         m_freelist = std::move(other.m_freelist);
+        m_tlsf = std::move(other.m_tlsf);
+        m_buddy = std::move(other.m_buddy);
 
         m_is_locked = other.m_is_locked;
 
@@ -61,9 +67,11 @@ namespace hit
     bool VulkanBuffer::create(ui64 initial_size, BufferType type, BufferAllocationType allocation)
     {
         auto device = m_context->get_device();
+        auto& limits = device->get_device_details().properties.limits;
 
         // handle buffer type
         m_type = type;
+        m_min_alignment = 1;
         switch (m_type)
         {
             case BufferType::Vertex:
@@ -82,8 +90,11 @@ namespace hit
 
             case BufferType::Uniform:
             {
-                m_buffer_flags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                m_buffer_flags = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
                 m_memory_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+                // sub-allocated ranges are bound as dynamic uniform buffers
+                m_min_alignment = limits.minUniformBufferOffsetAlignment;
                 break;
             }
 
@@ -158,6 +169,21 @@ namespace hit
                 m_freelist = create_scope<FreelistCore>(m_total_size);
                 break;
             }
+
+            case BufferAllocationType::Tlsf:
+            {
+                m_tlsf = create_scope<TlsfAllocator>(m_total_size);
+                break;
+            }
+
+            case BufferAllocationType::Buddy:
+            {
+                // the block tree takes a byte per node, blocks smaller than this would make it too big
+                m_buddy = create_scope<BuddyAllocator>(m_total_size, std::max(m_min_alignment, (ui64)256));
+                break;
+            }
+
+            case BufferAllocationType::None: break;
         }
 
         return true;
@@ -185,6 +211,16 @@ namespace hit
         {
             m_freelist = nullptr;
         }
+
+        if (m_tlsf)
+        {
+            m_tlsf = nullptr;
+        }
+
+        if (m_buddy)
+        {
+            m_buddy = nullptr;
+        }
     }
 
     bool VulkanBuffer::bind(ui64 offset)
@@ -217,6 +253,18 @@ namespace hit
             return false;
         }
 
+        if (m_tlsf && !m_tlsf->resize(new_size))
+        {
+            hit_error("Can't resize buffer tlsf allocator.");
+            return false;
+        }
+
+        if (m_buddy && !m_buddy->resize(new_size))
+        {
+            hit_error("Can't resize buffer buddy allocator.");
+            return false;
+        }
+
         auto new_buffer = VulkanBuffer(m_context);
         if (!new_buffer.create(new_size, m_type, BufferAllocationType::None))
         {
@@ -232,8 +280,80 @@ namespace hit
             return false;
         }
 
-        // save current freelist
+        // save current allocators
+        const auto allocation_type = m_allocation_type;
+        auto freelist_backup = std::move(m_freelist);
+        auto tlsf_backup = std::move(m_tlsf);
+        auto buddy_backup = std::move(m_buddy);
+
+        // destroy current buffer
+        m_context->get_device()->wait_idle();
+        destroy();
+
+        // move new buffer to old buffer
+        *this = std::move(new_buffer);
+        m_allocation_type = allocation_type;
+        m_freelist = std::move(freelist_backup);
+        m_tlsf = std::move(tlsf_backup);
+        m_buddy = std::move(buddy_backup);
+
+        return true;
+    }
+
+    bool VulkanBuffer::defragment(std::span<const SubAllocation> allocations, const BufferRemapCallback& remap)
+    {
+        if (!m_freelist && !m_tlsf && !m_buddy)
+        {
+            hit_error("Can't defragment a buffer without an allocation type.");
+            return false;
+        }
+
+        // compacted offsets keep the alignment allocate gave them, like the minimum one of uniform buffers.
+        // whole buddy blocks are moved and stay aligned to their size, so they can be rebuilt from the compacted layout
+        std::vector<SubAllocation> aligned_allocations(allocations.begin(), allocations.end());
+        for (auto& allocation : aligned_allocations)
+        {
+            allocation.alignment = std::max(allocation.alignment, m_min_alignment);
+
+            if (m_buddy)
+            {
+                allocation.size = m_buddy->get_block_size(allocation.size, allocation.alignment);
+                allocation.alignment = allocation.size;
+            }
+        }
+
+        auto plan = plan_defragmentation(aligned_allocations);
+
+        // compacted ranges may overlap their old place, so they are copied to a new buffer
+        auto new_buffer = VulkanBuffer(m_context);
+        if (!new_buffer.create(m_total_size, m_type, BufferAllocationType::None))
+        {
+            hit_error("Can't create defragmented buffer of {} bytes", m_total_size);
+            return false;
+        }
+
+        // copy binds it too, but with nothing to copy it still needs its memory
+        if (!new_buffer.bind())
+        {
+            new_buffer.destroy();
+
+            hit_error("Failed to bind defragmented buffer!");
+            return false;
+        }
+
+        if (!plan.copies.empty() && !new_buffer.copy(*this, plan.copies))
+        {
+            new_buffer.destroy();
+
+            hit_error("Failed to copy old buffer to defragmented buffer!");
+            return false;
+        }
+
+        // save current allocators
+        const auto allocation_type = m_allocation_type;
         auto freelist_backup = std::move(m_freelist);
+        auto tlsf_backup = std::move(m_tlsf);
+        auto buddy_backup = std::move(m_buddy);
 
         // destroy current buffer
         m_context->get_device()->wait_idle();
@@ -241,7 +361,31 @@ namespace hit
 
         // move new buffer to old buffer
         *this = std::move(new_buffer);
+        m_allocation_type = allocation_type;
         m_freelist = std::move(freelist_backup);
+        m_tlsf = std::move(tlsf_backup);
+        m_buddy = std::move(buddy_backup);
+
+        bool rebuild_result = true;
+        if (m_freelist) rebuild_result &= m_freelist->rebuild(plan.allocations);
+        if (m_tlsf) rebuild_result &= m_tlsf->rebuild(plan.allocations);
+        if (m_buddy) rebuild_result &= m_buddy->rebuild(plan.allocations);
+
+        if (!rebuild_result)
+        {
+            hit_error("Failed to rebuild the allocator of the defragmented buffer, its allocations are lost!");
+            return false;
+        }
+
+        if (!remap) return true;
+
+        for (ui64 i = 0; i < allocations.size(); i++)
+        {
+            if (allocations[i].offset != plan.allocations[i].offset)
+            {
+                remap(allocations[i].offset, plan.allocations[i].offset);
+            }
+        }
 
         return true;
     }
@@ -469,6 +613,42 @@ namespace hit
         return true;
     }
 
+    bool VulkanBuffer::copy(Buffer& other, std::span<const SubAllocationCopy> regions)
+    {
+        auto device = m_context->get_device();
+        device->wait_graphics_queue();
+
+        auto other_buffer = ((VulkanBuffer*)&other)->m_buffer;
+
+        if (!bind())
+        {
+            hit_error("Failed to bind destination buffer.");
+            return false;
+        }
+
+        std::vector<VkBufferCopy> copy_regions(regions.size());
+        for (ui64 i = 0; i < regions.size(); i++)
+        {
+            copy_regions[i].srcOffset = regions[i].src_offset;
+            copy_regions[i].dstOffset = regions[i].dst_offset;
+            copy_regions[i].size = regions[i].size;
+        }
+
+        if (!run_single_graphics_command((VulkanDevice*)device,
+            [&](VkCommandBuffer command)
+        {
+            vkCmdCopyBuffer(command, other_buffer, m_buffer, (ui32)copy_regions.size(), copy_regions.data());
+        }))
+        {
+            hit_error("Failed to run graphics command.");
+            return false;
+        }
+
+        unbind();
+
+        return true;
+    }
+
     bool VulkanBuffer::is_device_local()
     {
         return m_memory_flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
@@ -648,7 +648,7 @@ namespace hit
 
 		auto new_instance = instance_list.emplace();
 		auto vk_instance = instance_list.get(new_instance);
-		auto out_instance = PipelineInstance(new_instance, (i32)bind);
+		auto out_instance = PipelineInstance(PipelineHandle(new_instance), (i32)bind);
 
 		if (!vk_instance)
 		{
@@ -699,7 +699,7 @@ namespace hit
 		}
 
 		auto& instance_list = m_sets_configs[instance.bind].instances;
-		Handle<VulkanPipelineInstance> vk_instance = instance.handle;
+		const auto vk_instance = Handle<VulkanPipelineInstance>(instance.handle);
 
 		auto intern_instance = instance_list.get(vk_instance);
 
@@ -745,7 +745,7 @@ namespace hit
 		}
 
 		auto& instance_list = m_sets_configs[instance.bind].instances;
-		Handle<VulkanPipelineInstance> vk_instance = instance.handle;
+		const auto vk_instance = Handle<VulkanPipelineInstance>(instance.handle);
 
 		auto intern_instance = instance_list.get(vk_instance);
 
@@ -762,13 +762,19 @@ namespace hit
 		// update set if it's dirty, only once per frame
 		if (intern_instance->dirty[current_frame])
 		{
-			std::vector<VkDescriptorBufferInfo> buffer_infos;
-			std::vector<VkWriteDescriptorSet> writes;
+			auto& uniforms = m_sets_configs[instance.bind].uniforms;
+
+			// buffer infos are referenced by the writes, so they must not grow after reserving
+			FrameVector<VkDescriptorBufferInfo> buffer_infos(m_context->get_frame_allocator());
+			FrameVector<VkWriteDescriptorSet> writes(m_context->get_frame_allocator());
+
+			buffer_infos.reserve(uniforms.size());
+			writes.reserve(uniforms.size());
 
 			auto vk_buffer = (VulkanBuffer*)m_sets_configs[instance.bind].buffer.get();
 			vk_buffer->bind();
 
-			for (ui64 binding = 0; auto & uniform : m_sets_configs[instance.bind].uniforms)
+			for (ui64 binding = 0; auto & uniform : uniforms)
 			{
 				if (uniform.is_push_constant())
 					continue;
@@ -838,7 +844,7 @@ namespace hit
 		}
 
 		auto& instance_list = m_sets_configs[instance.bind].instances;
-		Handle<VulkanPipelineInstance> vk_instance = instance.handle;
+		const auto vk_instance = Handle<VulkanPipelineInstance>(instance.handle);
 
 		auto intern_instance = instance_list.get(vk_instance);
 
@@ -851,7 +857,7 @@ namespace hit
 		// get swapchin image count
 		ui64 image_count = m_context->get_swapchain()->get_image_count();
 
-		ui64 instance_offset = m_sets_configs[instance.bind].uniforms_size * instance.handle.index;
+		ui64 instance_offset = m_sets_configs[instance.bind].uniforms_size * instance.handle.index();
 		if (!m_sets_configs[instance.bind].buffer->load(offset, size, data))
 		{
 			hit_fatal("Failed to update pipeline instance buffer.");
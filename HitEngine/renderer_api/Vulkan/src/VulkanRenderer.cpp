@@ -14,6 +14,8 @@ namespace hit
     {
         const auto& renderer_configuration = get_engine()->get_renderer_config();
 
+        m_frame_allocator = &((Engine*)get_engine())->get_frame_allocator();
+
         VulkanDeviceInfo device_info;
         device_info.engine = (Engine*)get_engine();
         device_info.window = (Window*)Platform::get_main_window();
@@ -2,11 +2,20 @@
 
 #include "Core/Assert.h"
 
+#include <algorithm>
+
 namespace hit
 {
-    Arena::Arena(ui64 size, MemoryUsage usage)
+    // virtual arenas commit memory in steps of this size
+    constexpr ui64 virtual_arena_commit_size = 64 * 1024;
+
+    constexpr ui64 scratch_arena_reserve_size = 256 * 1024 * 1024;
+
+    static thread_local Arena t_scratch_arena;
+
+    Arena::Arena(ui64 size, MemoryUsage usage, const Memory::AllocationOptions& options)
     {
-        bool creation_result = create(size, usage);
+        bool creation_result = create(size, usage, options);
         hit_assert(creation_result, "Failed to create Arena!");
     }
 
@@ -15,11 +24,14 @@ namespace hit
         other.copy_to(this);
     }
 
-    Arena::Arena(Arena&& other) noexcept : m_usage(other.m_usage), m_used(other.m_used)
+    Arena::Arena(Arena&& other) noexcept 
+        : m_usage(other.m_usage), m_options(other.m_options), m_used(other.m_used),
+        m_reserved(other.m_reserved), m_decommit_on_reset(other.m_decommit_on_reset)
     {
         other.m_usage.memory = nullptr;
         other.m_usage.size = 0;
         other.m_used = 0;
+        other.m_reserved = 0;
     }
 
     Arena::~Arena()
@@ -39,16 +51,20 @@ namespace hit
         destroy();
 
         m_usage = other.m_usage;
+        m_options = other.m_options;
         m_used = other.m_used;
+        m_reserved = other.m_reserved;
+        m_decommit_on_reset = other.m_decommit_on_reset;
 
         other.m_usage.memory = nullptr;
         other.m_usage.size = 0;
         other.m_used = 0;
+        other.m_reserved = 0;
 
         return *this;
     }
 
-    bool Arena::create(ui64 size, MemoryUsage usage)
+    bool Arena::create(ui64 size, MemoryUsage usage, const Memory::AllocationOptions& options)
     {
         if(!size)
         {
@@ -62,13 +78,48 @@ namespace hit
             return true;
         }
 
-        m_usage = Memory::allocate_usage(size, usage);
+        m_usage = Memory::allocate_usage(size, usage, options);
         if(!m_usage.memory)
         {
             hit_error("Failed to allocate memory to Arena!");
             return false;
         }
 
+        m_options = options;
+        m_used = 0;
+
+        return true;
+    }
+
+    bool Arena::create_virtual(ui64 reserve_size, MemoryUsage usage, bool decommit_on_reset)
+    {
+        if(!reserve_size)
+        {
+            hit_warning("Attempting to create a virtual Arena with no size!");
+            return false;
+        }
+
+        if(m_usage.memory)
+        {
+            hit_warning("Arena usage '{}' is already created!", m_usage);
+            return true;
+        }
+
+        reserve_size = (reserve_size + virtual_arena_commit_size - 1) & ~(virtual_arena_commit_size - 1);
+
+        m_usage.memory = Memory::reserve_virtual_memory(reserve_size, usage);
+        if(!m_usage.memory)
+        {
+            hit_error("Failed to reserve memory to Arena!");
+            return false;
+        }
+
+        m_usage.usage = usage;
+        m_usage.size = 0;
+
+        m_options = Memory::uninitialized_allocation;
+        m_reserved = reserve_size;
+        m_decommit_on_reset = decommit_on_reset;
         m_used = 0;
 
         return true;
@@ -78,25 +129,47 @@ namespace hit
     {
         if(m_usage.memory)
         {
-            Memory::deallocate_usage(m_usage);
+            if(m_reserved)
+            {
+                Memory::release_virtual_memory(m_usage.memory, m_reserved, m_usage.size, m_usage.usage);
+                m_usage.memory = nullptr;
+                m_usage.size = 0;
+                m_reserved = 0;
+            }
+            else
+            {
+                Memory::deallocate_usage(m_usage);
+            }
+
             m_used = 0;
         }
     }
     
     ui8* Arena::push_memory(ui64 size)
     {
-        if(m_used + size >= m_usage.size)
+        if(m_reserved)
+        {
+            // committed memory grows in place, previous pointers stay valid
+            if(m_used + size > m_usage.size)
+            {
+                if(m_used + size > m_reserved)
+                {
+                    hit_error("Virtual Arena is out of its {}bytes reserve!", m_reserved);
+                    return nullptr;
+                }
+
+                if(!commit_memory(m_used + size - m_usage.size)) return nullptr;
+            }
+        }
+        else if(m_used + size > m_usage.size)
 		{
-			ui64 new_capacity = m_usage.size + size;
-			new_capacity = (new_capacity >> 1)  | new_capacity;
-			new_capacity = (new_capacity >> 2)  | new_capacity;
-			new_capacity = (new_capacity >> 4)  | new_capacity;
-			new_capacity = (new_capacity >> 8)  | new_capacity;
-			new_capacity = (new_capacity >> 16) | new_capacity;
-			new_capacity = (new_capacity >> 32) | new_capacity;
-			new_capacity++;
-
-            m_usage = Memory::reallocate_usage(m_usage, new_capacity);
+            // a failed reallocation, like a usage over its hard limit, keeps the old block
+            m_usage = Memory::reallocate_usage(m_usage, arena_grow_capacity(m_usage.size, m_used + size));
+            if(m_used + size > m_usage.size)
+            {
+                hit_error("Failed to grow Arena to {}bytes!", m_used + size);
+                return nullptr;
+            }
 		}
 
         ui8* mem_ptr = m_usage.memory + m_used;
@@ -104,25 +177,86 @@ namespace hit
 		return mem_ptr;
     }
 
+    ui8* Arena::push_memory(ui64 size, ui64 alignment)
+    {
+        hit_assert(
+            m_reserved || alignment <= std::max(m_options.alignment, Memory::default_alignment), 
+            "Attempting to push memory aligned to {}, but Arena is aligned to {}!", alignment, m_options.alignment);
+
+        // arena memory is at least aligned as requested, so only the offset needs padding
+        const ui64 padding = (alignment - (m_used & (alignment - 1))) & (alignment - 1);
+
+        ui8* mem_ptr = push_memory(padding + size);
+        return mem_ptr ? mem_ptr + padding : nullptr;
+    }
+
     void Arena::pop_memory(ui64 size)
     {
         hit_assert(size <= m_used, "Attempting to pop {}bytes, but Arena have used just {}bytes!", size, m_used);
         m_used -= size;
     }
 
-    void Arena::increment_memory(ui64 size)
+    bool Arena::increment_memory(ui64 size)
     {
         hit_warning_if(!size, "Attempting to increment Arena memory by 0!");
 
+        if(m_reserved)
+        {
+            // a reservation can't grow, memory is committed ahead instead
+            if(m_usage.size + size > m_reserved)
+            {
+                hit_error("Attempting to increment a virtual Arena beyond its reserve!");
+                return false;
+            }
+
+            return !size || commit_memory(size);
+        }
+
         if(m_usage.memory && size > 0)
         {
-            m_usage = Memory::reallocate_usage(m_usage, m_usage.size + size);
+            const ui64 new_size = m_usage.size + size;
+
+            m_usage = Memory::reallocate_usage(m_usage, new_size);
+            if(m_usage.size != new_size)
+            {
+                hit_error("Failed to increment Arena memory to {}bytes!", new_size);
+                return false;
+            }
         }
+
+        return true;
+    }
+
+    void Arena::rewind(ui64 marker)
+    {
+        hit_assert(marker <= m_used, "Attempting to rewind Arena to {}bytes, but it have used just {}bytes!", marker, m_used);
+        m_used = marker;
     }
 
     void Arena::reset()
     {
         m_used = 0;
+
+        if(m_reserved && m_decommit_on_reset && m_usage.size)
+        {
+            Memory::decommit_virtual_memory(m_usage.memory, m_usage.size, m_usage.usage);
+            m_usage.size = 0;
+        }
+    }
+
+    bool Arena::commit_memory(ui64 size)
+    {
+        ui64 commit_size = (size + virtual_arena_commit_size - 1) & ~(virtual_arena_commit_size - 1);
+        commit_size = std::min(commit_size, m_reserved - m_usage.size);
+
+        if(!Memory::commit_virtual_memory(m_usage.memory + m_usage.size, commit_size, m_usage.usage))
+        {
+            hit_error("Failed to commit {}bytes to virtual Arena!", commit_size);
+            return false;
+        }
+
+        m_usage.size += commit_size;
+        return true;
     }
 
     void Arena::copy_to(Arena* other) const
@@ -146,11 +280,43 @@ namespace hit
 
         if(!m_usage.memory) return;
 
-        bool creation_result = other->create(m_usage.size, m_usage.usage);
+        if(m_reserved)
+        {
+            bool creation_result = other->create_virtual(m_reserved, m_usage.usage, m_decommit_on_reset);
+            hit_assert(creation_result, "Failed to reserve memory to copy Arena!");
+
+            if(m_usage.size)
+            {
+                bool commit_result = other->commit_memory(m_usage.size);
+                hit_assert(commit_result, "Failed to commit memory to copy Arena!");
+            }
+            if(m_used) Memory::copy_memory(other->m_usage.memory, m_usage.memory, m_used);
+
+            other->m_used = m_used;
+            return;
+        }
+
+        bool creation_result = other->create(m_usage.size, m_usage.usage, m_options);
         hit_assert(creation_result, "Failed to allocate memory to copy Arena!");
 
         Memory::copy_usage(other->m_usage, m_usage, m_usage.size);
         other->m_used = m_used;
     }
 
+    Arena& get_scratch_arena()
+    {
+        if(!t_scratch_arena.memory()) [[unlikely]]
+        {
+            bool creation_result = t_scratch_arena.create_virtual(scratch_arena_reserve_size);
+            hit_assert(creation_result, "Failed to create scratch Arena!");
+        }
+
+        return t_scratch_arena;
+    }
+
+    void release_scratch_arena()
+    {
+        hit_assert(!t_scratch_arena.size(), "Attempting to release a scratch Arena still in use!");
+        t_scratch_arena.destroy();
+    }
 }
\ No newline at end of file
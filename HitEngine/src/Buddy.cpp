@@ -0,0 +1,249 @@
+#include "Utils/Buddy.h"
+#include "Core/Log.h"
+#include "Core/Assert.h"
+
+#include <bit>
+
+namespace hit
+{
+	BuddyAllocator::BuddyAllocator(ui64 initial_size, ui64 min_block_size) : m_min_block_size(min_block_size), m_size(initial_size), m_used(0)
+	{
+		hit_assert(std::has_single_bit(min_block_size), "BuddyAllocator minimum block size must be a power of two!");
+
+		m_min_block_log2 = std::countr_zero(min_block_size);
+
+		clear();
+	}
+
+	bool BuddyAllocator::push_size(ui64 size, ui64& out_offset, ui64 alignment)
+	{
+		hit_assert(std::has_single_bit(alignment), "BuddyAllocator alignment must be a power of two!");
+
+		if(!size)
+		{
+			hit_warning("Attempting to allocate 0 bytes!");
+			return false;
+		}
+
+		// blocks are aligned to their size, so a big enough block is aligned too
+		const ui32 order = get_order(std::max(size, alignment));
+		if(order > m_root_order || m_tree[0] <= order)
+		{
+			hit_warning("Can't find space to allocate {} bytes", size);
+			return false;
+		}
+
+		ui64 node = 0;
+		for(ui32 node_order = m_root_order; node_order > order; node_order--)
+		{
+			const ui64 left = 2 * node + 1;
+
+			// the tighter child is taken, so bigger free blocks stay whole
+			const bool left_fits = m_tree[left] > order;
+			const bool right_fits = m_tree[left + 1] > order;
+
+			node = left_fits && (!right_fits || m_tree[left] <= m_tree[left + 1]) ? left : left + 1;
+		}
+
+		m_tree[node] = 0;
+		update_parents(node, order);
+
+		const ui64 first_node = (1ull << (m_root_order - order)) - 1;
+		out_offset = (node - first_node) << (order + m_min_block_log2);
+
+		m_used += get_order_size(order);
+
+		return true;
+	}
+
+	bool BuddyAllocator::pop_size(ui64 size, ui64 offset)
+	{
+		if(offset >= get_usable_size() || (offset & (m_min_block_size - 1)))
+		{
+			hit_warning("Attempting to pop memory at a free space!");
+			return false;
+		}
+
+		// the nodes below a used block are left as they were, so the used block
+		// is the first one found going up from the smallest block at the offset
+		ui64 node = (1ull << m_root_order) - 1 + (offset >> m_min_block_log2);
+		ui32 order = 0;
+
+		while(m_tree[node])
+		{
+			if(!node)
+			{
+				hit_warning("Attempting to pop memory at a free space!");
+				return false;
+			}
+
+			node = (node - 1) / 2;
+			order++;
+		}
+
+		const ui64 first_node = (1ull << (m_root_order - order)) - 1;
+		if(((node - first_node) << (order + m_min_block_log2)) != offset)
+		{
+			hit_warning("Attempting to pop memory inside of a block!");
+			return false;
+		}
+
+		hit_warning_if(size > get_order_size(order), "Attempting to pop {} bytes from a block of {} bytes!", size, get_order_size(order));
+
+		m_tree[node] = order + 1;
+		update_parents(node, order);
+
+		m_used -= get_order_size(order);
+
+		return true;
+	}
+
+	bool BuddyAllocator::rebuild(std::span<const SubAllocation> allocations)
+	{
+		clear();
+
+		for(auto& allocation : allocations)
+		{
+			const ui32 order = get_order(std::max(allocation.size, allocation.alignment));
+			const ui64 block_size = get_order_size(order);
+
+			if(order > m_root_order || (allocation.offset & (block_size - 1)) || allocation.offset + block_size > get_usable_size())
+			{
+				hit_error("Can't rebuild buddy allocator, allocation at {} of {} bytes isn't a block.", allocation.offset, allocation.size);
+
+				clear();
+				return false;
+			}
+
+			// a full node on the way means the block is already used
+			ui64 node = 0;
+			bool overlaps = !m_tree[node];
+
+			for(ui32 node_order = m_root_order; node_order > order && !overlaps; node_order--)
+			{
+				node = 2 * node + 1 + ((allocation.offset >> (node_order - 1 + m_min_block_log2)) & 1);
+				overlaps = !m_tree[node];
+			}
+
+			if(overlaps || m_tree[node] != order + 1)
+			{
+				hit_error("Can't rebuild buddy allocator, allocation at {} of {} bytes overlaps another.", allocation.offset, allocation.size);
+
+				clear();
+				return false;
+			}
+
+			m_tree[node] = 0;
+			update_parents(node, order);
+
+			m_used += block_size;
+		}
+
+		return true;
+	}
+
+	bool BuddyAllocator::resize(ui64 new_size)
+	{
+		if(new_size < m_size)
+		{
+			hit_error("Can't resize a buddy allocator to a size less than it has at the moment.");
+			return false;
+		}
+
+		if(new_size == m_size) return true;
+
+		// the old part past the usable size is given back first
+		const ui64 capacity = get_order_size(m_root_order);
+		if(get_usable_size() < capacity) mark_range(0, 0, m_root_order, get_usable_size(), capacity, false);
+
+		m_size = new_size;
+
+		const ui64 block_count = std::bit_ceil(std::max(get_usable_size() >> m_min_block_log2, (ui64)1));
+		const ui32 root_order = std::countr_zero(block_count);
+
+		if(root_order > m_root_order)
+		{
+			std::vector<ui8> tree(2 * block_count - 1);
+			for(ui32 depth = 0; depth <= root_order; depth++)
+			{
+				std::fill_n(tree.begin() + ((1ull << depth) - 1), 1ull << depth, (ui8)(root_order - depth + 1));
+			}
+
+			// the old tree becomes the leftmost subtree of the same depth
+			const ui32 grown_depth = root_order - m_root_order;
+			for(ui32 depth = 0; depth <= m_root_order; depth++)
+			{
+				std::copy_n(m_tree.begin() + ((1ull << depth) - 1), 1ull << depth, tree.begin() + ((1ull << (depth + grown_depth)) - 1));
+			}
+
+			m_tree = std::move(tree);
+			m_root_order = root_order;
+
+			update_parents((1ull << grown_depth) - 1, m_root_order - grown_depth);
+		}
+
+		const ui64 new_capacity = get_order_size(m_root_order);
+		if(get_usable_size() < new_capacity) mark_range(0, 0, m_root_order, get_usable_size(), new_capacity, true);
+
+		return true;
+	}
+
+	void BuddyAllocator::clear()
+	{
+		const ui64 block_count = std::bit_ceil(std::max(get_usable_size() >> m_min_block_log2, (ui64)1));
+
+		m_root_order = std::countr_zero(block_count);
+		m_used = 0;
+
+		// every node starts as a whole free block
+		m_tree.resize(2 * block_count - 1);
+		for(ui32 depth = 0; depth <= m_root_order; depth++)
+		{
+			std::fill_n(m_tree.begin() + ((1ull << depth) - 1), 1ull << depth, (ui8)(m_root_order - depth + 1));
+		}
+
+		const ui64 capacity = get_order_size(m_root_order);
+		if(get_usable_size() < capacity) mark_range(0, 0, m_root_order, get_usable_size(), capacity, true);
+	}
+
+	ui32 BuddyAllocator::get_order(ui64 size)
+	{
+		const ui64 block_count = (size + m_min_block_size - 1) >> m_min_block_log2;
+		return block_count > 1 ? 64 - std::countl_zero(block_count - 1) : 0;
+	}
+
+	void BuddyAllocator::update_node(ui64 node, ui32 order)
+	{
+		const ui8 left = m_tree[2 * node + 1];
+		const ui8 right = m_tree[2 * node + 2];
+
+		// two whole free buddies are merged back
+		m_tree[node] = left == order && right == order ? (ui8)(order + 1) : std::max(left, right);
+	}
+
+	void BuddyAllocator::update_parents(ui64 node, ui32 order)
+	{
+		while(node)
+		{
+			node = (node - 1) / 2;
+			update_node(node, ++order);
+		}
+	}
+
+	void BuddyAllocator::mark_range(ui64 node, ui64 node_offset, ui32 order, ui64 begin, ui64 end, bool used)
+	{
+		const ui64 node_end = node_offset + get_order_size(order);
+		if(node_end <= begin || node_offset >= end) return;
+
+		if((begin <= node_offset && node_end <= end) || !order)
+		{
+			m_tree[node] = used ? 0 : (ui8)(order + 1);
+			return;
+		}
+
+		mark_range(2 * node + 1, node_offset, order - 1, begin, end, used);
+		mark_range(2 * node + 2, node_offset + get_order_size(order - 1), order - 1, begin, end, used);
+
+		update_node(node, order);
+	}
+}
\ No newline at end of file
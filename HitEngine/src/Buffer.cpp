@@ -3,6 +3,8 @@
 #include "Utils/Serializer.h"
 #include "Utils/Deserializer.h"
 
+#include <algorithm>
+
 namespace hit
 {
 	ui64 ShaderData::size() const
@@ -37,6 +39,36 @@ namespace hit
 		return 0;
 	}
 
+	bool Buffer::allocate(ui64 size, ui64& out_offset, ui64 alignment)
+	{
+		alignment = std::max(alignment, m_min_alignment);
+
+		switch(m_allocation_type)
+		{
+			case BufferAllocationType::FreeList: return m_freelist->push_size(size, out_offset, alignment);
+			case BufferAllocationType::Tlsf: return m_tlsf->push_size(size, out_offset, alignment);
+			case BufferAllocationType::Buddy: return m_buddy->push_size(size, out_offset, alignment);
+			case BufferAllocationType::None: break;
+		}
+
+		hit_error("Attempting to allocate from a buffer without an allocation type!");
+		return false;
+	}
+
+	bool Buffer::deallocate(ui64 size, ui64 offset)
+	{
+		switch(m_allocation_type)
+		{
+			case BufferAllocationType::FreeList: return m_freelist->pop_size(size, offset);
+			case BufferAllocationType::Tlsf: return m_tlsf->pop_size(size, offset);
+			case BufferAllocationType::Buddy: return m_buddy->pop_size(size, offset);
+			case BufferAllocationType::None: break;
+		}
+
+		hit_error("Attempting to deallocate from a buffer without an allocation type!");
+		return false;
+	}
+
 	bool BufferData::serialize(Serializer& serializer)
 	{
 		serializer.serialize(size);
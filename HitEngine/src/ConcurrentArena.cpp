@@ -0,0 +1,223 @@
+#include "Utils/ConcurrentArena.h"
+
+#include "Core/Assert.h"
+
+#include <algorithm>
+
+namespace hit
+{
+    // a thread keeps a sub-block for each of the last few arenas it pushed to
+    constexpr ui32 concurrent_arena_thread_cache_count = 4;
+
+    struct ConcurrentArenaThreadCache
+    {
+        ui64 epoch = 0;
+        ui8* cursor = nullptr;
+        ui8* end = nullptr;
+    };
+
+    static std::atomic<ui64> s_concurrent_arena_epoch = 0;
+
+    static thread_local ConcurrentArenaThreadCache t_thread_caches[concurrent_arena_thread_cache_count];
+    static thread_local ui32 t_next_thread_cache = 0;
+
+    static inline ui8* align_memory(ui8* memory, ui64 alignment)
+    {
+        return (ui8*)(((ui64)memory + alignment - 1) & ~(alignment - 1));
+    }
+
+    static ConcurrentArenaThreadCache& get_thread_cache(ui64 epoch)
+    {
+        for(auto& cache : t_thread_caches)
+        {
+            if(cache.epoch == epoch) return cache;
+        }
+
+        auto& cache = t_thread_caches[t_next_thread_cache];
+        t_next_thread_cache = (t_next_thread_cache + 1) % concurrent_arena_thread_cache_count;
+
+        cache = { epoch, nullptr, nullptr };
+        return cache;
+    }
+
+    ConcurrentArena::ConcurrentArena(ui64 block_size, MemoryUsage usage, ui64 thread_cache_size)
+    {
+        bool creation_result = create(block_size, usage, thread_cache_size);
+        hit_assert(creation_result, "Failed to create ConcurrentArena!");
+    }
+
+    ConcurrentArena::~ConcurrentArena()
+    {
+        destroy();
+    }
+
+    bool ConcurrentArena::create(ui64 block_size, MemoryUsage usage, ui64 thread_cache_size)
+    {
+        if(!block_size)
+        {
+            hit_warning("Attempting to create a ConcurrentArena with no size!");
+            return false;
+        }
+
+        if(m_current.load(std::memory_order_relaxed))
+        {
+            hit_warning("ConcurrentArena is already created!");
+            return true;
+        }
+
+        m_usage = usage;
+        m_block_size = block_size;
+        m_thread_cache_size = (thread_cache_size + Memory::default_alignment - 1) & ~((ui64)Memory::default_alignment - 1);
+
+        Block* block = allocate_block(block_size);
+        if(!block)
+        {
+            hit_error("Failed to allocate memory to ConcurrentArena!");
+            return false;
+        }
+
+        m_current.store(block, std::memory_order_release);
+        m_epoch = ++s_concurrent_arena_epoch;
+
+        return true;
+    }
+
+    void ConcurrentArena::destroy()
+    {
+        Block* block = m_current.exchange(nullptr, std::memory_order_acq_rel);
+        if(!block) return;
+
+        deallocate_blocks(block);
+
+        m_block_size = 0;
+        m_epoch = ++s_concurrent_arena_epoch;
+    }
+
+    ui8* ConcurrentArena::push_memory(ui64 size, ui64 alignment)
+    {
+        hit_assert(m_current.load(std::memory_order_relaxed), "Attempting to push memory to a not created ConcurrentArena!");
+
+        if(size + alignment > m_thread_cache_size / 4) return push_shared_memory(size, alignment);
+
+        // no atomics while the thread sub-block has room
+        auto& cache = get_thread_cache(m_epoch);
+
+        ui8* memory = align_memory(cache.cursor, alignment);
+        if(!cache.cursor || memory + size > cache.end)
+        {
+            cache.cursor = push_shared_memory(m_thread_cache_size, Memory::default_alignment);
+            cache.end = cache.cursor + m_thread_cache_size;
+
+            memory = align_memory(cache.cursor, alignment);
+        }
+
+        cache.cursor = memory + size;
+        return memory;
+    }
+
+    void ConcurrentArena::reset()
+    {
+        Block* block = m_current.load(std::memory_order_acquire);
+        if(!block) return;
+
+        if(block->next)
+        {
+            const ui64 total_capacity = capacity();
+
+            deallocate_blocks(block);
+
+            block = allocate_block(total_capacity);
+            hit_assert(block, "Failed to allocate memory to ConcurrentArena!");
+
+            m_current.store(block, std::memory_order_release);
+        }
+
+        block->used.store(0, std::memory_order_relaxed);
+        m_epoch = ++s_concurrent_arena_epoch;
+    }
+
+    ui64 ConcurrentArena::size() const
+    {
+        ui64 size = 0;
+        for(Block* block = m_current.load(std::memory_order_acquire); block; block = block->next)
+        {
+            size += std::min(block->used.load(std::memory_order_relaxed), block->capacity);
+        }
+
+        return size;
+    }
+
+    ui64 ConcurrentArena::capacity() const
+    {
+        ui64 capacity = 0;
+        for(Block* block = m_current.load(std::memory_order_acquire); block; block = block->next)
+        {
+            capacity += block->capacity;
+        }
+
+        return capacity;
+    }
+
+    ui32 ConcurrentArena::block_count() const
+    {
+        ui32 count = 0;
+        for(Block* block = m_current.load(std::memory_order_acquire); block; block = block->next) count++;
+
+        return count;
+    }
+
+    ConcurrentArena::Block* ConcurrentArena::allocate_block(ui64 capacity)
+    {
+        capacity = (capacity + Memory::default_alignment - 1) & ~((ui64)Memory::default_alignment - 1);
+
+        auto block = (Block*)Memory::allocate_memory(sizeof(Block) + capacity, m_usage, Memory::uninitialized_allocation);
+        if(!block) return nullptr;
+
+        new (&block->used) std::atomic<ui64>(0);
+        block->capacity = capacity;
+        block->next = nullptr;
+
+        return block;
+    }
+
+    void ConcurrentArena::deallocate_blocks(Block* block)
+    {
+        while(block)
+        {
+            Block* next = block->next;
+            Memory::deallocate_memory((ui8*)block);
+            block = next;
+        }
+    }
+
+    ui8* ConcurrentArena::push_shared_memory(ui64 size, ui64 alignment)
+    {
+        // offsets stay aligned to default_alignment, bigger alignments are padded
+        size = (size + Memory::default_alignment - 1) & ~((ui64)Memory::default_alignment - 1);
+        const ui64 reserve_size = alignment > Memory::default_alignment ? size + alignment - Memory::default_alignment : size;
+
+        while(true)
+        {
+            Block* block = m_current.load(std::memory_order_acquire);
+
+            const ui64 offset = block->used.fetch_add(reserve_size, std::memory_order_relaxed);
+            if(offset + reserve_size <= block->capacity)
+            {
+                return align_memory(block->memory() + offset, alignment);
+            }
+
+            // the block is full, whoever chains first wins and the others retry on the new block
+            if(m_current.load(std::memory_order_acquire) != block) continue;
+
+            Block* new_block = allocate_block(std::max(m_block_size, reserve_size));
+            hit_assert(new_block, "Failed to allocate memory to ConcurrentArena!");
+
+            new_block->next = block;
+
+            if(!m_current.compare_exchange_strong(block, new_block, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                Memory::deallocate_memory((ui8*)new_block);
+            }
+        }
+    }
+}
\ No newline at end of file
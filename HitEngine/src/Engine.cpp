@@ -19,6 +19,19 @@ namespace hit
 
         m_engine_data = data;
 
+        Memory::set_memory_statistics_dump(data.memory_statistics_file, data.memory_statistics_interval);
+
+        if(data.memory_trace_sample_rate) Memory::enable_allocation_tracing(data.memory_trace_sample_rate);
+
+        for(ui32 i = 0; i < Memory::Usage::MaxUsageCount; i++) Memory::set_usage_budget((MemoryUsage)i, data.memory_budgets[i]);
+        if(data.memory_snapshot_interval) m_memory_snapshot = Memory::take_snapshot();
+
+        if(!m_frame_allocator.create(data.frame_allocator_count, data.frame_allocator_size))
+        {
+            hit_error("Failed to create engine frame allocator!");
+            return false;
+        }
+
         m_modules.set_engine(this);
         m_modules.add_module("Platform", create_ref<Platform>());
         m_modules.add_module("Renderer", create_ref<Renderer>());
@@ -32,6 +45,10 @@ namespace hit
     {
         m_modules.shutdown_pipeline();
 
+        hit_info("Frame allocator high water mark: {}bytes.", m_frame_allocator.high_water_mark());
+        m_frame_allocator.destroy();
+        release_scratch_arena();
+
         if(!Memory::shutdown_memory_system())
         {
             hit_warning("Engine is leaking memory!");
@@ -46,6 +63,8 @@ namespace hit
 
         while(main_window->is_running()) [[likely]]
         {
+            m_frame_allocator.begin_frame();
+
             if(!m_modules.execute_modules() && !m_invalid_window_size) [[unlikely]]
             {
                 hit_fatal("Engine main loop fails!");
@@ -59,6 +78,9 @@ namespace hit
                 Platform::wait_for_valid_window_size(main_window);
                 m_invalid_window_size = false;
             }
+
+            Memory::end_memory_frame();
+            update_memory_snapshot();
         }
     }
 
@@ -94,6 +116,17 @@ namespace hit
         return false;
     }
 
+    void Engine::update_memory_snapshot()
+    {
+        const ui32 interval = m_engine_data.memory_snapshot_interval;
+        if(!interval || Memory::get_memory_frame() % interval != 0) return;
+
+        auto snapshot = Memory::take_snapshot();
+        Memory::write_snapshot_diff(m_engine_data.memory_snapshot_file, Memory::diff(m_memory_snapshot, snapshot));
+
+        m_memory_snapshot = std::move(snapshot);
+    }
+
     bool Engine::has_module(const std::string& module_name) const
     {
         return m_modules.has_module(module_name);
@@ -0,0 +1,78 @@
+#include "Utils/FrameAllocator.h"
+
+#include "Core/Assert.h"
+
+#include <algorithm>
+
+namespace hit
+{
+    FrameAllocator::FrameAllocator(ui32 frame_count, ui64 frame_size, MemoryUsage usage)
+    {
+        bool creation_result = create(frame_count, frame_size, usage);
+        hit_assert(creation_result, "Failed to create FrameAllocator!");
+    }
+
+    FrameAllocator::~FrameAllocator()
+    {
+        destroy();
+    }
+
+    bool FrameAllocator::create(ui32 frame_count, ui64 frame_size, MemoryUsage usage)
+    {
+        if(!frame_count || !frame_size)
+        {
+            hit_warning_if(!frame_count, "Attempting to create a FrameAllocator with no frames!");
+            hit_warning_if(!frame_size, "Attempting to create a FrameAllocator with no frame size!");
+            return false;
+        }
+
+        if(!m_frames.empty())
+        {
+            hit_warning("FrameAllocator is already created!");
+            return true;
+        }
+
+        // virtual arenas, so growing inside a frame never moves what was already allocated
+        m_frames.resize(frame_count);
+        for(auto& frame : m_frames)
+        {
+            if(!frame.create_virtual(frame_size, usage))
+            {
+                hit_error("Failed to create FrameAllocator frame arena!");
+                destroy();
+                return false;
+            }
+        }
+
+        m_frame_index = 0;
+        m_frame_number = 0;
+        m_high_water_mark = 0;
+
+        return true;
+    }
+
+    void FrameAllocator::destroy()
+    {
+        m_frames.clear();
+        m_frame_index = 0;
+    }
+
+    void FrameAllocator::begin_frame()
+    {
+        if(m_frames.empty()) return;
+
+        m_high_water_mark = std::max(m_high_water_mark, m_frames[m_frame_index].size());
+
+        m_frame_index = (m_frame_index + 1) % (ui32)m_frames.size();
+        m_frame_number++;
+
+        m_frames[m_frame_index].reset();
+    }
+
+    ui8* FrameAllocator::allocate(ui64 size, ui64 alignment)
+    {
+        hit_assert(!m_frames.empty(), "Attempting to allocate from a not created FrameAllocator!");
+
+        return m_frames[m_frame_index].push_memory(size, alignment);
+    }
+}
\ No newline at end of file
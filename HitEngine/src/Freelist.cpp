@@ -6,17 +6,60 @@
 
 namespace hit
 {
+	DefragmentationPlan plan_defragmentation(std::span<const SubAllocation> allocations)
+	{
+		DefragmentationPlan plan;
+		plan.allocations.assign(allocations.begin(), allocations.end());
+
+		std::vector<ui64> order(allocations.size());
+		for(ui64 i = 0; i < order.size(); i++) order[i] = i;
+
+		std::sort(order.begin(), order.end(), [&](ui64 a, ui64 b) { return allocations[a].offset < allocations[b].offset; });
+
+		ui64 cursor = 0;
+		for(ui64 index : order)
+		{
+			auto& allocation = plan.allocations[index];
+
+			const ui64 alignment = std::max(allocation.alignment, (ui64)1);
+			const ui64 offset = (cursor + alignment - 1) / alignment * alignment;
+
+			// a run of allocations which stays contiguous is copied at once
+			auto* last_copy = plan.copies.empty() ? nullptr : &plan.copies.back();
+			if(last_copy && last_copy->src_offset + last_copy->size == allocation.offset && last_copy->dst_offset + last_copy->size == offset)
+			{
+				last_copy->size += allocation.size;
+			}
+			else
+			{
+				plan.copies.push_back({ allocation.offset, offset, allocation.size });
+			}
+
+			allocation.offset = offset;
+			cursor = offset + allocation.size;
+		}
+
+		plan.used_size = cursor;
+
+		return plan;
+	}
+
 	FreelistCore::FreelistCore(ui64 initial_size) : m_size(initial_size), m_used(0)
 	{
 		m_memory_dist[0] = initial_size;
 	}
 
-	bool FreelistCore::push_size(ui64 size, ui64& out_offset)
+	bool FreelistCore::push_size(ui64 size, ui64& out_offset, ui64 alignment)
 	{
-		auto it = std::lower_bound(m_memory_dist.begin(), m_memory_dist.end(), size,
-			[](const std::pair<const ui64, ui64>& elem, ui64 value)
+		hit_assert(alignment && !(alignment & (alignment - 1)), "Freelist alignment must be a power of two!");
+
+		// blocks are sorted by offset, not by size, so the first one which fits once aligned is searched
+		ui64 aligned_offset = 0;
+		auto it = std::find_if(m_memory_dist.begin(), m_memory_dist.end(),
+			[&](const std::pair<const ui64, ui64>& elem)
 		{
-			return elem.second < value;
+			aligned_offset = (elem.first + alignment - 1) & ~(alignment - 1);
+			return aligned_offset + size <= elem.first + elem.second;
 		});
 
 		if(it == m_memory_dist.end())
@@ -25,16 +68,23 @@ namespace hit
 			return false;
 		}
 
-		out_offset = it->first;
-		ui64 remaining_size = it->second - size;
+		const ui64 block_offset = it->first;
+		const ui64 block_end = it->first + it->second;
 
 		m_memory_dist.erase(it);
 
-		if(remaining_size > 0)
+		// the padding in front stays free
+		if(aligned_offset > block_offset)
+		{
+			m_memory_dist[block_offset] = aligned_offset - block_offset;
+		}
+
+		if(block_end > aligned_offset + size)
 		{
-			m_memory_dist[out_offset + size] = remaining_size;
+			m_memory_dist[aligned_offset + size] = block_end - (aligned_offset + size);
 		}
 
+		out_offset = aligned_offset;
 		m_used += size;
 
 		return true;
@@ -47,7 +97,7 @@ namespace hit
 
 		// check if offset + size is not going beyond it must go
 		auto next_it = m_memory_dist.lower_bound(offset);
-		auto prev_it = next_it != m_memory_dist.end() ? std::prev(next_it) : m_memory_dist.end();
+		auto prev_it = next_it != m_memory_dist.begin() ? std::prev(next_it) : m_memory_dist.end();
 		if(next_it != m_memory_dist.end())
 		{
 			hit_warning_if(offset + size > next_it->first, "Attempting to pop memory at a free space!");
@@ -107,6 +157,38 @@ namespace hit
 		return true;
 	}
 
+	bool FreelistCore::rebuild(std::span<const SubAllocation> allocations)
+	{
+		clear();
+
+		for(auto& allocation : allocations)
+		{
+			// the free block holding the allocation is split around it
+			auto it = m_memory_dist.upper_bound(allocation.offset);
+			if(it == m_memory_dist.begin() || allocation.offset + allocation.size > std::prev(it)->first + std::prev(it)->second)
+			{
+				hit_error("Can't rebuild freelist, allocation at {} of {} bytes overlaps another or is out of bounds.", allocation.offset, allocation.size);
+
+				clear();
+				return false;
+			}
+
+			it = std::prev(it);
+
+			const ui64 block_offset = it->first;
+			const ui64 block_end = it->first + it->second;
+
+			m_memory_dist.erase(it);
+
+			if(allocation.offset > block_offset) m_memory_dist[block_offset] = allocation.offset - block_offset;
+			if(block_end > allocation.offset + allocation.size) m_memory_dist[allocation.offset + allocation.size] = block_end - (allocation.offset + allocation.size);
+
+			m_used += allocation.size;
+		}
+
+		return true;
+	}
+
 	bool FreelistCore::resize(ui64 new_size)
 	{
 		if(new_size < m_size)
@@ -141,6 +223,14 @@ namespace hit
 		return true;
 	}
 
+	ui64 FreelistCore::get_largest_free_block()
+	{
+		ui64 largest_size = 0;
+		for(auto& [offset, size] : m_memory_dist) largest_size = std::max(largest_size, size);
+
+		return largest_size;
+	}
+
 	void FreelistCore::clear()
 	{
 		m_memory_dist.clear();
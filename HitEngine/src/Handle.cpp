@@ -0,0 +1,81 @@
+#include "Utils/Handle.h"
+#include "Core/Log.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace hit
+{
+    // resolver and type are written before the pool is published, readers only load the pool atomically
+    struct HandlePoolEntry
+    {
+        std::atomic<void*> pool = nullptr;
+        HandleResolver resolver = nullptr;
+        const void* type_id = nullptr;
+    };
+
+    static HandlePoolEntry s_handle_pools[max_handle_pool_count];
+    static std::mutex s_handle_pools_mutex;
+
+    // ids are handed out round robin, so a stale handle of a destroyed list doesn't resolve
+    // in the next list which takes its id
+    static ui32 s_next_handle_pool = 1;
+
+    ui32 register_handle_pool(void* pool, HandleResolver resolver, const void* type_id)
+    {
+        std::lock_guard lock(s_handle_pools_mutex);
+
+        for(ui32 i = 1; i < max_handle_pool_count; i++)
+        {
+            const ui32 pool_id = s_next_handle_pool;
+            s_next_handle_pool = pool_id + 1 < max_handle_pool_count ? pool_id + 1 : 1;
+
+            auto& entry = s_handle_pools[pool_id];
+            if(entry.pool.load(std::memory_order_relaxed)) continue;
+
+            entry.resolver = resolver;
+            entry.type_id = type_id;
+            entry.pool.store(pool, std::memory_order_release);
+
+            return pool_id;
+        }
+
+        hit_warning("Every handle pool id is taken, handles of the new list can't be resolved or told apart from other lists!");
+        return 0;
+    }
+
+    void update_handle_pool(ui32 pool_id, void* pool)
+    {
+        if(!pool_id || pool_id >= max_handle_pool_count) return;
+
+        s_handle_pools[pool_id].pool.store(pool, std::memory_order_release);
+    }
+
+    void unregister_handle_pool(ui32 pool_id)
+    {
+        if(!pool_id || pool_id >= max_handle_pool_count) return;
+
+        std::lock_guard lock(s_handle_pools_mutex);
+        s_handle_pools[pool_id].pool.store(nullptr, std::memory_order_release);
+    }
+
+    void* get_handle_pool(ui32 pool_id)
+    {
+        if(pool_id >= max_handle_pool_count) return nullptr;
+
+        return s_handle_pools[pool_id].pool.load(std::memory_order_acquire);
+    }
+
+    void* resolve_handle(ui64 handle, const void* type_id)
+    {
+        const ui32 pool_id = unpack_handle_pool(handle);
+        if(!pool_id || pool_id >= max_handle_pool_count) return nullptr;
+
+        auto& entry = s_handle_pools[pool_id];
+
+        void* pool = entry.pool.load(std::memory_order_acquire);
+        if(!pool || entry.type_id != type_id) return nullptr;
+
+        return entry.resolver(pool, handle);
+    }
+}
\ No newline at end of file
@@ -1,83 +1,31 @@
 #include "Math/Mat4.h"
 
-#include "Core/Memory.h"
 #include "Math/MathDefines.h"
+#include "Math/Simd.h"
 
 namespace hit
 {
-    Mat4& Mat4::add(const Mat4& other)
+    // scalar kernels, the simd ones are checked against them
+    static Mat4 mat4_mul_scalar(const Mat4& m1, const Mat4& m2)
     {
-        for (ui32 i = 0; i < 4; i++)
-        {
-            for (ui32 j = 0; j < 4; j++)
-            {
-                columns[j][i] += other[j][i];
-            }
-        }
-
-        return *this;
-    }
+        Mat4 out_m;
 
-    Mat4& Mat4::sub(const Mat4& other)
-    {
         for (ui32 i = 0; i < 4; i++)
         {
             for (ui32 j = 0; j < 4; j++)
             {
-                columns[j][i] -= other[j][i];
+                out_m[j][i] =
+                    m1[0][i] * m2[j][0] +
+                    m1[1][i] * m2[j][1] +
+                    m1[2][i] * m2[j][2] +
+                    m1[3][i] * m2[j][3];
             }
         }
 
-        return *this;
-    }
-
-    Mat4& Mat4::mul(const Mat4& other)
-    {
-        Mat4 new_mat = mat4_mul(*this, other);
-
-        Memory::copy_memory((ui8*)data, (ui8*)new_mat.data, sizeof(f32) * 16);
-
-        return *this;
-    }
-
-    Mat4& Mat4::mul(f32 scalar)
-    {
-        for (ui32 i = 0; i < 16; i++) data[i] *= scalar;
-        return *this;
-    }
-
-    Mat4& Mat4::div(f32 scalar)
-    {
-        for (ui32 i = 0; i < 16; i++) data[i] /= scalar;
-        return *this;
-    }
-
-    Mat4& Mat4::operator+=(const Mat4& other)
-    {
-        return add(other);
-    }
-
-    Mat4& Mat4::operator-=(const Mat4& other)
-    {
-        return sub(other);
-    }
-
-    Mat4& Mat4::operator*=(const Mat4& other)
-    {
-        return mul(other);
-    }
-
-    Mat4& Mat4::operator*=(f32 scalar)
-    {
-        return mul(scalar);
-    }
-
-    Mat4& Mat4::operator/=(f32 scalar)
-    {
-        return div(scalar);
+        return out_m;
     }
 
-    Mat4 Mat4::transposed() const
+    static Mat4 mat4_transposed_scalar(const Mat4& m)
     {
         Mat4 t_mat;
 
@@ -85,15 +33,17 @@ namespace hit
         {
             for (ui32 j = 0; j < 4; j++)
             {
-                t_mat[j][i] = columns[i][j];
+                t_mat[j][i] = m[i][j];
             }
         }
 
         return t_mat;
     }
 
-    Mat4 Mat4::inverse() const
+    static Mat4 mat4_inverse_scalar(const Mat4& m)
     {
+        const f32* data = m.data;
+
         Mat4 inv_mat;
         f32* inv_data = inv_mat.data;
 
@@ -240,23 +190,518 @@ namespace hit
         return inv_mat;
     }
 
-    // mat4 functions
-    Mat4 mat4_add(const Mat4& m1, const Mat4& m2)
+    static Mat4 mat4_affine_inverse_scalar(const Mat4& m)
+    {
+        const Vec3 c0 = { m[0][0], m[0][1], m[0][2] };
+        const Vec3 c1 = { m[1][0], m[1][1], m[1][2] };
+        const Vec3 c2 = { m[2][0], m[2][1], m[2][2] };
+        const Vec3 translation = { m[3][0], m[3][1], m[3][2] };
+
+        // rows of the inverse of the upper 3x3 are the cross products of its columns
+        Vec3 rows[3] = { c1.cross(c2), c2.cross(c0), c0.cross(c1) };
+
+        const f32 determinant = c0.dot(rows[0]);
+        if(determinant == 0.0f) [[unlikely]]
+            return mat4_identity();
+
+        Mat4 inv_mat;
+        for (ui32 i = 0; i < 3; i++)
+        {
+            rows[i] /= determinant;
+
+            inv_mat[0][i] = rows[i].x;
+            inv_mat[1][i] = rows[i].y;
+            inv_mat[2][i] = rows[i].z;
+            inv_mat[3][i] = -rows[i].dot(translation);
+        }
+
+        inv_mat[3][3] = 1.0f;
+
+        return inv_mat;
+    }
+
+    static Vec4 mat4_mult_vec4_scalar(const Mat4& m, const Vec4& v)
     {
+        return {
+            v.x * m.data[0]  + v.y * m.data[1]  + v.z * m.data[2]  + v.w * m.data[3],
+            v.x * m.data[4]  + v.y * m.data[5]  + v.z * m.data[6]  + v.w * m.data[7],
+            v.x * m.data[8]  + v.y * m.data[9]  + v.z * m.data[10] + v.w * m.data[11],
+            v.x * m.data[12] + v.y * m.data[13] + v.z * m.data[14] + v.w * m.data[15]
+        };
+    }
+
+    static Vec4 vec4_mult_mat4_scalar(const Vec4& v, const Mat4& m)
+    {
+        return {
+            v.x * m.data[0] + v.y * m.data[4] + v.z * m.data[8]  + v.w * m.data[12],
+            v.x * m.data[1] + v.y * m.data[5] + v.z * m.data[9]  + v.w * m.data[13],
+            v.x * m.data[2] + v.y * m.data[6] + v.z * m.data[10] + v.w * m.data[14],
+            v.x * m.data[3] + v.y * m.data[7] + v.z * m.data[11] + v.w * m.data[15]
+        };
+    }
+
+    static void transform_points_scalar(const Mat4& m, const f32* xs, const f32* ys, const f32* zs, f32* out_xs, f32* out_ys, f32* out_zs, ui64 count)
+    {
+        for (ui64 i = 0; i < count; i++)
+        {
+            const f32 x = xs[i];
+            const f32 y = ys[i];
+            const f32 z = zs[i];
+
+            out_xs[i] = x * m.data[0] + y * m.data[4] + z * m.data[8]  + m.data[12];
+            out_ys[i] = x * m.data[1] + y * m.data[5] + z * m.data[9]  + m.data[13];
+            out_zs[i] = x * m.data[2] + y * m.data[6] + z * m.data[10] + m.data[14];
+        }
+    }
+
+    static void mat4_mul_batch_scalar(const Mat4* m1, const Mat4* m2, Mat4* out_m, ui64 count)
+    {
+        for (ui64 i = 0; i < count; i++) out_m[i] = mat4_mul_scalar(m1[i], m2[i]);
+    }
+
+#ifdef HIT_SIMD_X64
+    // _MM_SHUFFLE takes the lanes from the last one
+    #define mat4_swizzle(v, x, y, z, w) _mm_shuffle_ps(v, v, _MM_SHUFFLE(w, z, y, x))
+    #define mat4_shuffle(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+
+    // the sums are done in the order of the scalar kernels, so sse results are the same
+    HIT_TARGET_SSE41 static Mat4 mat4_mul_sse41(const Mat4& m1, const Mat4& m2)
+    {
+        const __m128 c0 = _mm_loadu_ps(m1.data);
+        const __m128 c1 = _mm_loadu_ps(m1.data + 4);
+        const __m128 c2 = _mm_loadu_ps(m1.data + 8);
+        const __m128 c3 = _mm_loadu_ps(m1.data + 12);
+
         Mat4 out_m;
 
+        for (ui32 j = 0; j < 4; j++)
+        {
+            const f32* column = m2.data + j * 4;
+
+            __m128 result = _mm_mul_ps(c0, _mm_set1_ps(column[0]));
+            result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_set1_ps(column[1])));
+            result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_set1_ps(column[2])));
+            result = _mm_add_ps(result, _mm_mul_ps(c3, _mm_set1_ps(column[3])));
+
+            _mm_storeu_ps(out_m.data + j * 4, result);
+        }
+
+        return out_m;
+    }
+
+    HIT_TARGET_SSE41 static Mat4 mat4_transposed_sse41(const Mat4& m)
+    {
+        __m128 c0 = _mm_loadu_ps(m.data);
+        __m128 c1 = _mm_loadu_ps(m.data + 4);
+        __m128 c2 = _mm_loadu_ps(m.data + 8);
+        __m128 c3 = _mm_loadu_ps(m.data + 12);
+
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        Mat4 t_mat;
+        _mm_storeu_ps(t_mat.data, c0);
+        _mm_storeu_ps(t_mat.data + 4, c1);
+        _mm_storeu_ps(t_mat.data + 8, c2);
+        _mm_storeu_ps(t_mat.data + 12, c3);
+
+        return t_mat;
+    }
+
+    // 2x2 matrices packed as (m00, m01, m10, m11)
+    HIT_TARGET_SSE41 static inline __m128 mat2_mul(__m128 a, __m128 b)
+    {
+        return _mm_add_ps(_mm_mul_ps(a, mat4_swizzle(b, 0, 3, 0, 3)), _mm_mul_ps(mat4_swizzle(a, 1, 0, 3, 2), mat4_swizzle(b, 2, 1, 2, 1)));
+    }
+
+    // adjugate(a) * b
+    HIT_TARGET_SSE41 static inline __m128 mat2_adj_mul(__m128 a, __m128 b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(mat4_swizzle(a, 3, 3, 0, 0), b), _mm_mul_ps(mat4_swizzle(a, 1, 1, 2, 2), mat4_swizzle(b, 2, 3, 0, 1)));
+    }
+
+    // a * adjugate(b)
+    HIT_TARGET_SSE41 static inline __m128 mat2_mul_adj(__m128 a, __m128 b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(a, mat4_swizzle(b, 3, 0, 3, 0)), _mm_mul_ps(mat4_swizzle(a, 1, 0, 3, 2), mat4_swizzle(b, 2, 1, 2, 1)));
+    }
+
+    // block inverse over the four 2x2 sub matrices. it doesn't depend on the layout,
+    // the inverse of the transposed matrix is the transposed inverse
+    HIT_TARGET_SSE41 static Mat4 mat4_inverse_sse41(const Mat4& m)
+    {
+        const __m128 c0 = _mm_loadu_ps(m.data);
+        const __m128 c1 = _mm_loadu_ps(m.data + 4);
+        const __m128 c2 = _mm_loadu_ps(m.data + 8);
+        const __m128 c3 = _mm_loadu_ps(m.data + 12);
+
+        const __m128 a = _mm_movelh_ps(c0, c1);
+        const __m128 b = _mm_movehl_ps(c1, c0);
+        const __m128 c = _mm_movelh_ps(c2, c3);
+        const __m128 d = _mm_movehl_ps(c3, c2);
+
+        // determinants of a, b, c and d
+        const __m128 sub_determinants = _mm_sub_ps(
+            _mm_mul_ps(mat4_shuffle(c0, c2, 0, 2, 0, 2), mat4_shuffle(c1, c3, 1, 3, 1, 3)),
+            _mm_mul_ps(mat4_shuffle(c0, c2, 1, 3, 1, 3), mat4_shuffle(c1, c3, 0, 2, 0, 2)));
+
+        const __m128 determinant_a = mat4_swizzle(sub_determinants, 0, 0, 0, 0);
+        const __m128 determinant_b = mat4_swizzle(sub_determinants, 1, 1, 1, 1);
+        const __m128 determinant_c = mat4_swizzle(sub_determinants, 2, 2, 2, 2);
+        const __m128 determinant_d = mat4_swizzle(sub_determinants, 3, 3, 3, 3);
+
+        const __m128 d_c = mat2_adj_mul(d, c);
+        const __m128 a_b = mat2_adj_mul(a, b);
+
+        __m128 x = _mm_sub_ps(_mm_mul_ps(determinant_d, a), mat2_mul(b, d_c));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(determinant_a, d), mat2_mul(c, a_b));
+        __m128 y = _mm_sub_ps(_mm_mul_ps(determinant_b, c), mat2_mul_adj(d, a_b));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(determinant_c, b), mat2_mul_adj(a, d_c));
+
+        // |m| = |a| |d| + |b| |c| - trace(a_b * d_c)
+        __m128 trace = _mm_mul_ps(a_b, mat4_swizzle(d_c, 0, 2, 1, 3));
+        trace = _mm_hadd_ps(trace, trace);
+        trace = _mm_hadd_ps(trace, trace);
+
+        __m128 determinant = _mm_add_ps(_mm_mul_ps(determinant_a, determinant_d), _mm_mul_ps(determinant_b, determinant_c));
+        determinant = _mm_sub_ps(determinant, trace);
+
+        if(_mm_cvtss_f32(determinant) == 0.0f) [[unlikely]]
+            return mat4_identity();
+
+        const __m128 inv_determinant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+
+        x = _mm_mul_ps(x, inv_determinant);
+        y = _mm_mul_ps(y, inv_determinant);
+        z = _mm_mul_ps(z, inv_determinant);
+        w = _mm_mul_ps(w, inv_determinant);
+
+        // the adjugate shuffle and the store one at once
+        Mat4 inv_mat;
+        _mm_storeu_ps(inv_mat.data, mat4_shuffle(x, y, 3, 1, 3, 1));
+        _mm_storeu_ps(inv_mat.data + 4, mat4_shuffle(x, y, 2, 0, 2, 0));
+        _mm_storeu_ps(inv_mat.data + 8, mat4_shuffle(z, w, 3, 1, 3, 1));
+        _mm_storeu_ps(inv_mat.data + 12, mat4_shuffle(z, w, 2, 0, 2, 0));
+
+        return inv_mat;
+    }
+
+    HIT_TARGET_SSE41 static inline __m128 vec3_cross(__m128 a, __m128 b)
+    {
+        const __m128 result = _mm_sub_ps(_mm_mul_ps(a, mat4_swizzle(b, 1, 2, 0, 3)), _mm_mul_ps(mat4_swizzle(a, 1, 2, 0, 3), b));
+        return mat4_swizzle(result, 1, 2, 0, 3);
+    }
+
+    HIT_TARGET_SSE41 static Mat4 mat4_affine_inverse_sse41(const Mat4& m)
+    {
+        const __m128 c0 = _mm_loadu_ps(m.data);
+        const __m128 c1 = _mm_loadu_ps(m.data + 4);
+        const __m128 c2 = _mm_loadu_ps(m.data + 8);
+        const __m128 translation = _mm_loadu_ps(m.data + 12);
+
+        __m128 r0 = vec3_cross(c1, c2);
+        __m128 r1 = vec3_cross(c2, c0);
+        __m128 r2 = vec3_cross(c0, c1);
+
+        const __m128 determinant = _mm_dp_ps(c0, r0, 0x7F);
+        if(_mm_cvtss_f32(determinant) == 0.0f) [[unlikely]]
+            return mat4_identity();
+
+        const __m128 inv_determinant = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+        r0 = _mm_mul_ps(r0, inv_determinant);
+        r1 = _mm_mul_ps(r1, inv_determinant);
+        r2 = _mm_mul_ps(r2, inv_determinant);
+
+        // the last lane of each row is its part of the inverse translation
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        r0 = _mm_blend_ps(r0, _mm_xor_ps(_mm_dp_ps(r0, translation, 0x7F), sign), 0x8);
+        r1 = _mm_blend_ps(r1, _mm_xor_ps(_mm_dp_ps(r1, translation, 0x7F), sign), 0x8);
+        r2 = _mm_blend_ps(r2, _mm_xor_ps(_mm_dp_ps(r2, translation, 0x7F), sign), 0x8);
+        __m128 r3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        Mat4 inv_mat;
+        _mm_storeu_ps(inv_mat.data, r0);
+        _mm_storeu_ps(inv_mat.data + 4, r1);
+        _mm_storeu_ps(inv_mat.data + 8, r2);
+        _mm_storeu_ps(inv_mat.data + 12, r3);
+
+        return inv_mat;
+    }
+
+    HIT_TARGET_SSE41 static Vec4 mat4_mult_vec4_sse41(const Mat4& m, const Vec4& v)
+    {
+        const __m128 vec = _mm_loadu_ps(v.elements);
+
+        // each lane of the result is the dot of a column, the products are transposed to add them at once
+        __m128 p0 = _mm_mul_ps(_mm_loadu_ps(m.data), vec);
+        __m128 p1 = _mm_mul_ps(_mm_loadu_ps(m.data + 4), vec);
+        __m128 p2 = _mm_mul_ps(_mm_loadu_ps(m.data + 8), vec);
+        __m128 p3 = _mm_mul_ps(_mm_loadu_ps(m.data + 12), vec);
+
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+        Vec4 out_v;
+        _mm_storeu_ps(out_v.elements, _mm_add_ps(_mm_add_ps(_mm_add_ps(p0, p1), p2), p3));
+
+        return out_v;
+    }
+
+    HIT_TARGET_SSE41 static Vec4 vec4_mult_mat4_sse41(const Vec4& v, const Mat4& m)
+    {
+        __m128 result = _mm_mul_ps(_mm_loadu_ps(m.data), _mm_set1_ps(v.x));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m.data + 4), _mm_set1_ps(v.y)));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m.data + 8), _mm_set1_ps(v.z)));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m.data + 12), _mm_set1_ps(v.w)));
+
+        Vec4 out_v;
+        _mm_storeu_ps(out_v.elements, result);
+
+        return out_v;
+    }
+
+    // two columns of the result at once, both halves hold the same column of m1.
+    // fma rounds once, so results may differ from the scalar kernels in the last bits
+    HIT_TARGET_AVX2 static Mat4 mat4_mul_avx2(const Mat4& m1, const Mat4& m2)
+    {
+        const __m256 c0 = _mm256_broadcast_ps((const __m128*)m1.data);
+        const __m256 c1 = _mm256_broadcast_ps((const __m128*)(m1.data + 4));
+        const __m256 c2 = _mm256_broadcast_ps((const __m128*)(m1.data + 8));
+        const __m256 c3 = _mm256_broadcast_ps((const __m128*)(m1.data + 12));
+
+        Mat4 out_m;
+
+        for (ui32 j = 0; j < 4; j += 2)
+        {
+            const __m256 columns = _mm256_loadu_ps(m2.data + j * 4);
+
+            __m256 result = _mm256_mul_ps(c0, _mm256_permute_ps(columns, 0x00));
+            result = _mm256_fmadd_ps(c1, _mm256_permute_ps(columns, 0x55), result);
+            result = _mm256_fmadd_ps(c2, _mm256_permute_ps(columns, 0xAA), result);
+            result = _mm256_fmadd_ps(c3, _mm256_permute_ps(columns, 0xFF), result);
+
+            _mm256_storeu_ps(out_m.data + j * 4, result);
+        }
+
+        return out_m;
+    }
+
+    HIT_TARGET_AVX2 static Vec4 vec4_mult_mat4_avx2(const Vec4& v, const Mat4& m)
+    {
+        __m128 result = _mm_mul_ps(_mm_loadu_ps(m.data), _mm_set1_ps(v.x));
+        result = _mm_fmadd_ps(_mm_loadu_ps(m.data + 4), _mm_set1_ps(v.y), result);
+        result = _mm_fmadd_ps(_mm_loadu_ps(m.data + 8), _mm_set1_ps(v.z), result);
+        result = _mm_fmadd_ps(_mm_loadu_ps(m.data + 12), _mm_set1_ps(v.w), result);
+
+        Vec4 out_v;
+        _mm_storeu_ps(out_v.elements, result);
+
+        return out_v;
+    }
+
+    HIT_TARGET_SSE41 static void transform_points_sse41(const Mat4& m, const f32* xs, const f32* ys, const f32* zs, f32* out_xs, f32* out_ys, f32* out_zs, ui64 count)
+    {
+        // x, y and z of each column
+        __m128 elements[12];
+        for (ui32 i = 0; i < 12; i++) elements[i] = _mm_set1_ps(m.data[(i / 3) * 4 + i % 3]);
+
+        ui64 i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(xs + i);
+            const __m128 y = _mm_loadu_ps(ys + i);
+            const __m128 z = _mm_loadu_ps(zs + i);
+
+            _mm_storeu_ps(out_xs + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, elements[0]), _mm_mul_ps(y, elements[3])), _mm_mul_ps(z, elements[6])), elements[9]));
+            _mm_storeu_ps(out_ys + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, elements[1]), _mm_mul_ps(y, elements[4])), _mm_mul_ps(z, elements[7])), elements[10]));
+            _mm_storeu_ps(out_zs + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, elements[2]), _mm_mul_ps(y, elements[5])), _mm_mul_ps(z, elements[8])), elements[11]));
+        }
+
+        transform_points_scalar(m, xs + i, ys + i, zs + i, out_xs + i, out_ys + i, out_zs + i, count - i);
+    }
+
+    HIT_TARGET_SSE41 static void mat4_mul_batch_sse41(const Mat4* m1, const Mat4* m2, Mat4* out_m, ui64 count)
+    {
+        for (ui64 i = 0; i < count; i++) out_m[i] = mat4_mul_sse41(m1[i], m2[i]);
+    }
+
+    HIT_TARGET_AVX2 static inline void transform_points_avx2_step(const __m256* elements, __m256 x, __m256 y, __m256 z, __m256& out_x, __m256& out_y, __m256& out_z)
+    {
+        out_x = _mm256_fmadd_ps(z, elements[6], _mm256_fmadd_ps(y, elements[3], _mm256_fmadd_ps(x, elements[0], elements[9])));
+        out_y = _mm256_fmadd_ps(z, elements[7], _mm256_fmadd_ps(y, elements[4], _mm256_fmadd_ps(x, elements[1], elements[10])));
+        out_z = _mm256_fmadd_ps(z, elements[8], _mm256_fmadd_ps(y, elements[5], _mm256_fmadd_ps(x, elements[2], elements[11])));
+    }
+
+    // eight points per step, the last ones go through masked loads and stores
+    HIT_TARGET_AVX2 static void transform_points_avx2(const Mat4& m, const f32* xs, const f32* ys, const f32* zs, f32* out_xs, f32* out_ys, f32* out_zs, ui64 count)
+    {
+        // x, y and z of each column
+        __m256 elements[12];
+        for (ui32 i = 0; i < 12; i++) elements[i] = _mm256_set1_ps(m.data[(i / 3) * 4 + i % 3]);
+
+        __m256 out_x, out_y, out_z;
+
+        ui64 i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            transform_points_avx2_step(elements, _mm256_loadu_ps(xs + i), _mm256_loadu_ps(ys + i), _mm256_loadu_ps(zs + i), out_x, out_y, out_z);
+
+            _mm256_storeu_ps(out_xs + i, out_x);
+            _mm256_storeu_ps(out_ys + i, out_y);
+            _mm256_storeu_ps(out_zs + i, out_z);
+        }
+
+        if (i == count) return;
+
+        // lanes below the remaining count are all ones
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32((i32)(count - i)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+        transform_points_avx2_step(elements, _mm256_maskload_ps(xs + i, mask), _mm256_maskload_ps(ys + i, mask), _mm256_maskload_ps(zs + i, mask), out_x, out_y, out_z);
+
+        _mm256_maskstore_ps(out_xs + i, mask, out_x);
+        _mm256_maskstore_ps(out_ys + i, mask, out_y);
+        _mm256_maskstore_ps(out_zs + i, mask, out_z);
+    }
+
+    HIT_TARGET_AVX2 static void mat4_mul_batch_avx2(const Mat4* m1, const Mat4* m2, Mat4* out_m, ui64 count)
+    {
+        for (ui64 i = 0; i < count; i++) out_m[i] = mat4_mul_avx2(m1[i], m2[i]);
+    }
+#endif
+
+    struct Mat4Kernels
+    {
+        Mat4 (*mul)(const Mat4& m1, const Mat4& m2);
+        Mat4 (*transposed)(const Mat4& m);
+        Mat4 (*inverse)(const Mat4& m);
+        Mat4 (*affine_inverse)(const Mat4& m);
+
+        Vec4 (*mult_vec4)(const Mat4& m, const Vec4& v);
+        Vec4 (*vec4_mult)(const Vec4& v, const Mat4& m);
+
+        void (*transform_points)(const Mat4& m, const f32* xs, const f32* ys, const f32* zs, f32* out_xs, f32* out_ys, f32* out_zs, ui64 count);
+        void (*mul_batch)(const Mat4* m1, const Mat4* m2, Mat4* out_m, ui64 count);
+    };
+
+    static constexpr Mat4Kernels s_mat4_scalar_kernels =
+    {
+        mat4_mul_scalar, mat4_transposed_scalar, mat4_inverse_scalar, mat4_affine_inverse_scalar,
+        mat4_mult_vec4_scalar, vec4_mult_mat4_scalar,
+        transform_points_scalar, mat4_mul_batch_scalar
+    };
+
+    // indexed by SimdLevel, 4 wide kernels don't gain from avx2 so it shares the sse4.1 ones
+    static constexpr Mat4Kernels s_mat4_kernels[(ui32)SimdLevel::Count] =
+    {
+        s_mat4_scalar_kernels,
+#ifdef HIT_SIMD_X64
+        {
+            mat4_mul_sse41, mat4_transposed_sse41, mat4_inverse_sse41, mat4_affine_inverse_sse41,
+            mat4_mult_vec4_sse41, vec4_mult_mat4_sse41,
+            transform_points_sse41, mat4_mul_batch_sse41
+        },
+        {
+            mat4_mul_avx2, mat4_transposed_sse41, mat4_inverse_sse41, mat4_affine_inverse_sse41,
+            mat4_mult_vec4_sse41, vec4_mult_mat4_avx2,
+            transform_points_avx2, mat4_mul_batch_avx2
+        },
+#else
+        s_mat4_scalar_kernels,
+        s_mat4_scalar_kernels,
+#endif
+    };
+
+    static inline const Mat4Kernels& get_mat4_kernels()
+    {
+        return s_mat4_kernels[(ui32)get_simd_level()];
+    }
+
+    Mat4& Mat4::add(const Mat4& other)
+    {
         for (ui32 i = 0; i < 4; i++)
         {
             for (ui32 j = 0; j < 4; j++)
             {
-                out_m[j][i] = m1[j][i] + m2[j][i];
+                columns[j][i] += other[j][i];
             }
         }
 
-        return out_m;
+        return *this;
     }
 
-    Mat4 mat4_sub(const Mat4& m1, const Mat4& m2)
+    Mat4& Mat4::sub(const Mat4& other)
+    {
+        for (ui32 i = 0; i < 4; i++)
+        {
+            for (ui32 j = 0; j < 4; j++)
+            {
+                columns[j][i] -= other[j][i];
+            }
+        }
+
+        return *this;
+    }
+
+    Mat4& Mat4::mul(const Mat4& other)
+    {
+        *this = get_mat4_kernels().mul(*this, other);
+        return *this;
+    }
+
+    Mat4& Mat4::mul(f32 scalar)
+    {
+        for (ui32 i = 0; i < 16; i++) data[i] *= scalar;
+        return *this;
+    }
+
+    Mat4& Mat4::div(f32 scalar)
+    {
+        for (ui32 i = 0; i < 16; i++) data[i] /= scalar;
+        return *this;
+    }
+
+    Mat4& Mat4::operator+=(const Mat4& other)
+    {
+        return add(other);
+    }
+
+    Mat4& Mat4::operator-=(const Mat4& other)
+    {
+        return sub(other);
+    }
+
+    Mat4& Mat4::operator*=(const Mat4& other)
+    {
+        return mul(other);
+    }
+
+    Mat4& Mat4::operator*=(f32 scalar)
+    {
+        return mul(scalar);
+    }
+
+    Mat4& Mat4::operator/=(f32 scalar)
+    {
+        return div(scalar);
+    }
+
+    Mat4 Mat4::transposed() const
+    {
+        return get_mat4_kernels().transposed(*this);
+    }
+
+    Mat4 Mat4::inverse() const
+    {
+        return get_mat4_kernels().inverse(*this);
+    }
+
+    Mat4 Mat4::affine_inverse() const
+    {
+        return get_mat4_kernels().affine_inverse(*this);
+    }
+
+    // mat4 functions
+    Mat4 mat4_add(const Mat4& m1, const Mat4& m2)
     {
         Mat4 out_m;
 
@@ -264,14 +709,14 @@ namespace hit
         {
             for (ui32 j = 0; j < 4; j++)
             {
-                out_m[j][i] = m1[j][i] - m2[j][i];
+                out_m[j][i] = m1[j][i] + m2[j][i];
             }
         }
 
         return out_m;
     }
 
-    Mat4 mat4_mul(const Mat4& m1, const Mat4& m2)
+    Mat4 mat4_sub(const Mat4& m1, const Mat4& m2)
     {
         Mat4 out_m;
 
@@ -279,17 +724,18 @@ namespace hit
         {
             for (ui32 j = 0; j < 4; j++)
             {
-                out_m[j][i] = 
-                    m1[0][i] * m2[j][0] +
-                    m1[1][i] * m2[j][1] +
-                    m1[2][i] * m2[j][2] +
-                    m1[3][i] * m2[j][3];
+                out_m[j][i] = m1[j][i] - m2[j][i];
             }
         }
 
         return out_m;
     }
 
+    Mat4 mat4_mul(const Mat4& m1, const Mat4& m2)
+    {
+        return get_mat4_kernels().mul(m1, m2);
+    }
+
     Mat4 mat4_mul(const Mat4& m1, f32 scalar)
     {
         Mat4 out_mat = m1;
@@ -306,22 +752,12 @@ namespace hit
 
     Vec4 mat4_mult_vec4(const Mat4& m, const Vec4& v)
     {
-        return {
-            v.x * m.data[0]  + v.y * m.data[1]  + v.z * m.data[2]  + v.w * m.data[3],
-            v.x * m.data[4]  + v.y * m.data[5]  + v.z * m.data[6]  + v.w * m.data[7],
-            v.x * m.data[8]  + v.y * m.data[9]  + v.z * m.data[10] + v.w * m.data[11],
-            v.x * m.data[12] + v.y * m.data[13] + v.z * m.data[14] + v.w * m.data[15]
-        };
+        return get_mat4_kernels().mult_vec4(m, v);
     }
 
     Vec4 mat4_mult_vec4(const Vec4& v, const Mat4& m)
     {
-        return {
-            v.x * m.data[0] + v.y * m.data[4] + v.z * m.data[8]  + v.w * m.data[12],
-            v.x * m.data[1] + v.y * m.data[5] + v.z * m.data[9]  + v.w * m.data[13],
-            v.x * m.data[2] + v.y * m.data[6] + v.z * m.data[10] + v.w * m.data[14],
-            v.x * m.data[3] + v.y * m.data[7] + v.z * m.data[11] + v.w * m.data[15]
-        };
+        return get_mat4_kernels().vec4_mult(v, m);
     }
 
     Vec3 mat4_mult_vec3(const Mat4& m, const Vec3& v)
@@ -335,13 +771,29 @@ namespace hit
 
     Vec3 mat4_mult_vec3(const Vec3& v, const Mat4& m)
     {
+        // a point, w is 1
         return {
-            v.x * m.data[0] + v.y * m.data[4] + v.z * m.data[8]  + v.w * m.data[12],
-            v.x * m.data[1] + v.y * m.data[5] + v.z * m.data[9]  + v.w * m.data[13],
-            v.x * m.data[2] + v.y * m.data[6] + v.z * m.data[10] + v.w * m.data[14]
+            v.x * m.data[0] + v.y * m.data[4] + v.z * m.data[8]  + m.data[12],
+            v.x * m.data[1] + v.y * m.data[5] + v.z * m.data[9]  + m.data[13],
+            v.x * m.data[2] + v.y * m.data[6] + v.z * m.data[10] + m.data[14]
         };
     }
 
+    void transform_points(const Mat4& m, std::span<const f32> xs, std::span<const f32> ys, std::span<const f32> zs, std::span<f32> out_xs, std::span<f32> out_ys, std::span<f32> out_zs)
+    {
+        const ui64 count = xs.size();
+        hit_assert(ys.size() == count && zs.size() == count && out_xs.size() == count && out_ys.size() == count && out_zs.size() == count, "Point arrays must have the same size!");
+
+        get_mat4_kernels().transform_points(m, xs.data(), ys.data(), zs.data(), out_xs.data(), out_ys.data(), out_zs.data(), count);
+    }
+
+    void mat4_mul_batch(std::span<const Mat4> m1, std::span<const Mat4> m2, std::span<Mat4> out_m)
+    {
+        hit_assert(m1.size() == m2.size() && out_m.size() == m1.size(), "Matrix arrays must have the same size!");
+
+        get_mat4_kernels().mul_batch(m1.data(), m2.data(), out_m.data(), m1.size());
+    }
+
     Mat4 mat4_orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 near, f32 far)
     {
         // Using Left-handed coordinate system, with depth range from 0 to 1
@@ -2,204 +2,1656 @@
 #include "Core/Assert.h"
 #include "Core/Log.h"
 
-#include <unordered_map>
+#include <atomic>
+#include <array>
+#include <mutex>
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <fstream>
+#include <new>
 #include <string.h>
+#include <unordered_map>
+
+#ifdef HIT_PLATFORM_WINDOWS
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define HIT_HAS_EXECINFO
+#endif
+#endif
 
 namespace hit::Memory
 {
+    // every allocation is prefixed by its header, so usage lookups are just pointer arithmetic
+    struct alignas(16) AllocationHeader
+    {
+        ui64 size;
+        ui8 usage;
+        ui8 flags;
+        ui8 size_class;
+        ui8 offset_shift; // log2 of the distance between the block start and the memory
+        ui32 signature;
+    };
+
+    constexpr ui32 allocation_signature = 0x21544948; // "HIT!"
+
+    // the allocation was sampled by the tracing, its call site is known
+    constexpr ui8 traced_allocation_flag = 1;
+
+    static_assert(max_usage_count <= UINT8_MAX + 1, "Memory usages must fit in the allocation header!");
+
+    // small blocks(header included) are served by size class slabs, larger ones go straight to malloc
+    constexpr ui64 small_size_classes[] = { 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+    constexpr ui8 small_size_class_count = sizeof(small_size_classes) / sizeof(ui64);
+    constexpr ui64 max_small_block_size = small_size_classes[small_size_class_count - 1];
+    constexpr ui8 large_size_class = UINT8_MAX;
+
+    // over aligned blocks, optionally placed at a huge page boundary
+    constexpr ui8 aligned_size_class = UINT8_MAX - 1;
+    constexpr ui8 huge_page_size_class = UINT8_MAX - 2;
+    constexpr ui64 huge_page_size = 2 * 1024 * 1024;
+
+    constexpr ui64 slab_chunk_size = 64 * 1024;
+    constexpr ui32 thread_cache_batch = 32;
+
+    // a thread adds its live bytes to the shared peak counter once they moved this much
+    constexpr i64 peak_publish_size = 64 * 1024;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // global slabs of a size class, shared by all threads
+    struct SlabPool
+    {
+        std::mutex mutex;
+        FreeBlock* free_blocks = nullptr;
+        FreeBlock* chunks = nullptr;
+    };
+
+    struct SlabSystem
+    {
+        std::array<SlabPool, small_size_class_count> pools;
+    };
+
+    // never destroyed, slab blocks can be released by static destructors of other files and by
+    // exiting threads after it. the chunks are given back by the os
+    static SlabSystem& get_slab_system()
+    {
+        alignas(SlabSystem) static ui8 slab_system_storage[sizeof(SlabSystem)];
+        static auto slab_system = new (slab_system_storage) SlabSystem();
+        return *slab_system;
+    }
+
+    // per thread memory state: slab free lists and usage counters.
+    // counters are only written by its own thread, so updating them needs no locked instruction.
+    // it's kept trivial, so the hot path doesn't go through a tls initialization guard
+    struct ThreadMemory
+    {
+        FreeBlock* free_blocks[small_size_class_count];
+        ui32 free_count[small_size_class_count];
+
+        std::atomic<i64> memory_used[max_usage_count];
+        std::atomic<i64> allocation_count[max_usage_count];
+
+        // telemetry, totals only grow so frame counts are the difference between two frames
+        std::atomic<ui64> total_allocations[max_usage_count];
+        std::atomic<ui64> total_frees[max_usage_count];
+        std::atomic<ui64> size_histogram[max_usage_count][size_histogram_bucket_count];
+        i64 unpublished_bytes[max_usage_count];
+
+        // allocations since the last traced one
+        ui32 trace_counter;
+
+        // counted for AllocationGuard, only read by its own thread
+        ui64 reallocation_count;
+        ui64 global_new_count;
+
+        // eviction callbacks are running on this thread, allocations they make don't evict again
+        bool evicting;
+
+        bool registered;
+        bool released;
+        ThreadMemory* next;
+        ThreadMemory* previous;
+    };
+
+    thread_local ThreadMemory t_thread_memory;
+
+    // releases the thread memory state when its thread exits
+    struct ThreadMemoryReleaser
+    {
+        ~ThreadMemoryReleaser();
+    };
+
+    thread_local ThreadMemoryReleaser t_thread_memory_releaser;
+
     struct MemorySystem
     {
-        std::unordered_map<ui8*, Usage> usages;
-#ifdef HIT_DEBUG
-        std::unordered_map<Usage::Type, ui64> memory_used;
-        ui64 total_memory_used;
-#endif
+        std::mutex mutex;
+        ThreadMemory* threads = nullptr;
+
+        // counters of threads that already exited
+        i64 memory_used[max_usage_count] = { };
+        i64 allocation_count[max_usage_count] = { };
+        ui64 total_allocations[max_usage_count] = { };
+        ui64 total_frees[max_usage_count] = { };
+        ui64 size_histogram[max_usage_count][size_histogram_bucket_count] = { };
+
+        // live bytes published by the threads, the peak is taken from it
+        std::atomic<i64> published_bytes[max_usage_count] = { };
+        std::atomic<i64> peak_bytes[max_usage_count] = { };
+
+        // kept trivial, memory can be allocated by static objects before this one would be constructed
+        std::atomic<ui32> usage_count = Usage::MaxUsageCount;
+        char usage_names[max_usage_count][max_usage_name_length] = { "Any", "Handle_List", "Platform", "Renderer" };
+
+        ui64 frame = 0;
+        ui64 frame_allocation_base[max_usage_count] = { };
+        ui64 frame_free_base[max_usage_count] = { };
+        ui64 frame_allocations[max_usage_count] = { };
+        ui64 frame_frees[max_usage_count] = { };
+
+        char dump_filename[256] = { };
+        ui32 dump_frame_interval = 0;
     };
 
-    static MemorySystem* s_memory_system = nullptr;
+    static MemorySystem s_memory_system;
 
-    // TODO: at the moment this system is unsafe
-    bool initialize_memory_system()
+    struct UsageBudgetState
     {
-        s_memory_system = new MemorySystem();
+        std::atomic<bool> limited = false;
+        std::atomic<ui64> soft_limit = 0;
+        std::atomic<ui64> hard_limit = 0;
+        std::atomic<bool> soft_limit_crossed = false;
+    };
 
-#ifdef HIT_DEBUG
-        s_memory_system->total_memory_used = 0;
-        s_memory_system->memory_used[Usage::Any] = 0;
-#endif
+    struct RegisteredEvictionCallback
+    {
+        ui32 id;
+        Usage::Type usage;
+        EvictionCallback callback;
+    };
 
-        return true;
+    // only allocations of limited usages look at their budget
+    static UsageBudgetState s_usage_budgets[max_usage_count];
+
+    // never destroyed, like the trace system
+    struct EvictionSystem
+    {
+        std::mutex mutex;
+        std::vector<RegisteredEvictionCallback> callbacks;
+        ui32 next_id = 1;
+    };
+
+    static EvictionSystem& get_eviction_system()
+    {
+        static auto eviction_system = new EvictionSystem();
+        return *eviction_system;
     }
 
-    bool shutdown_memory_system()
+    static constexpr auto s_size_class_lookup = []()
     {
-        bool has_memory_leak = false;
+        std::array<ui8, max_small_block_size / 16 + 1> lookup { };
 
-        if (!s_memory_system->usages.empty())
+        ui8 size_class = 0;
+        for(ui64 i = 0; i < lookup.size(); i++)
         {
-            hit_fatal("Memory leaks encountered!");
+            while(small_size_classes[size_class] < i * 16) size_class++;
+            lookup[i] = size_class;
+        }
 
-#ifdef HIT_DEBUG
-            for(auto& [_memory, _usage] : s_memory_system->usages)
+        return lookup;
+    }();
+
+    // 0 when tracing is disabled, read on every allocation
+    static std::atomic<ui32> s_trace_sample_rate = 0;
+
+    struct AllocationSiteKey
+    {
+        std::string_view file;
+        std::string_view function;
+        ui32 line;
+        ui32 column;
+        Usage::Type usage;
+        std::array<void*, max_backtrace_depth> backtrace;
+
+        bool operator==(const AllocationSiteKey& other) const = default;
+    };
+
+    struct AllocationSiteKeyHash
+    {
+        ui64 operator()(const AllocationSiteKey& key) const
+        {
+            // the file name is hashed by contents like it's compared, the same literal isn't always pooled
+            // across translation units. the function name is left out, the line already tells them apart
+            ui64 hash = std::hash<std::string_view>()(key.file) ^ ((ui64)key.line << 32 | key.column) ^ ((ui64)key.usage << 56);
+            for(auto address : key.backtrace) hash = (hash ^ (ui64)address) * 0x100000001b3;
+
+            return hash;
+        }
+    };
+
+    struct TraceSite
+    {
+        AllocationSite site;
+        ui64 current_frame_allocations = 0;
+        ui64 current_frame_bytes = 0;
+    };
+
+    struct TracedAllocation
+    {
+        ui32 site;
+        ui32 weight;
+    };
+
+    // tables use the default heap, so tracing never goes back into the memory system
+    struct TraceSystem
+    {
+        std::mutex mutex;
+        std::unordered_map<AllocationSiteKey, ui32, AllocationSiteKeyHash> site_lookup;
+        std::vector<TraceSite> sites;
+        std::unordered_map<ui8*, TracedAllocation> allocations;
+        ui32 sample_rate = 0;
+        bool capture_backtrace = false;
+    };
+
+    // never destroyed, traced memory can be released by static destructors of other files
+    static TraceSystem& get_trace_system()
+    {
+        static auto trace_system = new TraceSystem();
+        return *trace_system;
+    }
+
+    static ui32 capture_backtrace(void** frames)
+    {
+        // this function and the tracing one are skipped
+        constexpr ui32 skipped_frames = 2;
+
+#ifdef HIT_PLATFORM_WINDOWS
+        return (ui32)CaptureStackBackTrace(skipped_frames, max_backtrace_depth, frames, nullptr);
+#elif defined(HIT_HAS_EXECINFO)
+        void* all_frames[max_backtrace_depth + skipped_frames];
+        const i32 depth = backtrace(all_frames, max_backtrace_depth + skipped_frames);
+        if(depth <= (i32)skipped_frames) return 0;
+
+        std::copy(all_frames + skipped_frames, all_frames + depth, frames);
+        return (ui32)depth - skipped_frames;
+#else
+        return 0;
+#endif
+    }
+
+    static FreeBlock* slab_acquire_batch(ui8 size_class, ui32& out_count)
+    {
+        auto& pool = get_slab_system().pools[size_class];
+        std::lock_guard lock(pool.mutex);
+
+        if(!pool.free_blocks)
+        {
+            // chunks are chained by its first block, so they can be released at exit
+            auto chunk = (FreeBlock*)std::malloc(slab_chunk_size);
+            if(!chunk)
             {
-                hit_trace("{}", _usage);
+                out_count = 0;
+                return nullptr;
             }
-#endif
 
-            has_memory_leak = true;
+            chunk->next = pool.chunks;
+            pool.chunks = chunk;
+
+            const ui64 block_size = small_size_classes[size_class];
+            for(ui64 offset = 16; offset + block_size <= slab_chunk_size; offset += block_size)
+            {
+                auto block = (FreeBlock*)((ui8*)chunk + offset);
+                block->next = pool.free_blocks;
+                pool.free_blocks = block;
+            }
         }
 
-        delete s_memory_system;
-        s_memory_system = nullptr;
+        FreeBlock* batch = pool.free_blocks;
+        FreeBlock* last = batch;
 
-        return !has_memory_leak;
+        out_count = 1;
+        while(last->next && out_count < thread_cache_batch)
+        {
+            last = last->next;
+            out_count++;
+        }
+
+        pool.free_blocks = last->next;
+        last->next = nullptr;
+
+        return batch;
     }
 
-    ui8* allocate_memory(ui64 size, Usage::Type usage)
+    static void slab_release_batch(ui8 size_class, FreeBlock* first, FreeBlock* last)
     {
-        Usage memory_usage;
-        memory_usage.usage = usage;
-        memory_usage.size = size;
+        auto& pool = get_slab_system().pools[size_class];
+        std::lock_guard lock(pool.mutex);
 
-        ui8* out_memory = (ui8*)::operator new(size);
-        hit_assert(out_memory, "Failed to allocate {} bytes!", size);
+        last->next = pool.free_blocks;
+        pool.free_blocks = first;
+    }
 
-        memory_usage.memory = out_memory;
+    static void register_thread_memory()
+    {
+        auto& thread_memory = t_thread_memory;
 
-        s_memory_system->usages[out_memory] = memory_usage;
+        // make sure this thread memory is released at thread exit
+        (void)&t_thread_memory_releaser;
 
-#ifdef HIT_DEBUG
-        s_memory_system->memory_used[usage] += size;
-        s_memory_system->total_memory_used += size;
-#endif
+        std::lock_guard lock(s_memory_system.mutex);
 
-        std::memset(out_memory, 0, size);
+        thread_memory.previous = nullptr;
+        thread_memory.next = s_memory_system.threads;
+        if(thread_memory.next) thread_memory.next->previous = &thread_memory;
 
-        return out_memory;
+        s_memory_system.threads = &thread_memory;
+        thread_memory.registered = true;
     }
 
-    void deallocate_memory(ui8* memory)
+    ThreadMemoryReleaser::~ThreadMemoryReleaser()
     {
-        if(!memory)
+        auto& thread_memory = t_thread_memory;
+
+        for(ui8 size_class = 0; size_class < small_size_class_count; size_class++)
         {
-            hit_warning("Attempting to deallocate an invalid memory!");
-            return;
+            if(!thread_memory.free_blocks[size_class]) continue;
+
+            FreeBlock* last = thread_memory.free_blocks[size_class];
+            while(last->next) last = last->next;
+
+            slab_release_batch(size_class, thread_memory.free_blocks[size_class], last);
+            thread_memory.free_blocks[size_class] = nullptr;
+            thread_memory.free_count[size_class] = 0;
         }
 
-        // find memory usage
-        auto memory_usage_location = s_memory_system->usages.find(memory);
-        hit_assert(
-            memory_usage_location != s_memory_system->usages.end(), 
-            "Attempting to deallocate a not registered memory!");
+        if(!thread_memory.registered) return;
 
-#ifdef HIT_DEBUG
-        // update debug variables
-        auto& usage = memory_usage_location->second;
-        s_memory_system->total_memory_used -= usage.size;
-        s_memory_system->memory_used[usage.usage] -= usage.size;
+        std::lock_guard lock(s_memory_system.mutex);
+
+        for(ui32 i = 0; i < max_usage_count; i++)
+        {
+            s_memory_system.memory_used[i] += thread_memory.memory_used[i].load(std::memory_order_relaxed);
+            s_memory_system.allocation_count[i] += thread_memory.allocation_count[i].load(std::memory_order_relaxed);
+            s_memory_system.total_allocations[i] += thread_memory.total_allocations[i].load(std::memory_order_relaxed);
+            s_memory_system.total_frees[i] += thread_memory.total_frees[i].load(std::memory_order_relaxed);
+
+            for(ui32 bucket = 0; bucket < size_histogram_bucket_count; bucket++)
+            {
+                s_memory_system.size_histogram[i][bucket] += thread_memory.size_histogram[i][bucket].load(std::memory_order_relaxed);
+            }
+
+            s_memory_system.published_bytes[i].fetch_add(thread_memory.unpublished_bytes[i], std::memory_order_relaxed);
+            thread_memory.unpublished_bytes[i] = 0;
+        }
+
+        if(thread_memory.previous) thread_memory.previous->next = thread_memory.next;
+        else s_memory_system.threads = thread_memory.next;
+
+        if(thread_memory.next) thread_memory.next->previous = thread_memory.previous;
+
+        thread_memory.registered = false;
+
+        // other thread local destructors may still use memory after this one
+        thread_memory.released = true;
+    }
+
+    static AllocationHeader* allocate_aligned_block(ui64 size, ui64 alignment, bool huge_pages)
+    {
+        // the memory sits at the alignment offset, so the header fits right before it.
+        // aligning to huge pages is only worth its padding where madvise can back the block with them
+#ifdef MADV_HUGEPAGE
+        const ui64 block_alignment = huge_pages ? std::max(alignment, huge_page_size) : alignment;
+#else
+        const ui64 block_alignment = alignment;
+#endif
+        const ui64 block_size = (alignment + size + block_alignment - 1) & ~(block_alignment - 1);
+
+#ifdef HIT_PLATFORM_WINDOWS
+        auto block = (ui8*)_aligned_malloc(block_size, block_alignment);
+#else
+        auto block = (ui8*)std::aligned_alloc(block_alignment, block_size);
 #endif
+        if(!block) return nullptr;
 
-        s_memory_system->usages.erase(memory_usage_location);
+#ifdef MADV_HUGEPAGE
+        if(huge_pages) madvise(block, block_size, MADV_HUGEPAGE);
+#endif
+
+        auto header = (AllocationHeader*)(block + alignment) - 1;
+        header->size_class = huge_pages ? huge_page_size_class : aligned_size_class;
+        header->offset_shift = (ui8)std::countr_zero(alignment);
 
-        ::operator delete(memory);
+        return header;
     }
 
-    ui8* reallocate_memory(ui8* memory, ui64 new_size)
+    static AllocationHeader* allocate_block(ui64 size, const AllocationOptions& options)
     {
-        if(!memory || !new_size)
+        const ui64 block_size = sizeof(AllocationHeader) + size;
+        const ui64 alignment = std::max(options.alignment, default_alignment);
+        const bool huge_pages = options.huge_pages && size >= huge_page_size;
+
+        if(alignment > default_alignment || huge_pages) [[unlikely]]
         {
-            hit_warning_if(!memory, "Attempting to reallocate an invalid memory!");
-            hit_warning_if(!new_size, "Attempting to reallocate to a 0 size!");
-            return nullptr;
+            auto header = allocate_aligned_block(size, alignment, huge_pages);
+            if(header && options.zeroed) std::memset(header + 1, 0, size);
+
+            return header;
         }
 
-        // find memory usage
-        auto memory_usage_location = s_memory_system->usages.find(memory);
-        hit_assert(
-            memory_usage_location != s_memory_system->usages.end(), 
-            "Attempting to reallocate a not registered memory!");
-        
-        auto usage = memory_usage_location->second;
-        
-        if(new_size == usage.size)
+        if(block_size > max_small_block_size)
         {
-            hit_warning("Attempting to reallocate a memory to the same size!");
-            return memory;
+            // calloc hands big blocks straight from fresh os pages, so they are not touched twice
+            auto header = (AllocationHeader*)(options.zeroed ? std::calloc(1, block_size) : std::malloc(block_size));
+            if(header)
+            {
+                header->size_class = large_size_class;
+                header->offset_shift = 0;
+            }
+
+            return header;
         }
 
-#ifdef HIT_DEBUG
-        // update debug variables
-        if(new_size > usage.size)
+        const ui8 size_class = s_size_class_lookup[(block_size + 15) / 16];
+        auto& cache = t_thread_memory;
+
+        if(!cache.free_blocks[size_class]) [[unlikely]]
         {
-            s_memory_system->total_memory_used += new_size - usage.size;
-            s_memory_system->memory_used[usage.usage] += new_size - usage.size;
+            cache.free_blocks[size_class] = slab_acquire_batch(size_class, cache.free_count[size_class]);
+            if(!cache.free_blocks[size_class]) return nullptr;
         }
-        else if(new_size < usage.size)
+
+        auto block = cache.free_blocks[size_class];
+        cache.free_blocks[size_class] = block->next;
+        cache.free_count[size_class]--;
+
+        auto header = (AllocationHeader*)block;
+        header->size_class = size_class;
+        header->offset_shift = 0;
+
+        if(options.zeroed) std::memset(header + 1, 0, size);
+
+        return header;
+    }
+
+    static void deallocate_block(AllocationHeader* header)
+    {
+        const ui8 size_class = header->size_class;
+
+        if(size_class == large_size_class)
         {
-            s_memory_system->total_memory_used -= usage.size - new_size;
-            s_memory_system->memory_used[usage.usage] -= usage.size - new_size;
+            std::free(header);
+            return;
         }
+
+        if(size_class == aligned_size_class || size_class == huge_page_size_class)
+        {
+            auto block = (ui8*)(header + 1) - ((ui64)1 << header->offset_shift);
+
+#ifdef HIT_PLATFORM_WINDOWS
+            _aligned_free(block);
+#else
+            std::free(block);
 #endif
+            return;
+        }
 
-        ui8* out_memory = (ui8*)std::realloc(memory, new_size);
-        if(!out_memory)
+        auto& cache = t_thread_memory;
+
+        auto block = (FreeBlock*)header;
+
+        if(cache.released) [[unlikely]]
         {
-            hit_error("Failed to reallocate memory {}.", (void*)memory);
-            return nullptr;
+            slab_release_batch(size_class, block, block);
+            return;
         }
 
-        s_memory_system->usages.erase(memory_usage_location);
-        s_memory_system->usages[out_memory] = { usage.usage, new_size, out_memory };
+        block->next = cache.free_blocks[size_class];
+        cache.free_blocks[size_class] = block;
+        cache.free_count[size_class]++;
+
+        // give a batch back to the global pool, so a thread that just frees memory doesn't hoard it
+        if(cache.free_count[size_class] >= thread_cache_batch * 2)
+        {
+            FreeBlock* first = cache.free_blocks[size_class];
+            FreeBlock* last = first;
+            for(ui32 i = 1; i < thread_cache_batch; i++) last = last->next;
+
+            cache.free_blocks[size_class] = last->next;
+            cache.free_count[size_class] -= thread_cache_batch;
 
-        return out_memory;
+            slab_release_batch(size_class, first, last);
+        }
     }
 
-    ui8* copy_memory(ui8* dst, const ui8* src, ui64 copy_size)
+    static AllocationHeader* reallocate_block(AllocationHeader* header, ui64 new_size)
     {
-        if(!dst || !src || !copy_size)
+        const ui64 new_block_size = sizeof(AllocationHeader) + new_size;
+
+        if(header->size_class == large_size_class)
         {
-            hit_warning_if(!dst, "Attempting to copy memory to an invalid destination!");
-            hit_warning_if(!src, "Attempting to copy memory from an invalid source!");
-            hit_warning_if(!copy_size, "Attempting to copy 0 memory!");
-            return nullptr;
+            if(new_block_size > max_small_block_size)
+            {
+                return (AllocationHeader*)std::realloc(header, new_block_size);
+            }
+        }
+        else if(header->size_class < small_size_class_count && new_block_size <= small_size_classes[header->size_class])
+        {
+            // still fits in the same slab block
+            return header;
         }
 
-        return (ui8*)std::memcpy(dst, src, copy_size);
+        // moved blocks keep the alignment and hints they were allocated with
+        AllocationOptions options = uninitialized_allocation;
+        options.alignment = std::max((ui32)1 << header->offset_shift, default_alignment);
+        options.huge_pages = header->size_class == huge_page_size_class;
+
+        auto new_header = allocate_block(new_size, options);
+        if(!new_header) return nullptr;
+
+        const ui8 size_class = new_header->size_class;
+        const ui8 offset_shift = new_header->offset_shift;
+
+        std::memcpy(new_header, header, sizeof(AllocationHeader) + std::min(header->size, new_size));
+        new_header->size_class = size_class;
+        new_header->offset_shift = offset_shift;
+
+        header->signature = 0;
+        deallocate_block(header);
+
+        return new_header;
     }
 
-    ui8* set_memory(ui8* memory, i32 value, ui64 size)
+    static inline AllocationHeader* get_header(ui8* memory)
     {
-        if(!memory)
+        return (AllocationHeader*)memory - 1;
+    }
+
+    static void trace_allocation(ui8* memory, AllocationHeader* header, const std::source_location& location)
+    {
+        auto& trace_system = get_trace_system();
+
+        AllocationSiteKey key = { location.file_name(), location.function_name(), location.line(), location.column(),
+            (Usage::Type)header->usage, { } };
+
+        // captured out of the lock, it's the slow part
+        ui32 backtrace_depth = 0;
+        if(trace_system.capture_backtrace) backtrace_depth = capture_backtrace(key.backtrace.data());
+
+        std::lock_guard lock(trace_system.mutex);
+
+        // tracing was disabled meanwhile
+        const ui32 weight = trace_system.sample_rate;
+        if(!weight) return;
+
+        auto [site_iterator, inserted] = trace_system.site_lookup.try_emplace(key, (ui32)trace_system.sites.size());
+        if(inserted)
         {
-            hit_warning("Attempting to setup an invalid memory!");
-            return nullptr;
+            auto& site = trace_system.sites.emplace_back().site;
+            site.location = location;
+            site.usage = key.usage;
+            site.backtrace_depth = backtrace_depth;
+            std::copy_n(key.backtrace.data(), backtrace_depth, site.backtrace);
         }
 
-        std::memset(memory, value, size);
+        auto& trace_site = trace_system.sites[site_iterator->second];
+        trace_site.site.total_allocations += weight;
+        trace_site.site.total_bytes += header->size * weight;
+        trace_site.site.live_allocations += weight;
+        trace_site.site.live_bytes += header->size * weight;
+        trace_site.current_frame_allocations += weight;
+        trace_site.current_frame_bytes += header->size * weight;
 
-        return memory;
+        trace_system.allocations[memory] = { site_iterator->second, weight };
+        header->flags |= traced_allocation_flag;
     }
 
-    Usage get_usage(ui8* memory)
+    static inline void sample_allocation(ui8* memory, AllocationHeader* header, ui32 sample_rate, const std::source_location& location)
     {
-        auto memory_usage_location = s_memory_system->usages.find(memory);
-        hit_assert(
-            memory_usage_location != s_memory_system->usages.end(), 
-            "Attempting to get the usage of a not registered memory!");
-        
-        return memory_usage_location->second;
+        auto& thread_memory = t_thread_memory;
+        if(++thread_memory.trace_counter < sample_rate) return;
+
+        thread_memory.trace_counter = 0;
+        trace_allocation(memory, header, location);
     }
 
-    bool has_memory(ui8* memory)
+    // a freed allocation has new_memory set to null
+    static void retrace_allocation(ui8* memory, ui8* new_memory, ui64 size, ui64 new_size)
+    {
+        auto& trace_system = get_trace_system();
+        std::lock_guard lock(trace_system.mutex);
+
+        // traced before tracing was enabled again
+        auto allocation_iterator = trace_system.allocations.find(memory);
+        if(allocation_iterator == trace_system.allocations.end()) return;
+
+        const auto allocation = allocation_iterator->second;
+        auto& site = trace_system.sites[allocation.site].site;
+
+        site.live_bytes = site.live_bytes - size * allocation.weight + new_size * allocation.weight;
+
+        if(!new_memory)
+        {
+            site.live_allocations -= allocation.weight;
+            trace_system.allocations.erase(allocation_iterator);
+            return;
+        }
+
+        if(new_memory != memory)
+        {
+            trace_system.allocations.erase(allocation_iterator);
+            trace_system.allocations[new_memory] = allocation;
+        }
+    }
+
+    static void end_trace_frame()
+    {
+        auto& trace_system = get_trace_system();
+        std::lock_guard lock(trace_system.mutex);
+
+        for(auto& trace_site : trace_system.sites)
+        {
+            trace_site.site.frame_allocations = trace_site.current_frame_allocations;
+            trace_site.site.frame_bytes = trace_site.current_frame_bytes;
+            trace_site.current_frame_allocations = 0;
+            trace_site.current_frame_bytes = 0;
+        }
+    }
+
+    static std::string format_site_location(const AllocationSite& site)
+    {
+        return std::format("{} {}:{}", site.location.function_name(), site.location.file_name(), site.location.line());
+    }
+
+    static inline ui32 get_size_histogram_bucket(ui64 size)
+    {
+        const ui32 bucket = size > 16 ? (ui32)std::bit_width((size - 1) >> 4) : 0;
+        return std::min(bucket, size_histogram_bucket_count - 1);
+    }
+
+    template<typename T>
+    static inline void add_thread_counter(std::atomic<T>& counter, T value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static void update_peak_bytes(Usage::Type usage, i64 live_bytes)
     {
-        auto memory_usage_location = s_memory_system->usages.find(memory);
-        return memory_usage_location != s_memory_system->usages.end();
+        auto& peak_bytes = s_memory_system.peak_bytes[usage];
+
+        i64 peak = peak_bytes.load(std::memory_order_relaxed);
+        while(live_bytes > peak && !peak_bytes.compare_exchange_weak(peak, live_bytes, std::memory_order_relaxed));
+    }
+
+    static void publish_bytes(Usage::Type usage, i64 size)
+    {
+        const i64 live_bytes = s_memory_system.published_bytes[usage].fetch_add(size, std::memory_order_relaxed) + size;
+        if(size > 0) update_peak_bytes(usage, live_bytes);
     }
 
-    Usage allocate_usage(ui64 size, Usage::Type usage)
+    // allocations are given with a positive count and frees with a negative one, resizes only move the size
+    static inline void track_memory(Usage::Type usage, i64 size, i64 count, bool count_size = false)
     {
-        auto memory = allocate_memory(size, usage);
-        return s_memory_system->usages[memory];
+        auto& thread_memory = t_thread_memory;
+
+        if(!thread_memory.registered) [[unlikely]]
+        {
+            if(thread_memory.released)
+            {
+                // thread is exiting, account straight to the global counters
+                std::lock_guard lock(s_memory_system.mutex);
+                s_memory_system.memory_used[usage] += size;
+                s_memory_system.allocation_count[usage] += count;
+
+                if(count > 0) s_memory_system.total_allocations[usage] += count;
+                if(count < 0) s_memory_system.total_frees[usage] += -count;
+                if(count_size) s_memory_system.size_histogram[usage][get_size_histogram_bucket(size)]++;
+
+                publish_bytes(usage, size);
+                return;
+            }
+
+            register_thread_memory();
+        }
+
+        add_thread_counter(thread_memory.memory_used[usage], size);
+        add_thread_counter(thread_memory.allocation_count[usage], count);
+
+        if(count > 0) add_thread_counter(thread_memory.total_allocations[usage], (ui64)count);
+        if(count < 0) add_thread_counter(thread_memory.total_frees[usage], (ui64)-count);
+        if(count_size) add_thread_counter(thread_memory.size_histogram[usage][get_size_histogram_bucket(size)], (ui64)1);
+
+        auto& unpublished_bytes = thread_memory.unpublished_bytes[usage];
+        unpublished_bytes += size;
+
+        if(unpublished_bytes >= peak_publish_size || unpublished_bytes <= -peak_publish_size) [[unlikely]]
+        {
+            publish_bytes(usage, unpublished_bytes);
+            unpublished_bytes = 0;
+        }
+    }
+
+    // a thread counter can go negative when memory is released by another thread, only the sum matters
+    static i64 sum_allocation_count(Usage::Type usage)
+    {
+        std::lock_guard lock(s_memory_system.mutex);
+
+        i64 count = s_memory_system.allocation_count[usage];
+        for(auto thread_memory = s_memory_system.threads; thread_memory; thread_memory = thread_memory->next)
+        {
+            count += thread_memory->allocation_count[usage].load(std::memory_order_relaxed);
+        }
+
+        return count;
+    }
+
+    static void evict_usage(Usage::Type usage, ui64 excess_bytes)
+    {
+        auto& thread_memory = t_thread_memory;
+        if(thread_memory.evicting) return;
+
+        // copied, so callbacks can be added or removed by a callback
+        std::vector<EvictionCallback> callbacks;
+        {
+            auto& eviction_system = get_eviction_system();
+            std::lock_guard lock(eviction_system.mutex);
+
+            for(const auto& registered : eviction_system.callbacks)
+            {
+                if(registered.usage == usage) callbacks.push_back(registered.callback);
+            }
+        }
+
+        thread_memory.evicting = true;
+        for(const auto& callback : callbacks) callback(usage, excess_bytes);
+        thread_memory.evicting = false;
+    }
+
+    // returns false when size bytes more don't fit in the hard limit, even after evicting
+    static bool check_usage_budget(Usage::Type usage, ui64 size)
+    {
+        auto& budget = s_usage_budgets[usage];
+        const i64 soft_limit = (i64)budget.soft_limit.load(std::memory_order_relaxed);
+        const i64 hard_limit = (i64)budget.hard_limit.load(std::memory_order_relaxed);
+
+        // the published bytes of other threads are enough to know if a limit is close
+        i64 live_bytes = s_memory_system.published_bytes[usage].load(std::memory_order_relaxed) +
+            t_thread_memory.unpublished_bytes[usage] + (i64)size;
+
+        if(soft_limit)
+        {
+            if(live_bytes <= soft_limit)
+            {
+                if(budget.soft_limit_crossed.load(std::memory_order_relaxed))
+                {
+                    budget.soft_limit_crossed.store(false, std::memory_order_relaxed);
+                }
+            }
+            else if(!budget.soft_limit_crossed.exchange(true, std::memory_order_relaxed))
+            {
+                evict_usage(usage, (ui64)(live_bytes - soft_limit));
+                live_bytes = (i64)get_memory_used(usage) + (i64)size;
+            }
+        }
+
+        if(!hard_limit || live_bytes <= hard_limit) return true;
+
+        live_bytes = (i64)get_memory_used(usage) + (i64)size;
+        if(live_bytes <= hard_limit) return true;
+
+        // last chance before failing
+        evict_usage(usage, (ui64)(live_bytes - hard_limit));
+
+        live_bytes = (i64)get_memory_used(usage) + (i64)size;
+        if(live_bytes <= hard_limit) return true;
+
+        hit_error("Memory usage {} can't grow by {} bytes, its hard limit is {} bytes!", usage, size, hard_limit);
+        return false;
+    }
+
+    bool initialize_memory_system()
+    {
+        std::lock_guard lock(s_memory_system.mutex);
+
+        // registered tags are kept, they can be registered before the engine starts
+        for(ui32 i = 0; i < max_usage_count; i++)
+        {
+            s_memory_system.memory_used[i] = 0;
+            s_memory_system.allocation_count[i] = 0;
+            s_memory_system.total_allocations[i] = 0;
+            s_memory_system.total_frees[i] = 0;
+            std::fill_n(s_memory_system.size_histogram[i], size_histogram_bucket_count, 0);
+
+            s_memory_system.published_bytes[i].store(0, std::memory_order_relaxed);
+            s_memory_system.peak_bytes[i].store(0, std::memory_order_relaxed);
+            t_thread_memory.unpublished_bytes[i] = 0;
+
+            s_memory_system.frame_allocation_base[i] = 0;
+            s_memory_system.frame_free_base[i] = 0;
+            s_memory_system.frame_allocations[i] = 0;
+            s_memory_system.frame_frees[i] = 0;
+
+            // the other threads are quiescent, so their unpublished bytes can't be published over the reset
+            for(auto thread_memory = s_memory_system.threads; thread_memory; thread_memory = thread_memory->next)
+            {
+                thread_memory->unpublished_bytes[i] = 0;
+                thread_memory->memory_used[i].store(0, std::memory_order_relaxed);
+                thread_memory->allocation_count[i].store(0, std::memory_order_relaxed);
+                thread_memory->total_allocations[i].store(0, std::memory_order_relaxed);
+                thread_memory->total_frees[i].store(0, std::memory_order_relaxed);
+
+                for(auto& bucket : thread_memory->size_histogram[i]) bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        s_memory_system.frame = 0;
+
+        return true;
+    }
+
+    bool shutdown_memory_system()
+    {
+        bool has_memory_leak = false;
+
+        for(ui32 i = 0; i < get_usage_count(); i++)
+        {
+            const auto usage = (Usage::Type)i;
+            const i64 leaked_allocations = sum_allocation_count(usage);
+
+            if(leaked_allocations == 0) continue;
+
+            if(!has_memory_leak)
+            {
+                hit_fatal("Memory leaks encountered!");
+                has_memory_leak = true;
+            }
+
+#ifdef HIT_DEBUG
+            hit_trace("Usage type:{}, allocations:{}, size:{}", usage, leaked_allocations, get_memory_used(usage));
+#endif
+        }
+
+        // sites are only known when tracing was enabled
+        if(has_memory_leak)
+        {
+            auto sites = get_allocation_sites();
+            std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) { return a.live_bytes > b.live_bytes; });
+
+            for(const auto& site : sites)
+            {
+                if(!site.live_allocations) break;
+
+                hit_trace("Leaked {} bytes in {} allocations at {}.", site.live_bytes, site.live_allocations, format_site_location(site));
+            }
+        }
+
+        return !has_memory_leak;
+    }
+
+    ui8* allocate_memory(ui64 size, Usage::Type usage, std::source_location location)
+    {
+        return allocate_memory(size, usage, { }, location);
+    }
+
+    ui8* allocate_memory(ui64 size, Usage::Type usage, const AllocationOptions& options, std::source_location location)
+    {
+        hit_assert(std::has_single_bit(options.alignment), "Allocation alignment {} is not a power of two!", options.alignment);
+        hit_assert((ui32)usage < max_usage_count, "Invalid memory usage {}!", (ui32)usage);
+
+        if(s_usage_budgets[usage].limited.load(std::memory_order_relaxed)) [[unlikely]]
+        {
+            if(!check_usage_budget(usage, size)) return nullptr;
+        }
+
+        auto header = allocate_block(size, options);
+        hit_assert(header, "Failed to allocate {} bytes!", size);
+
+        header->size = size;
+        header->usage = (ui8)usage;
+        header->flags = 0;
+        header->signature = allocation_signature;
+
+        track_memory(usage, (i64)size, 1, true);
+
+        auto memory = (ui8*)(header + 1);
+
+        const ui32 sample_rate = s_trace_sample_rate.load(std::memory_order_relaxed);
+        if(sample_rate) [[unlikely]] sample_allocation(memory, header, sample_rate, location);
+
+        return memory;
+    }
+
+    void deallocate_memory(ui8* memory)
+    {
+        if(!memory)
+        {
+            hit_warning("Attempting to deallocate an invalid memory!");
+            return;
+        }
+
+        auto header = get_header(memory);
+        hit_assert(
+            header->signature == allocation_signature,
+            "Attempting to deallocate a not registered memory!");
+
+        track_memory((Usage::Type)header->usage, -(i64)header->size, -1);
+
+        if(header->flags & traced_allocation_flag) [[unlikely]] retrace_allocation(memory, nullptr, header->size, 0);
+
+        // invalidate header, so double frees can be catch
+        header->signature = 0;
+
+        deallocate_block(header);
+    }
+
+    ui8* reallocate_memory(ui8* memory, ui64 new_size)
+    {
+        if(!memory || !new_size)
+        {
+            hit_warning_if(!memory, "Attempting to reallocate an invalid memory!");
+            hit_warning_if(!new_size, "Attempting to reallocate to a 0 size!");
+            return nullptr;
+        }
+
+        auto header = get_header(memory);
+        hit_assert(
+            header->signature == allocation_signature,
+            "Attempting to reallocate a not registered memory!");
+
+        const ui64 old_size = header->size;
+
+        if(new_size == old_size)
+        {
+            hit_warning("Attempting to reallocate a memory to the same size!");
+            return memory;
+        }
+
+        const auto usage = (Usage::Type)header->usage;
+        if(new_size > old_size && s_usage_budgets[usage].limited.load(std::memory_order_relaxed)) [[unlikely]]
+        {
+            // the memory is left as it was, like any failed reallocation
+            if(!check_usage_budget(usage, new_size - old_size)) return nullptr;
+        }
+
+        t_thread_memory.reallocation_count++;
+
+        auto new_header = reallocate_block(header, new_size);
+        if(!new_header)
+        {
+            hit_error("Failed to reallocate memory {}.", (void*)memory);
+            return nullptr;
+        }
+
+        new_header->size = new_size;
+        track_memory((Usage::Type)new_header->usage, (i64)new_size - (i64)old_size, 0);
+
+        auto new_memory = (ui8*)(new_header + 1);
+        if(new_header->flags & traced_allocation_flag) [[unlikely]] retrace_allocation(memory, new_memory, old_size, new_size);
+
+        return new_memory;
+    }
+
+    ui8* copy_memory(ui8* dst, const ui8* src, ui64 copy_size)
+    {
+        if(!dst || !src || !copy_size)
+        {
+            hit_warning_if(!dst, "Attempting to copy memory to an invalid destination!");
+            hit_warning_if(!src, "Attempting to copy memory from an invalid source!");
+            hit_warning_if(!copy_size, "Attempting to copy 0 memory!");
+            return nullptr;
+        }
+
+        return (ui8*)std::memcpy(dst, src, copy_size);
+    }
+
+    ui8* set_memory(ui8* memory, i32 value, ui64 size)
+    {
+        if(!memory)
+        {
+            hit_warning("Attempting to setup an invalid memory!");
+            return nullptr;
+        }
+
+        std::memset(memory, value, size);
+
+        return memory;
+    }
+
+    Usage get_usage(ui8* memory)
+    {
+        hit_assert(has_memory(memory), "Attempting to get the usage of a not registered memory!");
+
+        auto header = get_header(memory);
+        return { (Usage::Type)header->usage, header->size, memory };
+    }
+
+    bool has_memory(ui8* memory)
+    {
+        return memory && get_header(memory)->signature == allocation_signature;
+    }
+
+    ui64 get_memory_used(Usage::Type usage)
+    {
+        std::lock_guard lock(s_memory_system.mutex);
+
+        i64 memory_used = s_memory_system.memory_used[usage];
+        for(auto thread_memory = s_memory_system.threads; thread_memory; thread_memory = thread_memory->next)
+        {
+            memory_used += thread_memory->memory_used[usage].load(std::memory_order_relaxed);
+        }
+
+        return (ui64)memory_used;
+    }
+
+    ui64 get_total_memory_used()
+    {
+        ui64 total_memory_used = 0;
+        for(ui32 i = 0; i < get_usage_count(); i++)
+        {
+            total_memory_used += get_memory_used((Usage::Type)i);
+        }
+
+        return total_memory_used;
+    }
+
+    void set_usage_budget(Usage::Type usage, const UsageBudget& budget)
+    {
+        hit_assert((ui32)usage < max_usage_count, "Invalid memory usage {}!", (ui32)usage);
+        hit_warning_if(budget.hard_limit && budget.soft_limit > budget.hard_limit,
+            "Memory usage {} soft limit is over its hard limit!", usage);
+
+        auto& state = s_usage_budgets[usage];
+        state.soft_limit.store(budget.soft_limit, std::memory_order_relaxed);
+        state.hard_limit.store(budget.hard_limit, std::memory_order_relaxed);
+        state.soft_limit_crossed.store(false, std::memory_order_relaxed);
+        state.limited.store(budget.soft_limit || budget.hard_limit, std::memory_order_relaxed);
+    }
+
+    UsageBudget get_usage_budget(Usage::Type usage)
+    {
+        hit_assert((ui32)usage < max_usage_count, "Invalid memory usage {}!", (ui32)usage);
+
+        const auto& state = s_usage_budgets[usage];
+        return { state.soft_limit.load(std::memory_order_relaxed), state.hard_limit.load(std::memory_order_relaxed) };
+    }
+
+    ui32 add_eviction_callback(Usage::Type usage, const EvictionCallback& callback)
+    {
+        auto& eviction_system = get_eviction_system();
+        std::lock_guard lock(eviction_system.mutex);
+
+        const ui32 id = eviction_system.next_id++;
+        eviction_system.callbacks.push_back({ id, usage, callback });
+
+        return id;
+    }
+
+    void remove_eviction_callback(ui32 callback_id)
+    {
+        auto& eviction_system = get_eviction_system();
+        std::lock_guard lock(eviction_system.mutex);
+
+        std::erase_if(eviction_system.callbacks, [&](const auto& registered) { return registered.id == callback_id; });
+    }
+
+    Usage::Type register_usage_tag(std::string_view name)
+    {
+        std::lock_guard lock(s_memory_system.mutex);
+
+        const ui32 usage_count = s_memory_system.usage_count.load(std::memory_order_relaxed);
+        for(ui32 i = 0; i < usage_count; i++)
+        {
+            if(name == s_memory_system.usage_names[i]) return (Usage::Type)i;
+        }
+
+        if(usage_count == max_usage_count)
+        {
+            hit_error("Failed to register memory usage tag '{}', all {} tags are taken!", name, max_usage_count);
+            return Usage::Any;
+        }
+
+        hit_warning_if(name.size() >= max_usage_name_length, "Memory usage tag '{}' name is truncated!", name);
+
+        const ui64 name_length = std::min<ui64>(name.size(), max_usage_name_length - 1);
+        std::memcpy(s_memory_system.usage_names[usage_count], name.data(), name_length);
+        s_memory_system.usage_names[usage_count][name_length] = 0;
+
+        s_memory_system.usage_count.store(usage_count + 1, std::memory_order_release);
+
+        return (Usage::Type)usage_count;
+    }
+
+    std::string_view get_usage_name(Usage::Type usage)
+    {
+        if((ui32)usage >= get_usage_count()) return "None";
+
+        // names are never changed once registered
+        return s_memory_system.usage_names[usage];
+    }
+
+    ui32 get_usage_count()
+    {
+        return s_memory_system.usage_count.load(std::memory_order_acquire);
+    }
+
+    UsageStatistics get_usage_statistics(Usage::Type usage)
+    {
+        hit_assert((ui32)usage < max_usage_count, "Invalid memory usage {}!", (ui32)usage);
+
+        UsageStatistics statistics;
+        statistics.usage = usage;
+
+        std::lock_guard lock(s_memory_system.mutex);
+
+        i64 memory_used = s_memory_system.memory_used[usage];
+        statistics.live_allocations = s_memory_system.allocation_count[usage];
+        statistics.total_allocations = s_memory_system.total_allocations[usage];
+        statistics.total_frees = s_memory_system.total_frees[usage];
+
+        for(ui32 bucket = 0; bucket < size_histogram_bucket_count; bucket++)
+        {
+            statistics.size_histogram[bucket] = s_memory_system.size_histogram[usage][bucket];
+        }
+
+        for(auto thread_memory = s_memory_system.threads; thread_memory; thread_memory = thread_memory->next)
+        {
+            memory_used += thread_memory->memory_used[usage].load(std::memory_order_relaxed);
+            statistics.live_allocations += thread_memory->allocation_count[usage].load(std::memory_order_relaxed);
+            statistics.total_allocations += thread_memory->total_allocations[usage].load(std::memory_order_relaxed);
+            statistics.total_frees += thread_memory->total_frees[usage].load(std::memory_order_relaxed);
+
+            for(ui32 bucket = 0; bucket < size_histogram_bucket_count; bucket++)
+            {
+                statistics.size_histogram[bucket] += thread_memory->size_histogram[usage][bucket].load(std::memory_order_relaxed);
+            }
+        }
+
+        // the exact live bytes are known here, so the peak catches up with them
+        update_peak_bytes(usage, memory_used);
+
+        statistics.live_bytes = (ui64)memory_used;
+        statistics.peak_bytes = (ui64)s_memory_system.peak_bytes[usage].load(std::memory_order_relaxed);
+        statistics.frame_allocations = s_memory_system.frame_allocations[usage];
+        statistics.frame_frees = s_memory_system.frame_frees[usage];
+
+        return statistics;
+    }
+
+    void end_memory_frame()
+    {
+        std::string dump_filename;
+
+        {
+            std::lock_guard lock(s_memory_system.mutex);
+
+            for(ui32 i = 0; i < get_usage_count(); i++)
+            {
+                ui64 total_allocations = s_memory_system.total_allocations[i];
+                ui64 total_frees = s_memory_system.total_frees[i];
+
+                for(auto thread_memory = s_memory_system.threads; thread_memory; thread_memory = thread_memory->next)
+                {
+                    total_allocations += thread_memory->total_allocations[i].load(std::memory_order_relaxed);
+                    total_frees += thread_memory->total_frees[i].load(std::memory_order_relaxed);
+                }
+
+                s_memory_system.frame_allocations[i] = total_allocations - s_memory_system.frame_allocation_base[i];
+                s_memory_system.frame_frees[i] = total_frees - s_memory_system.frame_free_base[i];
+                s_memory_system.frame_allocation_base[i] = total_allocations;
+                s_memory_system.frame_free_base[i] = total_frees;
+            }
+
+            s_memory_system.frame++;
+
+            const ui32 interval = s_memory_system.dump_frame_interval;
+            if(interval && s_memory_system.frame % interval == 0) dump_filename = s_memory_system.dump_filename;
+        }
+
+        if(is_allocation_tracing_enabled()) end_trace_frame();
+
+        if(!dump_filename.empty()) dump_memory_statistics(dump_filename);
+    }
+
+    ui64 get_memory_frame()
+    {
+        std::lock_guard lock(s_memory_system.mutex);
+        return s_memory_system.frame;
+    }
+
+    bool dump_memory_statistics(std::string_view filename)
+    {
+        // opened at the end, so the header is only written to a new file
+        std::ofstream file(std::string(filename), std::ios::app | std::ios::ate);
+        if(!file.is_open())
+        {
+            hit_error("Failed to open memory statistics file '{}'.", filename);
+            return false;
+        }
+
+        if(file.tellp() == 0)
+        {
+            file << "frame,usage,live_bytes,peak_bytes,live_allocations,total_allocations,total_frees,frame_allocations,frame_frees";
+            for(ui32 bucket = 0; bucket < size_histogram_bucket_count; bucket++)
+            {
+                file << std::format(",size_{}", get_size_histogram_bucket_size(bucket));
+            }
+
+            file << "\n";
+        }
+
+        const ui64 frame = get_memory_frame();
+
+        for(ui32 i = 0; i < get_usage_count(); i++)
+        {
+            const auto statistics = get_usage_statistics((Usage::Type)i);
+
+            file << std::format("{},{},{},{},{},{},{},{},{}", frame, get_usage_name(statistics.usage),
+                statistics.live_bytes, statistics.peak_bytes, statistics.live_allocations, statistics.total_allocations,
+                statistics.total_frees, statistics.frame_allocations, statistics.frame_frees);
+
+            for(auto count : statistics.size_histogram) file << "," << count;
+
+            file << "\n";
+        }
+
+        return true;
+    }
+
+    void set_memory_statistics_dump(std::string_view filename, ui32 frame_interval)
+    {
+        std::lock_guard lock(s_memory_system.mutex);
+
+        if(filename.size() >= sizeof(s_memory_system.dump_filename))
+        {
+            hit_error("Memory statistics file name '{}' is too long!", filename);
+            s_memory_system.dump_frame_interval = 0;
+            return;
+        }
+
+        std::memcpy(s_memory_system.dump_filename, filename.data(), filename.size());
+        s_memory_system.dump_filename[filename.size()] = 0;
+        s_memory_system.dump_frame_interval = filename.empty() ? 0 : frame_interval;
+    }
+
+    void enable_allocation_tracing(ui32 sample_rate, bool capture_backtrace)
+    {
+        auto& trace_system = get_trace_system();
+        std::lock_guard lock(trace_system.mutex);
+
+        // a new trace starts, allocations traced before are ignored when released
+        trace_system.site_lookup.clear();
+        trace_system.sites.clear();
+        trace_system.allocations.clear();
+
+        trace_system.sample_rate = std::max(sample_rate, 1u);
+        trace_system.capture_backtrace = capture_backtrace;
+
+        s_trace_sample_rate.store(trace_system.sample_rate, std::memory_order_relaxed);
+    }
+
+    void disable_allocation_tracing()
+    {
+        auto& trace_system = get_trace_system();
+        std::lock_guard lock(trace_system.mutex);
+
+        // sites are kept, so they can still be reported
+        trace_system.sample_rate = 0;
+        s_trace_sample_rate.store(0, std::memory_order_relaxed);
+    }
+
+    bool is_allocation_tracing_enabled()
+    {
+        return s_trace_sample_rate.load(std::memory_order_relaxed) != 0;
+    }
+
+    std::vector<AllocationSite> get_allocation_sites()
+    {
+        auto& trace_system = get_trace_system();
+        std::lock_guard lock(trace_system.mutex);
+
+        std::vector<AllocationSite> sites;
+        sites.reserve(trace_system.sites.size());
+
+        for(const auto& trace_site : trace_system.sites) sites.push_back(trace_site.site);
+
+        return sites;
+    }
+
+    static void write_site_backtrace(std::ofstream& file, const AllocationSite& site)
+    {
+#ifdef HIT_HAS_EXECINFO
+        char** symbols = backtrace_symbols(site.backtrace, (i32)site.backtrace_depth);
+#endif
+
+        for(ui32 i = 0; i < site.backtrace_depth; i++)
+        {
+#ifdef HIT_HAS_EXECINFO
+            if(symbols)
+            {
+                file << std::format("        #{} {}\n", i, symbols[i]);
+                continue;
+            }
+#endif
+            file << std::format("        #{} {}\n", i, site.backtrace[i]);
+        }
+
+#ifdef HIT_HAS_EXECINFO
+        std::free(symbols);
+#endif
+    }
+
+    bool write_allocation_report(std::string_view filename, ui32 site_count)
+    {
+        std::ofstream file{ std::string(filename) };
+        if(!file.is_open())
+        {
+            hit_error("Failed to open allocation report file '{}'.", filename);
+            return false;
+        }
+
+        const ui32 sample_rate = s_trace_sample_rate.load(std::memory_order_relaxed);
+        auto sites = get_allocation_sites();
+
+        file << std::format("allocation report, frame {}, {} sites", get_memory_frame(), sites.size());
+        file << (sample_rate > 1 ? std::format(", 1 in {} allocations traced\n", sample_rate) : "\n");
+
+        std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) { return a.frame_allocations > b.frame_allocations; });
+
+        file << "\nhottest sites of the last frame:\n";
+        for(ui32 i = 0; i < std::min<ui64>(site_count, sites.size()) && sites[i].frame_allocations; i++)
+        {
+            const auto& site = sites[i];
+            file << std::format("    {} allocations, {} bytes, usage {}, at {}\n", site.frame_allocations, site.frame_bytes,
+                get_usage_name(site.usage), format_site_location(site));
+
+            write_site_backtrace(file, site);
+        }
+
+        std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) { return a.live_bytes > b.live_bytes; });
+
+        file << "\nlargest retained sites:\n";
+        for(ui32 i = 0; i < std::min<ui64>(site_count, sites.size()) && sites[i].live_bytes; i++)
+        {
+            const auto& site = sites[i];
+            file << std::format("    {} bytes in {} allocations, {} allocations in total, usage {}, at {}\n", site.live_bytes,
+                site.live_allocations, site.total_allocations, get_usage_name(site.usage), format_site_location(site));
+
+            write_site_backtrace(file, site);
+        }
+
+        return true;
+    }
+
+    ui64 get_thread_allocation_count()
+    {
+        auto& thread_memory = t_thread_memory;
+
+        ui64 count = thread_memory.reallocation_count + thread_memory.global_new_count;
+        for(ui32 i = 0; i < max_usage_count; i++) count += thread_memory.total_allocations[i].load(std::memory_order_relaxed);
+
+        return count;
+    }
+
+    void* allocate_global_memory(std::size_t size)
+    {
+        t_thread_memory.global_new_count++;
+
+        if(void* memory = std::malloc(size ? size : 1)) return memory;
+        throw std::bad_alloc();
+    }
+
+    void deallocate_global_memory(void* memory) noexcept
+    {
+        std::free(memory);
+    }
+
+    AllocationGuard::AllocationGuard(std::string_view name, ui64 budget, bool fail_on_exceed)
+        : m_name(name), m_budget(budget), m_first_count(get_thread_allocation_count()), m_fail_on_exceed(fail_on_exceed)
+    {
+    }
+
+    AllocationGuard::~AllocationGuard()
+    {
+        if(!exceeded()) return;
+
+        hit_error("'{}' made {} allocations, but its budget is {}!", m_name, allocation_count(), m_budget);
+        hit_assert(!m_fail_on_exceed, "'{}' allocation budget exceeded!", m_name);
+    }
+
+    ui64 AllocationGuard::allocation_count() const
+    {
+        return get_thread_allocation_count() - m_first_count;
+    }
+
+    MemorySnapshot take_snapshot()
+    {
+        MemorySnapshot snapshot;
+        snapshot.frame = get_memory_frame();
+
+        for(ui32 i = 0; i < get_usage_count(); i++) snapshot.usages.push_back(get_usage_statistics((Usage::Type)i));
+
+        snapshot.sites = get_allocation_sites();
+
+        return snapshot;
+    }
+
+    static AllocationSiteKey get_site_key(const AllocationSite& site)
+    {
+        AllocationSiteKey key = { site.location.file_name(), site.location.function_name(), site.location.line(),
+            site.location.column(), site.usage, { } };
+
+        std::copy_n(site.backtrace, site.backtrace_depth, key.backtrace.data());
+
+        return key;
+    }
+
+    MemorySnapshotDiff diff(const MemorySnapshot& first, const MemorySnapshot& last)
+    {
+        MemorySnapshotDiff snapshot_diff;
+        snapshot_diff.first_frame = first.frame;
+        snapshot_diff.last_frame = last.frame;
+
+        // usages registered after the first snapshot start from nothing
+        for(const auto& usage : last.usages)
+        {
+            const UsageStatistics empty_usage;
+            const auto& first_usage = usage.usage < first.usages.size() ? first.usages[usage.usage] : empty_usage;
+
+            UsageDiff usage_diff;
+            usage_diff.usage = usage.usage;
+            usage_diff.new_allocations = usage.total_allocations - first_usage.total_allocations;
+            usage_diff.freed_allocations = usage.total_frees - first_usage.total_frees;
+            usage_diff.grown_bytes = (i64)usage.live_bytes - (i64)first_usage.live_bytes;
+
+            if(usage_diff.new_allocations || usage_diff.freed_allocations || usage_diff.grown_bytes)
+            {
+                snapshot_diff.usages.push_back(usage_diff);
+            }
+        }
+
+        // sites are matched by location, the tracing may have been restarted in between
+        std::unordered_map<AllocationSiteKey, const AllocationSite*, AllocationSiteKeyHash> first_sites;
+        for(const auto& site : first.sites) first_sites[get_site_key(site)] = &site;
+
+        for(const auto& site : last.sites)
+        {
+            const AllocationSite empty_site;
+            auto first_site_iterator = first_sites.find(get_site_key(site));
+            const auto& first_site = first_site_iterator != first_sites.end() ? *first_site_iterator->second : empty_site;
+
+            // a restarted trace counts from 0 again
+            const bool restarted = site.total_allocations < first_site.total_allocations;
+            const auto& base_site = restarted ? empty_site : first_site;
+
+            AllocationSiteDiff site_diff;
+            site_diff.site = site;
+            site_diff.new_allocations = site.total_allocations - base_site.total_allocations;
+            site_diff.freed_allocations = (i64)site_diff.new_allocations - ((i64)site.live_allocations - (i64)base_site.live_allocations);
+            site_diff.grown_bytes = (i64)site.live_bytes - (i64)base_site.live_bytes;
+
+            if(site_diff.new_allocations || site_diff.freed_allocations || site_diff.grown_bytes)
+            {
+                snapshot_diff.sites.push_back(site_diff);
+            }
+        }
+
+        std::sort(snapshot_diff.usages.begin(), snapshot_diff.usages.end(),
+            [](const auto& a, const auto& b) { return a.grown_bytes > b.grown_bytes; });
+
+        std::sort(snapshot_diff.sites.begin(), snapshot_diff.sites.end(),
+            [](const auto& a, const auto& b) { return a.grown_bytes > b.grown_bytes; });
+
+        return snapshot_diff;
+    }
+
+    bool write_snapshot_diff(std::string_view filename, const MemorySnapshotDiff& snapshot_diff, ui32 site_count)
+    {
+        std::ofstream file{ std::string(filename), std::ios::app };
+        if(!file.is_open())
+        {
+            hit_error("Failed to open memory snapshot diff file '{}'.", filename);
+            return false;
+        }
+
+        file << std::format("memory from frame {} to frame {}:\n", snapshot_diff.first_frame, snapshot_diff.last_frame);
+
+        for(const auto& usage : snapshot_diff.usages)
+        {
+            file << std::format("    {:+} bytes, {} new, {} freed, usage {}\n", usage.grown_bytes, usage.new_allocations,
+                usage.freed_allocations, get_usage_name(usage.usage));
+        }
+
+        for(ui32 i = 0; i < std::min<ui64>(site_count, snapshot_diff.sites.size()); i++)
+        {
+            const auto& site_diff = snapshot_diff.sites[i];
+            file << std::format("    {:+} bytes, {} new, {} freed, usage {}, at {}\n", site_diff.grown_bytes, site_diff.new_allocations,
+                site_diff.freed_allocations, get_usage_name(site_diff.site.usage), format_site_location(site_diff.site));
+        }
+
+        file << "\n";
+
+        return true;
+    }
+
+    ui64 get_page_size()
+    {
+        static const ui64 page_size = []()
+        {
+#ifdef HIT_PLATFORM_WINDOWS
+            SYSTEM_INFO system_info;
+            GetSystemInfo(&system_info);
+            return (ui64)system_info.dwPageSize;
+#else
+            return (ui64)sysconf(_SC_PAGESIZE);
+#endif
+        }();
+
+        return page_size;
+    }
+
+    ui8* reserve_virtual_memory(ui64 size, Usage::Type usage)
+    {
+        if(!size)
+        {
+            hit_warning("Attempting to reserve 0 bytes of virtual memory!");
+            return nullptr;
+        }
+
+#ifdef HIT_PLATFORM_WINDOWS
+        auto memory = (ui8*)VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+        auto memory = (ui8*)mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if(memory == MAP_FAILED) memory = nullptr;
+#endif
+
+        if(!memory)
+        {
+            hit_error("Failed to reserve {} bytes of virtual memory!", size);
+            return nullptr;
+        }
+
+        // a reservation counts as an allocation, its size is accounted as it's committed
+        track_memory(usage, 0, 1);
+
+        return memory;
+    }
+
+    bool commit_virtual_memory(ui8* memory, ui64 size, Usage::Type usage)
+    {
+        if(s_usage_budgets[usage].limited.load(std::memory_order_relaxed)) [[unlikely]]
+        {
+            if(!check_usage_budget(usage, size)) return false;
+        }
+
+#ifdef HIT_PLATFORM_WINDOWS
+        const bool commit_result = VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        const bool commit_result = mprotect(memory, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+
+        if(!commit_result)
+        {
+            hit_error("Failed to commit {} bytes of virtual memory at {}!", size, (void*)memory);
+            return false;
+        }
+
+        track_memory(usage, (i64)size, 0);
+
+        return true;
+    }
+
+    void decommit_virtual_memory(ui8* memory, ui64 size, Usage::Type usage)
+    {
+#ifdef HIT_PLATFORM_WINDOWS
+        VirtualFree(memory, size, MEM_DECOMMIT);
+#else
+        // pages are given back to the os and the range is inaccessible again
+        madvise(memory, size, MADV_DONTNEED);
+        mprotect(memory, size, PROT_NONE);
+#endif
+
+        track_memory(usage, -(i64)size, 0);
+    }
+
+    void release_virtual_memory(ui8* memory, ui64 reserved_size, ui64 committed_size, Usage::Type usage)
+    {
+        if(!memory)
+        {
+            hit_warning("Attempting to release an invalid virtual memory!");
+            return;
+        }
+
+#ifdef HIT_PLATFORM_WINDOWS
+        VirtualFree(memory, 0, MEM_RELEASE);
+#else
+        munmap(memory, reserved_size);
+#endif
+
+        track_memory(usage, -(i64)committed_size, -1);
+    }
+
+    Usage allocate_usage(ui64 size, Usage::Type usage, std::source_location location)
+    {
+        return allocate_usage(size, usage, { }, location);
+    }
+
+    Usage allocate_usage(ui64 size, Usage::Type usage, const AllocationOptions& options, std::source_location location)
+    {
+        auto memory = allocate_memory(size, usage, options, location);
+        if(!memory)
+        {
+            return { usage, 0, nullptr };
+        }
+
+        return get_usage(memory);
     }
 
     void deallocate_usage(Usage& usage)
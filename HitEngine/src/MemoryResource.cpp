@@ -0,0 +1,64 @@
+#include "Utils/MemoryResource.h"
+
+#include "Core/Assert.h"
+
+#include <algorithm>
+#include <array>
+#include <new>
+
+namespace hit
+{
+    // one per usage a tag can take, not only the built in ones
+    static std::array<UsageMemoryResource, Memory::max_usage_count> create_usage_memory_resources()
+    {
+        std::array<UsageMemoryResource, Memory::max_usage_count> resources;
+        for(ui32 usage = 0; usage < Memory::max_usage_count; usage++) resources[usage] = UsageMemoryResource((MemoryUsage)usage);
+
+        return resources;
+    }
+
+    static std::array<UsageMemoryResource, Memory::max_usage_count> s_usage_memory_resources = create_usage_memory_resources();
+
+    ArenaMemoryResource::ArenaMemoryResource(Arena& arena) : m_arena(arena)
+    {
+        hit_assert(arena.is_virtual(), "ArenaMemoryResource needs a virtual Arena, so its memory never moves!");
+    }
+
+    // a memory_resource can't return null, the pmr containers would use it, so failures throw like the default one
+    void* ArenaMemoryResource::do_allocate(size_t size, size_t alignment)
+    {
+        void* memory = m_arena.push_memory(size, alignment);
+        if(!memory) throw std::bad_alloc();
+
+        return memory;
+    }
+
+    void* UsageMemoryResource::do_allocate(size_t size, size_t alignment)
+    {
+        // containers fill what they allocate, zeroing it would be wasted
+        void* memory = Memory::allocate_memory(size, m_usage, { false, (ui32)std::max<size_t>(alignment, Memory::default_alignment) });
+        if(!memory) throw std::bad_alloc();
+
+        return memory;
+    }
+
+    void UsageMemoryResource::do_deallocate(void* memory, size_t, size_t)
+    {
+        Memory::deallocate_memory((ui8*)memory);
+    }
+
+    bool UsageMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        // any block can be released by any usage resource, the memory system knows where it came from
+        return dynamic_cast<const UsageMemoryResource*>(&other) != nullptr;
+    }
+
+    UsageMemoryResource* get_usage_memory_resource(MemoryUsage usage)
+    {
+        hit_assert((ui32)usage < Memory::max_usage_count, "Invalid memory usage {}!", (ui32)usage);
+        return &s_usage_memory_resources[usage];
+    }
+
+    PoolMemoryResource::PoolMemoryResource(MemoryUsage usage, ui64 largest_pooled_size)
+        : std::pmr::unsynchronized_pool_resource({ 0, largest_pooled_size }, get_usage_memory_resource(usage)) { }
+}
\ No newline at end of file
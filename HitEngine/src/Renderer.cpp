@@ -6,6 +6,9 @@
 
 #include "Renderer/Passes/WorldPass.h"
 
+#include <optional>
+#include <memory_resource>
+
 // Vulkan API
 #include "VulkanRenderer.h"
 
@@ -30,6 +33,8 @@ namespace hit
         m_backend_renderer->m_engine = (Engine*)get_engine();
         m_backend_renderer->m_frontend_renderer = this;
 
+        m_frame_data.frame_allocator = &((Engine*)get_engine())->get_frame_allocator();
+
         m_frame_generation = 0;
         m_frame_last_generation = 0;
         m_frame_width = get_engine()->get_window_width();
@@ -42,7 +47,11 @@ namespace hit
         }
 
         // TODO: make it configurable outside renderer
-        UnbakedRendergraph unbaked_graph;
+        // the unbaked graph only lives while baking, so it's allocated monotonically.
+        // not from the scratch arena, add_pass and the baking rewind it for their own temporaries
+        std::pmr::monotonic_buffer_resource graph_resource(get_usage_memory_resource(MemoryUsage::Renderer));
+
+        UnbakedRendergraph unbaked_graph(&graph_resource);
         UnbakedPass world_pass = world_pass_create_builtin_pass(m_frame_width, m_frame_height);
 
         if(!unbaked_graph.add_pass("WorldPass", world_pass))
@@ -75,6 +84,15 @@ namespace hit
 
         bool update_graph = m_frame_generation != m_frame_last_generation;
 
+        // a resize recreates the frame resources, so it's warmed up again
+        if(update_graph) [[unlikely]] m_warmup_frames_left = render_warmup_frame_count;
+
+#ifdef HIT_DEBUG
+        std::optional<Memory::AllocationGuard> frame_guard;
+        if(!m_warmup_frames_left) frame_guard.emplace("Renderer::execute", 0);
+#endif
+        if(m_warmup_frames_left) m_warmup_frames_left--;
+
         // begin scene
         if(!m_backend_renderer->begin_frame()) [[unlikely]]
         {
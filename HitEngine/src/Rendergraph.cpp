@@ -1,8 +1,10 @@
 #include "Renderer/Rendergraph.h"
 #include "Renderer/Renderer.h"
+#include "Core/Assert.h"
+#include "Utils/Arena.h"
 
 #include <ranges>
-#include <set>
+#include <algorithm>
 
 namespace hit::helper
 {
@@ -31,6 +33,9 @@ namespace hit
 		return false;
 	}
 
+	Rendergraph::Rendergraph() 
+		: m_passes(get_usage_memory_resource(MemoryUsage::Renderer)), m_passes_name_locator(get_usage_memory_resource(MemoryUsage::Renderer)) { }
+
 	bool Rendergraph::initialize(const Renderer* renderer, const UnbakedRendergraph& unbaked)
 	{
 		if(!renderer || unbaked.m_passes.empty())
@@ -156,7 +161,7 @@ namespace hit
 					}
 
 					// get source resource
-					auto& src_pass = unbaked.m_passes[m_passes_name_locator.at(source_pass)].pass;
+					auto& src_pass = unbaked.m_passes[unbaked.m_passes_name_locator.find(std::string_view(source_pass))->second].pass;
 					RendergraphResource* src_resource;
 					for(auto& resource : src_pass->m_resources)
 					{
@@ -299,9 +304,11 @@ namespace hit
 				pass->m_pass = nullptr;
 				pass = nullptr;
 			}
-
-			m_passes.clear();
 		}
+
+		// give the memory back, the graph can outlive the memory system
+		m_passes = std::pmr::vector<Ref<RendergraphPass>>(m_passes.get_allocator());
+		m_passes_name_locator = RendergraphPassLocator(m_passes_name_locator.get_allocator());
 	}
 
 	bool Rendergraph::on_render(FrameData* frame_data)
@@ -349,18 +356,24 @@ namespace hit
 		return true;
 	}
 
-	bool Rendergraph::has_pass(const std::string& pass_name) const
+	bool Rendergraph::has_pass(std::string_view pass_name) const
 	{
 		return m_passes_name_locator.find(pass_name) != m_passes_name_locator.end();
 	}
 
-	const Ref<RendergraphPass> Rendergraph::get_pass(const std::string& pass_name) const
+	const Ref<RendergraphPass> Rendergraph::get_pass(std::string_view pass_name) const
 	{
-		return m_passes[m_passes_name_locator.at(pass_name)];
+		auto it = m_passes_name_locator.find(pass_name);
+		hit_assert(it != m_passes_name_locator.end(), "Rendergraph has no pass '{}'!", pass_name);
+
+		return m_passes[it->second];
 	}
 
 	// Unbaked Graph
-	bool UnbakedRendergraph::add_pass(const std::string& name, const UnbakedPass& pass)
+	UnbakedRendergraph::UnbakedRendergraph(std::pmr::memory_resource* resource) 
+		: m_passes(resource), m_passes_name_locator(resource) { }
+
+	bool UnbakedRendergraph::add_pass(std::string_view name, const UnbakedPass& pass)
 	{
 		// check if resources names are unique
 		if(has_pass(name))
@@ -369,31 +382,35 @@ namespace hit
 			return false;
 		}
 
-		std::vector<std::string> resources_names_list;
+		ArenaScope scratch_scope(get_scratch_arena());
+
+		ArenaVector<std::string_view> resources_names_list(&scratch_scope.arena());
+		resources_names_list.reserve(pass.pass->m_resources.size());
+
 		for(auto& resource : pass.pass->m_resources)
 		{
 			resources_names_list.push_back(resource.name);
 		}
 
-		std::set<std::string> unique_names_set(resources_names_list.begin(), resources_names_list.end());
-		if(unique_names_set.size() != resources_names_list.size())
+		std::sort(resources_names_list.begin(), resources_names_list.end());
+		if(std::adjacent_find(resources_names_list.begin(), resources_names_list.end()) != resources_names_list.end())
 		{
 			hit_error("Pass resources names are not unique!");
 			return false;
 		}
 
 		m_passes.push_back(pass);
-		m_passes_name_locator[name] = m_passes.size() - 1;
+		m_passes_name_locator.emplace(name, (ui32)m_passes.size() - 1);
 
 		return true;
 	}
 
-	bool UnbakedRendergraph::has_pass(const std::string& pass_name) const
+	bool UnbakedRendergraph::has_pass(std::string_view pass_name) const
 	{
 		return m_passes_name_locator.find(pass_name) != m_passes_name_locator.end();
 	}
 
-	bool UnbakedRendergraph::has_pass_resource(const std::string& pass_name, const std::string& resource_name) const
+	bool UnbakedRendergraph::has_pass_resource(std::string_view pass_name, std::string_view resource_name) const
 	{
 		auto pass_index_it = m_passes_name_locator.find(pass_name);
 
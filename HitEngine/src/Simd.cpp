@@ -0,0 +1,89 @@
+#include "Math/Simd.h"
+
+#if defined(HIT_SIMD_X64) && defined(MSVC)
+#include <intrin.h>
+#elif defined(HIT_SIMD_X64)
+#include <cpuid.h>
+#endif
+
+namespace hit
+{
+    static void cpuid(ui32 leaf, ui32 subleaf, ui32 out_registers[4])
+    {
+#if defined(HIT_SIMD_X64) && defined(MSVC)
+        __cpuidex((int*)out_registers, (int)leaf, (int)subleaf);
+#elif defined(HIT_SIMD_X64)
+        __cpuid_count(leaf, subleaf, out_registers[0], out_registers[1], out_registers[2], out_registers[3]);
+#else
+        out_registers[0] = out_registers[1] = out_registers[2] = out_registers[3] = 0;
+#endif
+    }
+
+    // the os must save the ymm registers on context switches too
+    static bool is_avx_state_enabled()
+    {
+#if defined(HIT_SIMD_X64) && defined(MSVC)
+        return (_xgetbv(0) & 0x6) == 0x6;
+#elif defined(HIT_SIMD_X64)
+        ui32 eax, edx;
+        __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (eax & 0x6) == 0x6;
+#else
+        return false;
+#endif
+    }
+
+    static SimdLevel detect_simd_level()
+    {
+        ui32 registers[4];
+
+        cpuid(0, 0, registers);
+        const ui32 max_leaf = registers[0];
+        if (max_leaf < 1) return SimdLevel::Scalar;
+
+        cpuid(1, 0, registers);
+        const bool sse41 = registers[2] & (1u << 19);
+        const bool fma = registers[2] & (1u << 12);
+        const bool osxsave = registers[2] & (1u << 27);
+        const bool avx = registers[2] & (1u << 28);
+
+        if (!sse41) return SimdLevel::Scalar;
+        if (max_leaf < 7 || !fma || !avx || !osxsave || !is_avx_state_enabled()) return SimdLevel::Sse41;
+
+        cpuid(7, 0, registers);
+        const bool avx2 = registers[1] & (1u << 5);
+
+        return avx2 ? SimdLevel::Avx2 : SimdLevel::Sse41;
+    }
+
+    static SimdLevel s_simd_level = get_supported_simd_level();
+
+    SimdLevel get_supported_simd_level()
+    {
+        static const SimdLevel supported_level = detect_simd_level();
+        return supported_level;
+    }
+
+    SimdLevel get_simd_level()
+    {
+        return s_simd_level;
+    }
+
+    void set_simd_level(SimdLevel level)
+    {
+        s_simd_level = level < get_supported_simd_level() ? level : get_supported_simd_level();
+    }
+
+    const char* get_simd_level_name(SimdLevel level)
+    {
+        switch (level)
+        {
+            case SimdLevel::Scalar: return "scalar";
+            case SimdLevel::Sse41: return "sse4.1";
+            case SimdLevel::Avx2: return "avx2";
+            case SimdLevel::Count: break;
+        }
+
+        return "unknown";
+    }
+}
\ No newline at end of file
@@ -6,7 +6,7 @@
 
 namespace hit::config
 {
-	SourceReader::SourceReader(const std::string& source) 
+	SourceReader::SourceReader(std::string_view source) 
 		: m_source(source), m_current(0), m_line(1), m_column(1) { }
 
 	Token SourceReader::get_next(bool reading_source_content)
@@ -74,7 +74,7 @@ namespace hit::config
 			advance();
 			while (is_alphanum() && has_next()) advance();
 
-			std::string naming = m_source.substr(start, m_current - start);
+			auto naming = m_source.substr(start, m_current - start);
 			return Token { Token::Naming, m_line, m_column, naming };
 		}
 
@@ -95,7 +95,7 @@ namespace hit::config
 
 			if (consume('"'))
 			{
-				std::string str = m_source.substr(start, m_current - start - 1);
+				auto str = m_source.substr(start, m_current - start - 1);
 				return Token { Token::String, m_line, m_column, str };
 			}
 			else
@@ -224,7 +224,7 @@ namespace hit::config
 		return Token { Token::Invalid, m_line, m_column, m_source.substr(start, m_current - start) };
 	}
 
-	TokenReader::TokenReader(const std::string& source) : m_current(0)
+	TokenReader::TokenReader(std::string_view source, Arena* scratch_arena) : m_current(0), m_tokens(scratch_arena)
 	{ 
 		SourceReader reader(source);
 
@@ -263,9 +263,9 @@ namespace hit::config
 		}
 	}
 
-	Token TokenReader::get_current() { return m_tokens[m_current]; }
+	const Token& TokenReader::get_current() { return m_tokens[m_current]; }
 
-	Token TokenReader::get_past() { return m_current == 0 ? get_current() : m_tokens[m_current - 1]; }
+	const Token& TokenReader::get_past() { return m_current == 0 ? get_current() : m_tokens[m_current - 1]; }
 
 	bool TokenReader::has_next() { return m_current + 1 < m_tokens.size(); }
 
@@ -327,18 +327,19 @@ namespace hit::config
 		return false;
 	}
 
-	Parser::Parser(const std::string& source) : m_reader(source) { }
+	Parser::Parser(std::string_view source, Arena* scratch_arena, std::pmr::memory_resource* resource) 
+		: m_reader(source, scratch_arena), m_allocator(resource) { }
 
-	std::vector<Block> Parser::build_block_tree()
+	std::pmr::vector<Block> Parser::build_block_tree()
 	{
+		std::pmr::vector<Block> blocks(m_allocator);
+
 		if (m_reader.get_current().type == Token::Invalid)
 		{
 			hit_error("Can't parse onfiguration file source.");
-			return { };
+			return blocks;
 		}
 
-		std::vector<Block> blocks;
-
 		while (m_reader.has_next())
 		{
 			blocks.push_back(parse_block());
@@ -355,12 +356,12 @@ namespace hit::config
 			hit_error("Expected identifier at line {}, column {}: {}",
 					  current.line, current.column, current.value);
 
-			return Block();
+			return Block("", m_allocator);
 		}
 
 		auto token = m_reader.get_past();
 
-		Block block(token.value);
+		Block block(token.value, m_allocator);
 
 		if (m_reader.consume(Token::Source))
 		{
@@ -412,14 +413,14 @@ namespace hit::config
 		auto token = m_reader.get_current();
 		m_reader.advance();
 
-		Property property;
+		Property property(m_allocator);
 		property.set_identifier(token.value);
 
 		if (m_reader.consume(Token::Assign))
 		{
 			if (m_reader.consume(Token::ListOpen))
 			{
-				std::vector<Value> values;
+				std::pmr::vector<Value> values(m_allocator);
 
 				while (!m_reader.check(Token::ListClose) && m_reader.has_next())
 				{
@@ -442,7 +443,7 @@ namespace hit::config
 							  current.line, current.column, current.value);
 				}
 
-				property.set_value(values);
+				property.set_value(std::move(values));
 			}
 			else
 			{
@@ -457,21 +458,55 @@ namespace hit::config
 	{
 		if (m_reader.consume(Token::Number))
 		{
-			return Value(str_to_f64(m_reader.get_past().value));
+			return Value(str_to_f64(std::string(m_reader.get_past().value)), m_allocator);
 		}
 
 		if (m_reader.consume(Token::String) || m_reader.consume(Token::Naming))
 		{
-			return Value(m_reader.get_past().value);
+			return Value(m_reader.get_past().value, m_allocator);
 		}
 
 		auto current = m_reader.get_current();
 		hit_error("Expected 'number' or 'string' at line {}, column {}: {}",
 				  current.line, current.column, current.value);
 
-		return Value();
+		return Value(m_allocator);
+	}
+
+	Value::Value(const Value& other, const Allocator& allocator) : m_type(other.m_type), m_value(0.0)
+	{
+		if (other.is_string()) m_value.emplace<String>(other.get_string(), allocator);
+		else m_value = other.get_number();
+	}
+
+	Value::Value(Value&& other, const Allocator& allocator) : m_type(other.m_type), m_value(0.0)
+	{
+		if (other.is_string()) m_value.emplace<String>(std::move(std::get<String>(other.m_value)), allocator);
+		else m_value = other.get_number();
+	}
+
+	Property::Property(const Property& other, const Allocator& allocator)
+		: m_identifier(other.m_identifier, allocator), m_type(other.m_type), m_value(std::in_place_index<Single>, allocator)
+	{
+		if (other.is_list()) m_value.emplace<List>(other.get_list_value(), allocator);
+		else m_value.emplace<Single>(other.get_single_value(), allocator);
+	}
+
+	Property::Property(Property&& other, const Allocator& allocator)
+		: m_identifier(std::move(other.m_identifier), allocator), m_type(other.m_type), m_value(std::in_place_index<Single>, allocator)
+	{
+		if (other.is_list()) m_value.emplace<List>(std::move(std::get<List>(other.m_value)), allocator);
+		else m_value.emplace<Single>(std::move(std::get<Single>(other.m_value)), allocator);
 	}
 
+	Block::Block(const Block& other, const Allocator& allocator)
+		: m_identifier(other.m_identifier, allocator), m_source_content(other.m_source_content, allocator),
+		m_properties(other.m_properties, allocator), m_inner_blocks(other.m_inner_blocks, allocator) { }
+
+	Block::Block(Block&& other, const Allocator& allocator)
+		: m_identifier(std::move(other.m_identifier), allocator), m_source_content(std::move(other.m_source_content), allocator),
+		m_properties(std::move(other.m_properties), allocator), m_inner_blocks(std::move(other.m_inner_blocks), allocator) { }
+
 	bool Block::is_source_block() const
 	{
 		return !m_source_content.empty();
@@ -479,26 +514,26 @@ namespace hit::config
 
 	std::string Block::get_source_block_content() const
 	{
-		return m_source_content;
+		return std::string(m_source_content);
 	}
 
-	bool Block::has_property(const std::string& identifier) const
+	bool Block::has_property(std::string_view identifier) const
 	{
 		return m_properties.find(identifier) != m_properties.end();
 	}
 
-	Property Block::get_property(const std::string& identifier) const
+	Property Block::get_property(std::string_view identifier) const
 	{
 		auto it = m_properties.find(identifier);
 		return it != m_properties.end() ? it->second : Property();
 	}
 
-	bool Block::has_inner_block(const std::string& identifier) const
+	bool Block::has_inner_block(std::string_view identifier) const
 	{
 		return m_inner_blocks.find(identifier) != m_inner_blocks.end();
 	}
 
-	const Block* Block::get_inner_block(const std::string& identifier) const
+	const Block* Block::get_inner_block(std::string_view identifier) const
 	{
 		auto it = m_inner_blocks.find(identifier);
 		return it != m_inner_blocks.end() ? it->second.get() : nullptr;
@@ -506,17 +541,35 @@ namespace hit::config
 
 	void Block::add_property(const Property& property)
 	{
-		m_properties[property.get_identifier()] = property;
+		m_properties.insert_or_assign(std::pmr::string(property.get_identifier(), get_allocator()), property);
 	}
 
+	void Block::add_property(Property&& property)
+	{
+		std::pmr::string identifier(property.get_identifier(), get_allocator());
+		m_properties.insert_or_assign(std::move(identifier), std::move(property));
+	}
+
+	// inner blocks and their control blocks are allocated from the same resource, constructed with its allocator
 	void Block::add_inner_block(const Block& block)
 	{ 
-		m_inner_blocks[block.get_identifier()] = create_ref<Block>(block);
+		m_inner_blocks.insert_or_assign(std::pmr::string(block.get_identifier(), get_allocator()), 
+										std::allocate_shared<Block>(std::pmr::polymorphic_allocator<Block>(get_allocator()), block));
+	}
+
+	void Block::add_inner_block(Block&& block)
+	{ 
+		std::pmr::string identifier(block.get_identifier(), get_allocator());
+		m_inner_blocks.insert_or_assign(std::move(identifier), 
+										std::allocate_shared<Block>(std::pmr::polymorphic_allocator<Block>(get_allocator()), std::move(block)));
 	}
 
-	StandardConfigurationFile::StandardConfigurationFile(const std::string& source)
+	StandardConfigurationFile::StandardConfigurationFile(std::string_view source, MemoryUsage usage)
+		: m_resource(create_scope<PoolMemoryResource>(usage)), m_root_blocks(m_resource.get())
 	{ 
-		Parser parser(source);
+		// tokens only live while parsing
+		ArenaScope scratch_scope(get_scratch_arena());
+		Parser parser(source, &scratch_scope.arena(), m_resource.get());
 
 		auto blocks = parser.build_block_tree();
 
@@ -527,7 +580,8 @@ namespace hit::config
 
 		for (auto& block : blocks)
 		{
-			m_root_blocks[block.get_identifier()] = block;
+			std::pmr::string identifier(block.get_identifier(), m_resource.get());
+			m_root_blocks.insert_or_assign(std::move(identifier), std::move(block));
 		}
 	}
 
@@ -536,12 +590,12 @@ namespace hit::config
 		return !m_root_blocks.empty();
 	}
 
-	bool StandardConfigurationFile::has_block(const std::string& identifier)
+	bool StandardConfigurationFile::has_block(std::string_view identifier)
 	{
 		return m_root_blocks.find(identifier) != m_root_blocks.end();
 	}
 
-	Block* StandardConfigurationFile::get_block(const std::string& identifier)
+	Block* StandardConfigurationFile::get_block(std::string_view identifier)
 	{
 		auto it = m_root_blocks.find(identifier);
 		return it != m_root_blocks.end() ? &it->second : nullptr;
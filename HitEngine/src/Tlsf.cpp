@@ -0,0 +1,467 @@
+#include "Utils/Tlsf.h"
+#include "Core/Log.h"
+#include "Core/Assert.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace hit
+{
+	TlsfAllocator::TlsfAllocator(ui64 initial_size) : m_blocks(64), m_used_blocks(used_table_initial_size), m_size(initial_size), m_used(0)
+	{
+		m_used_blocks.push_array(used_table_initial_size);
+		clear();
+	}
+
+	bool TlsfAllocator::push_size(ui64 size, ui64& out_offset, ui64 alignment)
+	{
+		hit_assert(std::has_single_bit(alignment), "TlsfAllocator alignment must be a power of two!");
+
+		if(!size)
+		{
+			hit_warning("Attempting to allocate 0 bytes!");
+			return false;
+		}
+
+		if(!reserve_used_blocks(m_used_block_count + 1))
+		{
+			hit_warning("Can't grow the used block table to allocate {} bytes", size);
+			return false;
+		}
+
+		// the worst padding is searched for, so any block found fits once aligned
+		ui32 block_index = find_free_block(size + alignment - 1);
+		if(block_index == invalid_block)
+		{
+			hit_warning("Can't find space to allocate {} bytes", size);
+			return false;
+		}
+
+		remove_free_block(block_index);
+
+		// the padding in front is given back as its own free block
+		const ui64 block_offset = m_blocks[block_index]->offset;
+		const ui64 aligned_offset = (block_offset + alignment - 1) & ~(alignment - 1);
+
+		if(aligned_offset != block_offset)
+		{
+			const ui32 aligned_index = split_block(block_index, aligned_offset - block_offset);
+			insert_free_block(block_index);
+
+			block_index = aligned_index;
+		}
+
+		if(m_blocks[block_index]->size > size)
+		{
+			insert_free_block(split_block(block_index, size));
+		}
+
+		Block* block = m_blocks[block_index];
+		block->free = false;
+
+		insert_used_block(block->offset, block_index);
+		m_used += size;
+
+		out_offset = block->offset;
+
+		return true;
+	}
+
+	bool TlsfAllocator::pop_size(ui64 size, ui64 offset)
+	{
+		const ui64 entry_index = find_used_block(offset);
+		ui32 block_index = m_used_blocks[entry_index]->block_index;
+
+		if(block_index == invalid_block)
+		{
+			hit_warning("Attempting to pop memory at a free space!");
+			return false;
+		}
+
+		remove_used_block(entry_index);
+
+		Block* block = m_blocks[block_index];
+		hit_warning_if(block->size != size, "Attempting to pop {} bytes from a block of {} bytes!", size, block->size);
+
+		m_used -= block->size;
+		block->free = true;
+
+		// free neighbours are merged right away, so two free blocks are never next to each other
+		const ui32 next_index = block->next_physical;
+		if(next_index != invalid_block && m_blocks[next_index]->free)
+		{
+			remove_free_block(next_index);
+			merge_block(block_index, next_index);
+		}
+
+		const ui32 prev_index = m_blocks[block_index]->prev_physical;
+		if(prev_index != invalid_block && m_blocks[prev_index]->free)
+		{
+			remove_free_block(prev_index);
+			merge_block(prev_index, block_index);
+
+			block_index = prev_index;
+		}
+
+		insert_free_block(block_index);
+
+		return true;
+	}
+
+	bool TlsfAllocator::rebuild(std::span<const SubAllocation> allocations)
+	{
+		std::vector<SubAllocation> sorted_allocations(allocations.begin(), allocations.end());
+		std::sort(sorted_allocations.begin(), sorted_allocations.end(), [](const SubAllocation& a, const SubAllocation& b) { return a.offset < b.offset; });
+
+		clear();
+		if(sorted_allocations.empty()) return true;
+
+		if(!reserve_used_blocks(sorted_allocations.size()))
+		{
+			hit_error("Can't rebuild tlsf allocator, the used block table can't hold {} allocations.", sorted_allocations.size());
+			return false;
+		}
+
+		// the blocks are laid out again from the start, free ones fill the gaps
+		remove_free_block(m_last_block);
+		destroy_block(m_last_block);
+		m_last_block = invalid_block;
+
+		ui64 cursor = 0;
+		for(auto& allocation : sorted_allocations)
+		{
+			if(allocation.offset < cursor || allocation.offset + allocation.size > m_size || !allocation.size)
+			{
+				hit_error("Can't rebuild tlsf allocator, allocation at {} of {} bytes overlaps another or is out of bounds.", allocation.offset, allocation.size);
+
+				clear();
+				return false;
+			}
+
+			if(allocation.offset > cursor) append_block(cursor, allocation.offset - cursor, true);
+			append_block(allocation.offset, allocation.size, false);
+
+			cursor = allocation.offset + allocation.size;
+		}
+
+		if(cursor < m_size) append_block(cursor, m_size - cursor, true);
+
+		return true;
+	}
+
+	bool TlsfAllocator::resize(ui64 new_size)
+	{
+		if(new_size < m_size)
+		{
+			hit_error("Can't resize a tlsf allocator to a size less than it has at the moment.");
+			return false;
+		}
+
+		if(new_size == m_size) return true;
+
+		const ui64 grown_size = new_size - m_size;
+
+		if(m_last_block != invalid_block && m_blocks[m_last_block]->free)
+		{
+			remove_free_block(m_last_block);
+			m_blocks[m_last_block]->size += grown_size;
+			insert_free_block(m_last_block);
+		}
+		else
+		{
+			const ui32 block_index = create_block(m_size, grown_size);
+			m_blocks[block_index]->prev_physical = m_last_block;
+
+			if(m_last_block != invalid_block) m_blocks[m_last_block]->next_physical = block_index;
+			m_last_block = block_index;
+
+			insert_free_block(block_index);
+		}
+
+		m_size = new_size;
+
+		return true;
+	}
+
+	void TlsfAllocator::clear()
+	{
+		m_blocks.clear();
+		m_unused_block = invalid_block;
+		m_last_block = invalid_block;
+
+		m_first_level_bitmap = 0;
+		for(ui32 i = 0; i < first_level_count; i++)
+		{
+			m_second_level_bitmaps[i] = 0;
+			for(ui32 j = 0; j < second_level_count; j++) m_free_heads[i][j] = invalid_block;
+		}
+
+		clear_used_blocks();
+		m_used = 0;
+
+		if(!m_size) return;
+
+		m_last_block = create_block(0, m_size);
+		insert_free_block(m_last_block);
+	}
+
+	ui64 TlsfAllocator::get_largest_free_block()
+	{
+		if(!m_first_level_bitmap) return 0;
+
+		const ui32 first_level = 63 - std::countl_zero(m_first_level_bitmap);
+		const ui32 second_level = 31 - std::countl_zero(m_second_level_bitmaps[first_level]);
+
+		ui64 largest_size = 0;
+		for(ui32 block_index = m_free_heads[first_level][second_level]; block_index != invalid_block; block_index = m_blocks[block_index]->next_free)
+		{
+			largest_size = std::max(largest_size, m_blocks[block_index]->size);
+		}
+
+		return largest_size;
+	}
+
+	void TlsfAllocator::mapping(ui64 size, ui32& out_first_level, ui32& out_second_level)
+	{
+		// small sizes have a bin each
+		if(size < second_level_count)
+		{
+			out_first_level = 0;
+			out_second_level = (ui32)size;
+			return;
+		}
+
+		const ui32 highest_bit = 63 - std::countl_zero(size);
+
+		out_first_level = highest_bit - second_level_log2 + 1;
+		out_second_level = (ui32)(size >> (highest_bit - second_level_log2)) - second_level_count;
+	}
+
+	ui32 TlsfAllocator::find_free_block(ui64 size)
+	{
+		// rounded up to the next bin, so every block of the bin found is big enough
+		if(size >= second_level_count)
+		{
+			const ui32 highest_bit = 63 - std::countl_zero(size);
+			size += (1ull << (highest_bit - second_level_log2)) - 1;
+		}
+
+		ui32 first_level, second_level;
+		mapping(size, first_level, second_level);
+
+		ui32 second_level_map = m_second_level_bitmaps[first_level] & (~0u << second_level);
+		if(!second_level_map)
+		{
+			const ui64 first_level_map = first_level + 1 < 64 ? m_first_level_bitmap & (~0ull << (first_level + 1)) : 0;
+			if(!first_level_map) return invalid_block;
+
+			first_level = std::countr_zero(first_level_map);
+			second_level_map = m_second_level_bitmaps[first_level];
+		}
+
+		second_level = std::countr_zero(second_level_map);
+
+		return m_free_heads[first_level][second_level];
+	}
+
+	void TlsfAllocator::insert_free_block(ui32 block_index)
+	{
+		Block* block = m_blocks[block_index];
+
+		ui32 first_level, second_level;
+		mapping(block->size, first_level, second_level);
+
+		const ui32 head_index = m_free_heads[first_level][second_level];
+
+		block->free = true;
+		block->prev_free = invalid_block;
+		block->next_free = head_index;
+
+		if(head_index != invalid_block) m_blocks[head_index]->prev_free = block_index;
+		m_free_heads[first_level][second_level] = block_index;
+
+		m_first_level_bitmap |= 1ull << first_level;
+		m_second_level_bitmaps[first_level] |= 1u << second_level;
+	}
+
+	void TlsfAllocator::remove_free_block(ui32 block_index)
+	{
+		Block* block = m_blocks[block_index];
+
+		ui32 first_level, second_level;
+		mapping(block->size, first_level, second_level);
+
+		if(block->prev_free != invalid_block) m_blocks[block->prev_free]->next_free = block->next_free;
+		if(block->next_free != invalid_block) m_blocks[block->next_free]->prev_free = block->prev_free;
+
+		if(m_free_heads[first_level][second_level] == block_index)
+		{
+			m_free_heads[first_level][second_level] = block->next_free;
+
+			if(block->next_free == invalid_block)
+			{
+				m_second_level_bitmaps[first_level] &= ~(1u << second_level);
+				if(!m_second_level_bitmaps[first_level]) m_first_level_bitmap &= ~(1ull << first_level);
+			}
+		}
+
+		block->prev_free = invalid_block;
+		block->next_free = invalid_block;
+	}
+
+	ui32 TlsfAllocator::split_block(ui32 block_index, ui64 size)
+	{
+		hit_assert(m_blocks[block_index]->size > size, "Attempting to split a block which is too small!");
+
+		const ui32 rest_index = create_block(m_blocks[block_index]->offset + size, m_blocks[block_index]->size - size);
+
+		// creating the block may move the others
+		Block* block = m_blocks[block_index];
+		Block* rest = m_blocks[rest_index];
+
+		rest->prev_physical = block_index;
+		rest->next_physical = block->next_physical;
+
+		if(block->next_physical != invalid_block) m_blocks[block->next_physical]->prev_physical = rest_index;
+		else m_last_block = rest_index;
+
+		block->next_physical = rest_index;
+		block->size = size;
+
+		return rest_index;
+	}
+
+	void TlsfAllocator::merge_block(ui32 block_index, ui32 next_index)
+	{
+		Block* block = m_blocks[block_index];
+		Block* next = m_blocks[next_index];
+
+		block->size += next->size;
+		block->next_physical = next->next_physical;
+
+		if(next->next_physical != invalid_block) m_blocks[next->next_physical]->prev_physical = block_index;
+		else m_last_block = block_index;
+
+		destroy_block(next_index);
+	}
+
+	void TlsfAllocator::append_block(ui64 offset, ui64 size, bool free)
+	{
+		const ui32 block_index = create_block(offset, size);
+		m_blocks[block_index]->prev_physical = m_last_block;
+
+		if(m_last_block != invalid_block) m_blocks[m_last_block]->next_physical = block_index;
+		m_last_block = block_index;
+
+		if(free)
+		{
+			insert_free_block(block_index);
+			return;
+		}
+
+		insert_used_block(offset, block_index);
+		m_used += size;
+	}
+
+	ui32 TlsfAllocator::create_block(ui64 offset, ui64 size)
+	{
+		ui32 block_index = m_unused_block;
+
+		if(block_index != invalid_block)
+		{
+			m_unused_block = m_blocks[block_index]->next_free;
+		}
+		else
+		{
+			block_index = (ui32)m_blocks.size();
+			m_blocks.push_back();
+		}
+
+		*m_blocks[block_index] = { offset, size, invalid_block, invalid_block, invalid_block, invalid_block, false };
+
+		return block_index;
+	}
+
+	void TlsfAllocator::destroy_block(ui32 block_index)
+	{
+		m_blocks[block_index]->next_free = m_unused_block;
+		m_unused_block = block_index;
+	}
+
+	ui64 TlsfAllocator::find_used_block(ui64 offset)
+	{
+		const std::span<UsedBlock> table = m_used_blocks.data();
+		const ui64 mask = table.size() - 1;
+
+		// aligned offsets have their low bits clear, the multiply spreads them over the high ones
+		ui64 entry_index = (offset * 0x9E3779B97F4A7C15ull) >> (64 - std::countr_zero(table.size()));
+
+		while(table[entry_index].block_index != invalid_block && table[entry_index].offset != offset)
+		{
+			entry_index = (entry_index + 1) & mask;
+		}
+
+		return entry_index;
+	}
+
+	bool TlsfAllocator::reserve_used_blocks(ui64 count)
+	{
+		ui64 table_size = m_used_blocks.size();
+		while(count * 2 > table_size) table_size *= 2;
+
+		if(table_size == m_used_blocks.size()) return true;
+
+		FastTypedArena<UsedBlock> used_blocks(table_size);
+		UsedBlock* entries = used_blocks.push_array(table_size);
+		if(!entries) return false;
+
+		for(ui64 i = 0; i < table_size; i++) entries[i].block_index = invalid_block;
+
+		std::swap(m_used_blocks, used_blocks);
+
+		for(const auto& entry : used_blocks.data())
+		{
+			if(entry.block_index != invalid_block) *m_used_blocks[find_used_block(entry.offset)] = entry;
+		}
+
+		return true;
+	}
+
+	void TlsfAllocator::insert_used_block(ui64 offset, ui32 block_index)
+	{
+		hit_assert(m_used_block_count * 2 < m_used_blocks.size(), "The used block table must be reserved before inserting!");
+
+		*m_used_blocks[find_used_block(offset)] = { offset, block_index };
+		m_used_block_count++;
+	}
+
+	void TlsfAllocator::remove_used_block(ui64 entry_index)
+	{
+		const std::span<UsedBlock> table = m_used_blocks.data();
+		const ui64 mask = table.size() - 1;
+		const ui32 shift = 64 - std::countr_zero(table.size());
+
+		// the entries after the hole are shifted back instead of leaving a tombstone,
+		// one moves in when the hole is between its home and where it is
+		ui64 hole = entry_index;
+		for(ui64 i = (hole + 1) & mask; table[i].block_index != invalid_block; i = (i + 1) & mask)
+		{
+			const ui64 home = (table[i].offset * 0x9E3779B97F4A7C15ull) >> shift;
+
+			if(((i - home) & mask) >= ((i - hole) & mask))
+			{
+				table[hole] = table[i];
+				hole = i;
+			}
+		}
+
+		table[hole].block_index = invalid_block;
+		m_used_block_count--;
+	}
+
+	void TlsfAllocator::clear_used_blocks()
+	{
+		for(auto& entry : m_used_blocks.data()) entry.block_index = invalid_block;
+		m_used_block_count = 0;
+	}
+}
\ No newline at end of file
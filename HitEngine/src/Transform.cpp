@@ -0,0 +1,374 @@
+#include "Math/Transform.h"
+
+#include "Math/MathDefines.h"
+#include "Math/Simd.h"
+
+namespace hit
+{
+    // scalar kernels, the simd ones are checked against them
+    static Quat quat_mul_scalar(const Quat& q1, const Quat& q2)
+    {
+        return {
+            q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y,
+            q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x,
+            q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w,
+            q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z
+        };
+    }
+
+    // v + w * t + u x t with t = 2 * u x v, u is the vector part
+    static Vec3 quat_rotate_scalar(const Quat& q, const Vec3& v)
+    {
+        const Vec3 u(q.x, q.y, q.z);
+        const Vec3 t = u.cross(v) * 2.0f;
+
+        return v + t * q.w + u.cross(t);
+    }
+
+    static Transform transform_mul_scalar(const Transform& parent, const Transform& child)
+    {
+        Transform out_t;
+        out_t.translation = parent.translation + quat_rotate_scalar(parent.rotation, parent.scale * child.translation);
+        out_t.rotation = quat_mul_scalar(parent.rotation, child.rotation);
+        out_t.scale = parent.scale * child.scale;
+        return out_t;
+    }
+
+    static Transform transform_inverse_scalar(const Transform& t)
+    {
+        Transform out_t;
+        out_t.scale = Vec3(1.0f) / t.scale;
+        out_t.rotation = t.rotation.conjugate();
+        out_t.translation = out_t.scale * quat_rotate_scalar(out_t.rotation, -t.translation);
+        return out_t;
+    }
+
+    static Mat4 transform_to_mat4_scalar(const Transform& t)
+    {
+        const Quat& q = t.rotation;
+
+        const f32 x2 = q.x + q.x;
+        const f32 y2 = q.y + q.y;
+        const f32 z2 = q.z + q.z;
+
+        const f32 xx = q.x * x2;
+        const f32 yy = q.y * y2;
+        const f32 zz = q.z * z2;
+        const f32 xy = q.x * y2;
+        const f32 xz = q.x * z2;
+        const f32 yz = q.y * z2;
+        const f32 wx = q.w * x2;
+        const f32 wy = q.w * y2;
+        const f32 wz = q.w * z2;
+
+        // rotation columns scaled, the translation as the last column
+        Mat4 out_m;
+
+        out_m.data[0] = (1.0f - yy - zz) * t.scale.x;
+        out_m.data[1] = (xy + wz) * t.scale.x;
+        out_m.data[2] = (xz - wy) * t.scale.x;
+
+        out_m.data[4] = (xy - wz) * t.scale.y;
+        out_m.data[5] = (1.0f - xx - zz) * t.scale.y;
+        out_m.data[6] = (yz + wx) * t.scale.y;
+
+        out_m.data[8] = (xz + wy) * t.scale.z;
+        out_m.data[9] = (yz - wx) * t.scale.z;
+        out_m.data[10] = (1.0f - xx - yy) * t.scale.z;
+
+        out_m.data[12] = t.translation.x;
+        out_m.data[13] = t.translation.y;
+        out_m.data[14] = t.translation.z;
+        out_m.data[15] = 1.0f;
+
+        return out_m;
+    }
+
+#ifdef HIT_SIMD_X64
+    // _MM_SHUFFLE takes the lanes from the last one
+    #define quat_swizzle(v, x, y, z, w) _mm_shuffle_ps(v, v, _MM_SHUFFLE(w, z, y, x))
+
+    // x and y as one 64 bit load, so nothing past z is read or written
+    HIT_TARGET_SSE41 static inline __m128 load_vec3(const Vec3& v)
+    {
+        return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const f64*)v.elements)), _mm_load_ss(v.elements + 2));
+    }
+
+    HIT_TARGET_SSE41 static inline void store_vec3(Vec3& v, __m128 value)
+    {
+        _mm_store_sd((f64*)v.elements, _mm_castps_pd(value));
+        _mm_store_ss(v.elements + 2, _mm_movehl_ps(value, value));
+    }
+
+    // the last lane is 0 when both w lanes are the same
+    HIT_TARGET_SSE41 static inline __m128 vec3_cross(__m128 a, __m128 b)
+    {
+        return _mm_sub_ps(
+            _mm_mul_ps(quat_swizzle(a, 1, 2, 0, 3), quat_swizzle(b, 2, 0, 1, 3)),
+            _mm_mul_ps(quat_swizzle(a, 2, 0, 1, 3), quat_swizzle(b, 1, 2, 0, 3)));
+    }
+
+    // one term per lane of q1, the negative products flip their sign bit
+    HIT_TARGET_SSE41 static inline __m128 quat_mul_m128(__m128 q1, __m128 q2)
+    {
+        __m128 result = _mm_mul_ps(quat_swizzle(q1, 3, 3, 3, 3), q2);
+        result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(quat_swizzle(q1, 0, 0, 0, 0), quat_swizzle(q2, 3, 2, 1, 0)), _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)));
+        result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(quat_swizzle(q1, 1, 1, 1, 1), quat_swizzle(q2, 2, 3, 0, 1)), _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f)));
+        result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(quat_swizzle(q1, 2, 2, 2, 2), quat_swizzle(q2, 1, 0, 3, 2)), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f)));
+        return result;
+    }
+
+    HIT_TARGET_SSE41 static inline __m128 quat_rotate_m128(__m128 q, __m128 v)
+    {
+        __m128 t = vec3_cross(q, v);
+        t = _mm_add_ps(t, t);
+
+        return _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(quat_swizzle(q, 3, 3, 3, 3), t)), vec3_cross(q, t));
+    }
+
+    HIT_TARGET_SSE41 static Quat quat_mul_sse41(const Quat& q1, const Quat& q2)
+    {
+        Quat out_q;
+        _mm_storeu_ps(out_q.elements, quat_mul_m128(_mm_loadu_ps(q1.elements), _mm_loadu_ps(q2.elements)));
+        return out_q;
+    }
+
+    HIT_TARGET_SSE41 static Vec3 quat_rotate_sse41(const Quat& q, const Vec3& v)
+    {
+        Vec3 out_v;
+        store_vec3(out_v, quat_rotate_m128(_mm_loadu_ps(q.elements), load_vec3(v)));
+        return out_v;
+    }
+
+    HIT_TARGET_SSE41 static Transform transform_mul_sse41(const Transform& parent, const Transform& child)
+    {
+        const __m128 rotation = _mm_loadu_ps(parent.rotation.elements);
+        const __m128 scale = load_vec3(parent.scale);
+
+        Transform out_t;
+        store_vec3(out_t.translation, _mm_add_ps(load_vec3(parent.translation), quat_rotate_m128(rotation, _mm_mul_ps(scale, load_vec3(child.translation)))));
+        _mm_storeu_ps(out_t.rotation.elements, quat_mul_m128(rotation, _mm_loadu_ps(child.rotation.elements)));
+        store_vec3(out_t.scale, _mm_mul_ps(scale, load_vec3(child.scale)));
+        return out_t;
+    }
+
+    HIT_TARGET_SSE41 static Transform transform_inverse_sse41(const Transform& t)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        // the unused lane is kept at 1 so it doesn't divide by 0
+        const __m128 scale = _mm_div_ps(one, _mm_blend_ps(load_vec3(t.scale), one, 8));
+        const __m128 rotation = _mm_xor_ps(_mm_loadu_ps(t.rotation.elements), _mm_setr_ps(-0.0f, -0.0f, -0.0f, 0.0f));
+        const __m128 translation = _mm_xor_ps(load_vec3(t.translation), _mm_set1_ps(-0.0f));
+
+        Transform out_t;
+        store_vec3(out_t.translation, _mm_mul_ps(scale, quat_rotate_m128(rotation, translation)));
+        _mm_storeu_ps(out_t.rotation.elements, rotation);
+        store_vec3(out_t.scale, scale);
+        return out_t;
+    }
+
+    // each rotation column is its axis plus two products of the rotation with the doubled rotation
+    HIT_TARGET_SSE41 static Mat4 transform_to_mat4_sse41(const Transform& t)
+    {
+        const __m128 q = _mm_loadu_ps(t.rotation.elements);
+        const __m128 q2 = _mm_add_ps(q, q);
+        const __m128 scale = load_vec3(t.scale);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 c0 = _mm_add_ps(
+            _mm_xor_ps(_mm_mul_ps(quat_swizzle(q, 1, 0, 0, 3), quat_swizzle(q2, 1, 1, 2, 3)), _mm_setr_ps(-0.0f, 0.0f, 0.0f, 0.0f)),
+            _mm_xor_ps(_mm_mul_ps(quat_swizzle(q, 2, 3, 3, 3), quat_swizzle(q2, 2, 2, 1, 3)), _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f)));
+
+        __m128 c1 = _mm_add_ps(
+            _mm_xor_ps(_mm_mul_ps(quat_swizzle(q, 1, 0, 1, 3), quat_swizzle(q2, 0, 0, 2, 3)), _mm_setr_ps(0.0f, -0.0f, 0.0f, 0.0f)),
+            _mm_xor_ps(_mm_mul_ps(quat_swizzle(q, 3, 2, 3, 3), quat_swizzle(q2, 2, 2, 0, 3)), _mm_setr_ps(-0.0f, -0.0f, 0.0f, 0.0f)));
+
+        __m128 c2 = _mm_add_ps(
+            _mm_xor_ps(_mm_mul_ps(quat_swizzle(q, 2, 2, 0, 3), quat_swizzle(q2, 0, 1, 0, 3)), _mm_setr_ps(0.0f, 0.0f, -0.0f, 0.0f)),
+            _mm_xor_ps(_mm_mul_ps(quat_swizzle(q, 3, 3, 1, 3), quat_swizzle(q2, 1, 0, 1, 3)), _mm_setr_ps(0.0f, -0.0f, -0.0f, 0.0f)));
+
+        c0 = _mm_mul_ps(_mm_blend_ps(_mm_add_ps(c0, _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f)), zero, 8), quat_swizzle(scale, 0, 0, 0, 0));
+        c1 = _mm_mul_ps(_mm_blend_ps(_mm_add_ps(c1, _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f)), zero, 8), quat_swizzle(scale, 1, 1, 1, 1));
+        c2 = _mm_mul_ps(_mm_blend_ps(_mm_add_ps(c2, _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f)), zero, 8), quat_swizzle(scale, 2, 2, 2, 2));
+
+        Mat4 out_m;
+        _mm_storeu_ps(out_m.data, c0);
+        _mm_storeu_ps(out_m.data + 4, c1);
+        _mm_storeu_ps(out_m.data + 8, c2);
+        _mm_storeu_ps(out_m.data + 12, _mm_blend_ps(load_vec3(t.translation), _mm_set1_ps(1.0f), 8));
+        return out_m;
+    }
+#endif
+
+    struct TransformKernels
+    {
+        Quat (*quat_mul)(const Quat& q1, const Quat& q2);
+        Vec3 (*quat_rotate)(const Quat& q, const Vec3& v);
+
+        Transform (*mul)(const Transform& parent, const Transform& child);
+        Transform (*inverse)(const Transform& t);
+        Mat4 (*to_mat4)(const Transform& t);
+    };
+
+    static constexpr TransformKernels s_transform_scalar_kernels =
+    {
+        quat_mul_scalar, quat_rotate_scalar,
+        transform_mul_scalar, transform_inverse_scalar, transform_to_mat4_scalar
+    };
+
+    // indexed by SimdLevel, a quaternion fills one sse register so avx2 shares the sse4.1 kernels
+    static constexpr TransformKernels s_transform_kernels[(ui32)SimdLevel::Count] =
+    {
+        s_transform_scalar_kernels,
+#ifdef HIT_SIMD_X64
+        {
+            quat_mul_sse41, quat_rotate_sse41,
+            transform_mul_sse41, transform_inverse_sse41, transform_to_mat4_sse41
+        },
+        {
+            quat_mul_sse41, quat_rotate_sse41,
+            transform_mul_sse41, transform_inverse_sse41, transform_to_mat4_sse41
+        },
+#else
+        s_transform_scalar_kernels,
+        s_transform_scalar_kernels,
+#endif
+    };
+
+    static inline const TransformKernels& get_transform_kernels()
+    {
+        return s_transform_kernels[(ui32)get_simd_level()];
+    }
+
+    // Quat helper functions
+    Quat quat_identity()
+    {
+        return Quat();
+    }
+
+    Quat quat_from_axis_angle(const Vec3& axis, f32 angle)
+    {
+        const auto half_angle = to_rad(angle) * 0.5f;
+        const auto half_sin = hsin(half_angle);
+
+        return { axis.x * half_sin, axis.y * half_sin, axis.z * half_sin, hcos(half_angle) };
+    }
+
+    Quat quat_from_euler(const Vec3& v)
+    {
+        return quat_from_euler(v.x, v.y, v.z);
+    }
+
+    // x * y * z multiplied out, the order of mat4_euler_rotation
+    Quat quat_from_euler(f32 x, f32 y, f32 z)
+    {
+        const auto half_x = to_rad(x) * 0.5f;
+        const auto half_y = to_rad(y) * 0.5f;
+        const auto half_z = to_rad(z) * 0.5f;
+
+        const auto sin_x = hsin(half_x);
+        const auto cos_x = hcos(half_x);
+        const auto sin_y = hsin(half_y);
+        const auto cos_y = hcos(half_y);
+        const auto sin_z = hsin(half_z);
+        const auto cos_z = hcos(half_z);
+
+        const Quat xy(sin_x * cos_y, cos_x * sin_y, sin_x * sin_y, cos_x * cos_y);
+
+        return {
+            xy.x * cos_z + xy.y * sin_z,
+            xy.y * cos_z - xy.x * sin_z,
+            xy.w * sin_z + xy.z * cos_z,
+            xy.w * cos_z - xy.z * sin_z
+        };
+    }
+
+    Quat quat_mul(const Quat& q1, const Quat& q2)
+    {
+        return get_transform_kernels().quat_mul(q1, q2);
+    }
+
+    Vec3 quat_rotate(const Quat& q, const Vec3& v)
+    {
+        return get_transform_kernels().quat_rotate(q, v);
+    }
+
+    // q and -q are the same rotation, q2 is flipped when that is closer to q1
+    Quat quat_nlerp(const Quat& q1, const Quat& q2, f32 t)
+    {
+        const f32 t1 = 1.0f - t;
+        const f32 t2 = q1.dot(q2) < 0.0f ? -t : t;
+
+        Quat out_q(q1.x * t1 + q2.x * t2, q1.y * t1 + q2.y * t2, q1.z * t1 + q2.z * t2, q1.w * t1 + q2.w * t2);
+        return out_q.normalize();
+    }
+
+    Quat quat_slerp(const Quat& q1, const Quat& q2, f32 t)
+    {
+        const f32 cos_angle = q1.dot(q2);
+        const f32 sign = cos_angle < 0.0f ? -1.0f : 1.0f;
+
+        // sin of the angle goes to 0 for close rotations, nlerp is as good there
+        if (cos_angle * sign > 0.9995f) return quat_nlerp(q1, q2, t);
+
+        const f32 angle = hacos(cos_angle * sign);
+        const f32 sin_angle = hsin(angle);
+
+        const f32 t1 = hsin((1.0f - t) * angle) / sin_angle;
+        const f32 t2 = hsin(t * angle) / sin_angle * sign;
+
+        return { q1.x * t1 + q2.x * t2, q1.y * t1 + q2.y * t2, q1.z * t1 + q2.z * t2, q1.w * t1 + q2.w * t2 };
+    }
+
+    Mat4 quat_to_mat4(const Quat& q)
+    {
+        Transform t;
+        t.rotation = q;
+
+        return get_transform_kernels().to_mat4(t);
+    }
+
+    // Transform helper functions
+    Transform transform_identity()
+    {
+        return Transform();
+    }
+
+    Transform transform_mul(const Transform& parent, const Transform& child)
+    {
+        return get_transform_kernels().mul(parent, child);
+    }
+
+    Transform transform_inverse(const Transform& t)
+    {
+        return get_transform_kernels().inverse(t);
+    }
+
+    Transform transform_lerp(const Transform& t1, const Transform& t2, f32 t)
+    {
+        Transform out_t;
+        out_t.translation = t1.translation + (t2.translation - t1.translation) * t;
+        out_t.rotation = quat_nlerp(t1.rotation, t2.rotation, t);
+        out_t.scale = t1.scale + (t2.scale - t1.scale) * t;
+        return out_t;
+    }
+
+    Vec3 transform_point(const Transform& t, const Vec3& v)
+    {
+        return t.translation + get_transform_kernels().quat_rotate(t.rotation, t.scale * v);
+    }
+
+    Mat4 transform_to_mat4(const Transform& t)
+    {
+        return get_transform_kernels().to_mat4(t);
+    }
+
+    void transform_to_mat4_batch(std::span<const Transform> transforms, std::span<Mat4> out_m)
+    {
+        hit_assert(out_m.size() == transforms.size(), "Transform and matrix arrays must have the same size!");
+
+        const auto to_mat4 = get_transform_kernels().to_mat4;
+        for (ui64 i = 0; i < transforms.size(); i++) out_m[i] = to_mat4(transforms[i]);
+    }
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "File/File.h"
 #include "File/SerialFile.h"
 #include "Utils/Serializer.h"
+#include "Utils/Arena.h"
 
 #include <filesystem>
 
@@ -62,6 +63,9 @@ namespace hit
 
         for(auto& file : files)
         {
+            // per file temporaries
+            ArenaScope scratch_scope(get_scratch_arena());
+
             File file_content;
             if(!file_read(file, File::Text, file_content))
             {
@@ -77,7 +81,7 @@ namespace hit
                 continue;
             }
 
-            std::vector<ShaderSource> shader_sources;
+            ArenaVector<ShaderSource> shader_sources(&scratch_scope.arena());
 
             if(parser.has_shader_type(ShaderProgram::Vertex))
             {
@@ -89,7 +93,7 @@ namespace hit
                 shader_sources.push_back(parser.read_shader(ShaderProgram::Fragment));
             }
 
-            std::vector<ShaderProgram> compiled_shaders;
+            ArenaVector<ShaderProgram> compiled_shaders(&scratch_scope.arena());
             for(const auto& source : shader_sources)
             {
                 compiled_shaders.push_back(compile_shader_source(source));
@@ -124,12 +124,12 @@ namespace hit
 
 	std::string ShaderParser::get_shader_name()
 	{
-		return m_config.get_block("Shader")->get_property("name").get_single_value().get_string();
+		return std::string(m_config.get_block("Shader")->get_property("name").get_single_value().get_string());
 	}
 
 	std::string ShaderParser::get_pass_name()
 	{
-		return m_config.get_block("Shader")->get_property("pass").get_single_value().get_string();
+		return std::string(m_config.get_block("Shader")->get_property("pass").get_single_value().get_string());
 	}
 
 	bool ShaderParser::has_shader_type(ShaderProgram::Type type)
@@ -173,7 +173,7 @@ namespace hit
 					if (property.is_single() && property.get_single_value().is_string())
 					{
 						auto data = helper::str_to_shader_data(property.get_single_value().get_string());
-						attributes_layout.push_back({ data, identifier });
+						attributes_layout.push_back({ data, std::string(identifier) });
 					}
 					else
 					{
@@ -198,7 +198,7 @@ namespace hit
 					if (property.is_single() && property.get_single_value().is_string())
 					{
 						auto data = helper::str_to_shader_data(property.get_single_value().get_string());
-						layout.push_back({ data, identifier });
+						layout.push_back({ data, std::string(identifier) });
 					}
 					else
 					{
@@ -244,7 +244,7 @@ namespace hit
 						if (property.is_single() && property.get_single_value().is_string())
 						{
 							auto data = helper::str_to_shader_data(property.get_single_value().get_string());
-							layout.push_back({ data, identifier });
+							layout.push_back({ data, std::string(identifier) });
 						}
 					}
 
@@ -298,7 +298,7 @@ namespace hit
 						if (property.is_single() && property.get_single_value().is_string())
 						{
 							auto data = helper::str_to_shader_data(property.get_single_value().get_string());
-							layout.push_back({ data, identifier });
+							layout.push_back({ data, std::string(identifier) });
 						}
 					}
 
@@ -1,6 +1,7 @@
 #include "Shader/ShaderCompiler.h"
 #include "Core/Memory.h"
 #include "Core/Log.h"
+#include "Utils/Arena.h"
 
 using namespace hit;
 
@@ -70,6 +71,8 @@ int main(int argc, char** argv)
 
     // shutting down core systems
     {
+        release_scratch_arena();
+
         if(!Memory::shutdown_memory_system())
         {
             hit_error("Memory leak detected!");
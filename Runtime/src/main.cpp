@@ -1,7 +1,25 @@
 #include "HitEngineEntry.h"
 
+#include <charconv>
+#include <string_view>
+
 namespace hit
 {
+    // reads the value of an option given as "--option value", an invalid value leaves out_value as it was.
+    // it runs before the log system is up, so nothing is logged
+    static bool read_option(int argc, char** argv, std::string_view option, ui32& out_value)
+    {
+        for(int i = 1; i + 1 < argc; i++)
+        {
+            if(option != argv[i]) continue;
+
+            const std::string_view value = argv[i + 1];
+            return std::from_chars(value.data(), value.data() + value.size(), out_value).ec == std::errc();
+        }
+
+        return false;
+    }
+
     int hit_main(int argc, char** argv)
     {
         Engine engine;
@@ -19,6 +37,11 @@ namespace hit
             data.renderer_config.vsync = true;
             data.renderer_config.power_save_mode = false;
 
+            // memory diagnostics, e.g. --memory-snapshot-interval 600 --memory-trace-sample-rate 64
+            read_option(argc, argv, "--memory-snapshot-interval", data.memory_snapshot_interval);
+            read_option(argc, argv, "--memory-trace-sample-rate", data.memory_trace_sample_rate);
+            read_option(argc, argv, "--memory-statistics-interval", data.memory_statistics_interval);
+
             if(!engine.initialize(data))
             {
                 hit_fatal("Failed to initialize engine!");
@@ -6,12 +6,14 @@
 
 #include "Core/Log.h"
 #include "Core/Memory.h"
+#include "Utils/Arena.h"
 
 #include <vector>
 #include <utility>
 #include <iostream>
 #include <ctime>
 #include <cstdlib>
+#include <chrono>
 
 #define test_check(condition) { if(!(condition)) { return hit::TEST_ERROR; } else { hit_info("Test({}) success.", #condition); } }
 #define test_expect(condition, expct) { if((condition) != (expct)) { return hit::TEST_ERROR; } else { hit_info("Test({}) success.", #condition); } }
@@ -26,6 +28,8 @@
 
 #define get_test(test) #test, &test
 
+#define test_benchmark(name, ...) hit_info("Benchmark({}): {:.3f}ms", name, hit::test_measure_ms([&]() { __VA_ARGS__; }))
+
 namespace hit
 {
     using test_val = int;
@@ -41,6 +45,24 @@ namespace hit
 
     using TestFuntion = test_val(*)();
 
+    // a 64 bit lcg, the same seed gives the same sequence on every run and platform.
+    // advances state and returns it, the high bits are the most random ones
+    inline ui64 test_random(ui64& state)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state;
+    }
+
+    template<typename Function>
+    f64 test_measure_ms(Function&& function)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        function();
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        return std::chrono::duration<f64, std::milli>(end - start).count();
+    }
+
     struct TestSystem
     {
         std::vector<std::pair<const char*, TestFuntion>> tests;
@@ -55,6 +77,7 @@ namespace hit
 
         void shutdown()
         {
+            release_scratch_arena();
             Memory::shutdown_memory_system();
             Log::shutdown_log_system();
         }
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Utils/TypedArena.h"
+#include "Utils/FastTypedArena.h"
+#include "Utils/ConcurrentArena.h"
+#include "File/StandardConfigurationFile.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hit
+{
+    struct ArenaBenchmarkValue
+    {
+        ui64 id;
+        f32 values[14];
+    };
+
+    constexpr ui64 arena_benchmark_stream_size = 2000000;
+
+    template<typename ArenaType>
+    void arena_benchmark_push_stream(ArenaType& arena)
+    {
+        for(ui64 i = 0; i < arena_benchmark_stream_size; i++)
+        {
+            auto value = arena.push_back();
+            value->id = i;
+        }
+    }
+
+    test_val arena_benchmark_push_back_stream()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        test_benchmark("realloc TypedArena push_back", 
+        {
+            TypedArena<ArenaBenchmarkValue> arena(16);
+            arena_benchmark_push_stream(arena);
+        });
+
+        test_benchmark("virtual TypedArena push_back", 
+        {
+            TypedArena<ArenaBenchmarkValue> arena;
+            arena.create_virtual(arena_benchmark_stream_size);
+            arena_benchmark_push_stream(arena);
+        });
+
+        test_benchmark("realloc FastTypedArena push_back", 
+        {
+            FastTypedArena<ArenaBenchmarkValue> arena(16);
+            arena_benchmark_push_stream(arena);
+        });
+
+        test_benchmark("virtual FastTypedArena push_back", 
+        {
+            FastTypedArena<ArenaBenchmarkValue> arena;
+            arena.create_virtual(arena_benchmark_stream_size);
+            arena_benchmark_push_stream(arena);
+        });
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    constexpr ui64 arena_benchmark_element_count = 200000;
+
+    // pushes, copies and moves a container, for trivially copyable and non trivial element types
+    template<typename Container, typename Make>
+    void arena_benchmark_container(const char* name, Container&& container, Make&& make, ui64& checksum)
+    {
+        test_benchmark(std::format("{} push_back", name),
+        {
+            for(ui64 i = 0; i < arena_benchmark_element_count; i++) container.push_back(make(i));
+        });
+
+        test_benchmark(std::format("{} copy", name),
+        {
+            for(ui32 i = 0; i < 10; i++)
+            {
+                auto copy = container;
+                checksum += copy.size();
+            }
+        });
+
+        test_benchmark(std::format("{} move", name),
+        {
+            for(ui32 i = 0; i < 10; i++)
+            {
+                auto moved = std::move(container);
+                container = std::move(moved);
+            }
+        });
+
+        checksum += container.size();
+    }
+
+    test_val arena_benchmark_element_types()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        auto make_value = [](ui64 i) { return ArenaBenchmarkValue{ i }; };
+        auto make_string = [](ui64 i) { return std::format("a string long enough to be on the heap {}", i); };
+
+        ui64 checksum = 0;
+
+        arena_benchmark_container("trivial std::vector", std::vector<ArenaBenchmarkValue>(), make_value, checksum);
+        arena_benchmark_container("trivial TypedArena", TypedArena<ArenaBenchmarkValue>(16), make_value, checksum);
+        arena_benchmark_container("trivial FastTypedArena", FastTypedArena<ArenaBenchmarkValue>(16), make_value, checksum);
+
+        arena_benchmark_container("std::string std::vector", std::vector<std::string>(), make_string, checksum);
+        arena_benchmark_container("std::string TypedArena", TypedArena<std::string>(16), make_string, checksum);
+
+        test_check(checksum == 5 * 11 * arena_benchmark_element_count);
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    constexpr ui64 arena_benchmark_concurrent_push_count = 400000;
+
+    // the total work is the same for every thread count, so a flat time means linear scaling
+    template<typename Push>
+    void arena_benchmark_concurrent_workload(ui32 thread_count, Push&& push)
+    {
+        std::vector<std::thread> threads;
+
+        for(ui32 t = 0; t < thread_count; t++)
+        {
+            threads.emplace_back([&]()
+            {
+                for(ui64 i = 0; i < arena_benchmark_concurrent_push_count / thread_count; i++)
+                {
+                    auto memory = push(16 + (i % 4) * 16);
+                    memory[0] = (ui8)i;
+                }
+            });
+        }
+
+        for(auto& thread : threads) thread.join();
+    }
+
+    test_val arena_benchmark_concurrent_scaling()
+    {
+        constexpr ui64 block_size = 4 * 1024 * 1024;
+        const ui32 max_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        for(ui32 thread_count = 1; thread_count <= max_thread_count; thread_count *= 2)
+        {
+            {
+                Arena arena(block_size);
+                std::mutex mutex;
+
+                test_benchmark(std::format("locked Arena, {} threads", thread_count), 
+                    arena_benchmark_concurrent_workload(thread_count, [&](ui64 size)
+                    {
+                        std::lock_guard lock(mutex);
+                        return arena.push_memory(size);
+                    }));
+            }
+
+            {
+                ConcurrentArena arena(block_size, MemoryUsage::Any, 0);
+
+                test_benchmark(std::format("ConcurrentArena fetch add, {} threads", thread_count), 
+                    arena_benchmark_concurrent_workload(thread_count, [&](ui64 size) { return arena.push_memory(size); }));
+            }
+
+            {
+                ConcurrentArena arena(block_size);
+
+                test_benchmark(std::format("ConcurrentArena thread cache, {} threads", thread_count), 
+                    arena_benchmark_concurrent_workload(thread_count, [&](ui64 size) { return arena.push_memory(size); }));
+            }
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    static std::string arena_benchmark_config_source()
+    {
+        std::string source;
+
+        for(ui32 i = 0; i < 200; i++)
+        {
+            source += std::format("material_{} {{\n", i);
+            source += "    name: \"Material name\"\n    shader: Standard\n";
+            source += "    color: [1.0, 0.8, 0.8, 1.0]\n    roughness: 0.5\n";
+            source += "    textures {\n        albedo: \"albedo.png\"\n        normal: \"normal.png\"\n    }\n";
+            source += "    code::\n    {\n        // shader code\n    }\n}\n";
+        }
+
+        return source;
+    }
+
+    test_val arena_benchmark_config_parsing()
+    {
+        constexpr ui32 rounds = 50;
+        const std::string source = arena_benchmark_config_source();
+
+        ui64 block_count = 0;
+
+        test_benchmark("config parser, heap temporaries", 
+        {
+            for(ui32 i = 0; i < rounds; i++)
+            {
+                config::Parser parser(source);
+                block_count += parser.build_block_tree().size();
+            }
+        });
+
+        test_benchmark("config parser, scratch temporaries", 
+        {
+            for(ui32 i = 0; i < rounds; i++)
+            {
+                ArenaScope scratch_scope(get_scratch_arena());
+                config::Parser parser(source, &scratch_scope.arena());
+                block_count += parser.build_block_tree().size();
+            }
+        });
+
+        test_benchmark("StandardConfigurationFile", 
+        {
+            for(ui32 i = 0; i < rounds; i++)
+            {
+                config::StandardConfigurationFile configuration(source);
+                block_count += configuration.has_block("material_0");
+            }
+        });
+
+        test_check(block_count == rounds * 401);
+
+        test_success();
+    }
+
+    void add_arena_benchmarks(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(arena_benchmark_push_back_stream));
+        test_system.add_test(get_test(arena_benchmark_element_types));
+        test_system.add_test(get_test(arena_benchmark_concurrent_scaling));
+        test_system.add_test(get_test(arena_benchmark_config_parsing));
+    }
+}
\ No newline at end of file
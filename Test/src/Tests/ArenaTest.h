@@ -0,0 +1,268 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Utils/Arena.h"
+#include "Utils/TypedArena.h"
+#include "Utils/FastTypedArena.h"
+#include "Utils/MemoryResource.h"
+#include "File/StandardConfigurationFile.h"
+
+#include <array>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace hit
+{
+    test_val arena_scope_test()
+    {
+        Arena arena(1024, MemoryUsage::Any, { true, 64 });
+        arena.push_memory(16);
+
+        {
+            ArenaScope scope(arena);
+            arena.push_memory(100);
+
+            {
+                ArenaScope inner_scope(arena);
+                arena.push_memory(200, 64);
+                test_check(arena.size() >= 316);
+            }
+
+            test_check(arena.size() == 116);
+        }
+
+        test_check(arena.size() == 16);
+
+        test_success();
+    }
+
+    struct ArenaScopeCounter
+    {
+        static inline i32 alive = 0;
+
+        ArenaScopeCounter() { alive++; }
+        ArenaScopeCounter(const ArenaScopeCounter& other) { alive++; }
+        ~ArenaScopeCounter() { alive--; }
+    };
+
+    test_val typed_arena_scope_test()
+    {
+        TypedArena<ArenaScopeCounter> t_arena(8);
+        t_arena.emplace_back();
+
+        {
+            ArenaScope scope(t_arena);
+            for(auto i = 0; i < 20; i++) t_arena.emplace_back();
+
+            test_check(ArenaScopeCounter::alive == 21);
+        }
+
+        // elements pushed inside the scope were destroyed
+        test_check(t_arena.size() == 1);
+        test_check(ArenaScopeCounter::alive == 1);
+
+        test_success();
+    }
+
+    test_val scratch_arena_test()
+    {
+        auto& scratch = get_scratch_arena();
+        test_check(scratch.is_virtual());
+
+        const ui64 marker = scratch.get_marker();
+
+        {
+            ArenaScope scope(scratch);
+
+            ArenaVector<ui64> values(&scope.arena());
+            for(ui64 i = 0; i < 10000; i++) values.push_back(i);
+
+            for(ui64 i = 0; i < 10000; i++) test_silent_check(values[i] == i);
+        }
+
+        test_check(scratch.get_marker() == marker);
+
+        // without an arena it uses the memory system
+        ArenaVector<ui64> heap_values;
+        for(ui64 i = 0; i < 100; i++) heap_values.push_back(i);
+
+        test_check(scratch.get_marker() == marker);
+
+        test_success();
+    }
+
+    // pushing over a usage hard limit fails and leaves the arenas as they were
+    test_val arena_hard_limit_test()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Platform);
+
+        {
+            Arena arena(256, MemoryUsage::Platform);
+            TypedArena<ui64> t_arena(8, MemoryUsage::Platform);
+            FastTypedArena<ui64> ft_arena(8, MemoryUsage::Platform);
+
+            Memory::set_usage_budget(MemoryUsage::Platform, { 0, Memory::get_memory_used(MemoryUsage::Platform) + 1024 });
+
+            test_check(arena.push_memory(200));
+            test_check(!arena.push_memory(2000));
+            test_check(arena.size() == 200 && arena.capacity() == 256);
+            test_check(!arena.increment_memory(2000));
+
+            ui64 pushed = 0;
+            while(t_arena.push_back(pushed)) pushed++;
+
+            test_check(pushed >= 8 && pushed < 256);
+            test_check(t_arena.size() == pushed && *t_arena[pushed - 1] == pushed - 1);
+            test_check(!ft_arena.push_array(1024));
+            test_check(ft_arena.size() == 0);
+
+            Memory::set_usage_budget(MemoryUsage::Platform, { });
+        }
+
+        {
+            Arena arena;
+            test_check(arena.create_virtual(1024 * 1024, MemoryUsage::Platform));
+
+            // virtual arenas commit 64KB at a time
+            Memory::set_usage_budget(MemoryUsage::Platform, { 0, Memory::get_memory_used(MemoryUsage::Platform) + 100 * 1024 });
+
+            ui8* memory = arena.push_memory(1000);
+            test_check(memory);
+            memory[999] = 1;
+
+            test_check(!arena.push_memory(70000));
+            test_check(arena.size() == 1000 && arena.committed() == 64 * 1024);
+
+            // what is committed can still be used
+            memory = arena.push_memory(1000);
+            test_check(memory);
+            memory[999] = 1;
+
+            Memory::set_usage_budget(MemoryUsage::Platform, { });
+
+            test_check(arena.push_memory(70000));
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Platform) == memory_used);
+
+        test_success();
+    }
+
+    test_val memory_resource_test()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Renderer);
+
+        // monotonic, everything goes away with the scope
+        {
+            ArenaScope scratch_scope(get_scratch_arena());
+            ArenaMemoryResource resource(scratch_scope.arena());
+
+            std::pmr::vector<ui64> values(&resource);
+            for(ui64 i = 0; i < 1000; i++) values.push_back(i);
+
+            test_check(scratch_scope.arena().size() >= 1000 * sizeof(ui64));
+        }
+
+        test_check(get_scratch_arena().size() == 0);
+
+        // tagged, bytes are accounted to the usage while alive
+        {
+            std::pmr::map<std::pmr::string, ui64> values(get_usage_memory_resource(MemoryUsage::Renderer));
+            for(ui64 i = 0; i < 100; i++) values.emplace(std::format("a key long enough to be on the heap {}", i), i);
+
+            test_check(Memory::get_memory_used(MemoryUsage::Renderer) > memory_used);
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Renderer) == memory_used);
+
+        // pooled
+        {
+            PoolMemoryResource pool(MemoryUsage::Renderer);
+            std::pmr::vector<std::pmr::string> values(&pool);
+            for(ui64 i = 0; i < 100; i++) values.emplace_back(std::format("a string long enough to be on the heap {}", i));
+
+            const std::string expected = std::format("a string long enough to be on the heap {}", 99);
+            test_check(values[99] == std::string_view(expected));
+            test_check(Memory::get_memory_used(MemoryUsage::Renderer) > memory_used);
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Renderer) == memory_used);
+
+        // registered tags have their own resource too
+        {
+            const auto tag = Memory::register_usage_tag("Resource_Tag");
+            const ui64 tag_memory_used = Memory::get_memory_used(tag);
+
+            PoolMemoryResource pool(tag);
+            std::pmr::vector<ui64> values(&pool);
+            for(ui64 i = 0; i < 1000; i++) values.push_back(i);
+
+            test_check(get_usage_memory_resource(tag)->usage() == tag);
+            test_check(Memory::get_memory_used(tag) > tag_memory_used);
+        }
+
+        // over the hard limit it throws like the default resource, containers can't handle null
+        Memory::set_usage_budget(MemoryUsage::Renderer, { 0, memory_used + 1024 });
+
+        bool thrown = false;
+        try
+        {
+            std::pmr::vector<ui8> values(4096, get_usage_memory_resource(MemoryUsage::Renderer));
+        }
+        catch(const std::bad_alloc&)
+        {
+            thrown = true;
+        }
+
+        auto initialized = Memory::allocate_initialized_memory<std::array<ui8, 4096>>(MemoryUsage::Renderer);
+
+        Memory::set_usage_budget(MemoryUsage::Renderer, { });
+
+        test_check(!initialized);
+        test_check(thrown);
+        test_check(Memory::get_memory_used(MemoryUsage::Renderer) == memory_used);
+
+        test_success();
+    }
+
+    test_val memory_resource_config_test()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Renderer);
+
+        {
+            config::StandardConfigurationFile configuration(R"(
+            material {
+                name: "Material name"
+                color: [1.0, 0.8, 0.8, 1.0]
+                textures {
+                    albedo: "albedo.png"
+                }
+            })", MemoryUsage::Renderer);
+
+            // the whole configuration is accounted to its usage
+            test_check(Memory::get_memory_used(MemoryUsage::Renderer) > memory_used);
+
+            auto material = configuration.get_block("material");
+            test_check(material);
+            test_check(material->get_property("name").get_single_value().get_string() == "Material name");
+            test_check(material->get_property("color").get_list_value().size() == 4);
+            test_check(material->get_inner_block("textures")->has_property("albedo"));
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Renderer) == memory_used);
+
+        test_success();
+    }
+
+    void add_arena_tests(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(arena_scope_test));
+        test_system.add_test(get_test(typed_arena_scope_test));
+        test_system.add_test(get_test(scratch_arena_test));
+        test_system.add_test(get_test(arena_hard_limit_test));
+        test_system.add_test(get_test(memory_resource_test));
+        test_system.add_test(get_test(memory_resource_config_test));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Utils/ConcurrentArena.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace hit
+{
+    test_val concurrent_arena_test_1()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        {
+            ConcurrentArena arena;
+            test_check(arena.create(1024));
+            test_check(arena.block_count() == 1);
+
+            auto value = (ui64*)arena.push_memory(sizeof(ui64));
+            *value = 42;
+
+            auto aligned = arena.push_memory(24, 64);
+            test_check((ui64)aligned % 64 == 0);
+
+            // pushing more than a block chains a new one, the old memory stays where it was
+            auto big = arena.push_memory(4096);
+            test_check(big);
+            test_check(arena.block_count() >= 2);
+            test_check(*value == 42);
+
+            // reset merges the chain in one block
+            const ui64 capacity = arena.capacity();
+            arena.reset();
+
+            test_check(arena.block_count() == 1);
+            test_check(arena.capacity() == capacity);
+            test_check(arena.size() == 0);
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    // every thread writes its own pattern, any overlapping push would be overwritten by another thread
+    test_val concurrent_arena_threads_test()
+    {
+        constexpr ui32 thread_count = 8;
+        constexpr ui64 push_count = 20000;
+
+        for(ui64 thread_cache_size : { (ui64)0, ConcurrentArena::default_thread_cache_size })
+        {
+            ConcurrentArena arena(64 * 1024, MemoryUsage::Any, thread_cache_size);
+
+            std::vector<std::vector<ui64*>> pushes(thread_count);
+            std::vector<std::thread> threads;
+
+            for(ui32 t = 0; t < thread_count; t++)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    for(ui64 i = 0; i < push_count; i++)
+                    {
+                        const ui64 count = 1 + i % 7;
+                        auto values = (ui64*)arena.push_memory(count * sizeof(ui64), alignof(ui64));
+
+                        for(ui64 j = 0; j < count; j++) values[j] = ((ui64)t << 32) | i;
+                        pushes[t].push_back(values);
+                    }
+                });
+            }
+
+            for(auto& thread : threads) thread.join();
+
+            for(ui32 t = 0; t < thread_count; t++)
+            {
+                for(ui64 i = 0; i < push_count; i++)
+                {
+                    auto values = pushes[t][i];
+                    for(ui64 j = 0; j < 1 + i % 7; j++) test_silent_check(values[j] == (((ui64)t << 32) | i));
+                }
+            }
+
+            arena.reset();
+            test_check(arena.block_count() == 1);
+        }
+
+        test_success();
+    }
+
+    void add_concurrent_arena_tests(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(concurrent_arena_test_1));
+        test_system.add_test(get_test(concurrent_arena_threads_test));
+    }
+}
\ No newline at end of file
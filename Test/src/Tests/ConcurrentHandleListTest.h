@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Utils/ConcurrentHandleList.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hit
+{
+    test_val concurrent_handle_list_test_1()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        {
+            ConcurrentHandleList<std::string> list(16);
+
+            std::vector<Handle<std::string>> handles;
+            for(auto i = 0; i < 100; i++)
+            {
+                handles.push_back(list.emplace(std::format("a string long enough to be on the heap {}", i)));
+                test_silent_check(handles.back().valid());
+            }
+
+            test_check(list.size() == 100);
+            test_check(*list.get(handles[42]) == "a string long enough to be on the heap 42");
+
+            // removed resources can't be got anymore, but they are still alive until collect
+            std::string* removed = list.get(handles[0]);
+
+            test_check(list.remove(handles[0]));
+            test_check(!list.remove(handles[0]));
+            test_check(!list.get(handles[0]));
+            test_check(*removed == "a string long enough to be on the heap 0");
+            test_check(list.size() == 99);
+
+            // the slot is reused after collect, the old handle doesn't match it
+            list.collect();
+
+            Handle<std::string> reused = list.add("reused");
+            test_check(reused.index() == handles[0].index() && reused.version() != handles[0].version());
+            test_check(!list.get(handles[0]));
+            test_check(*list.get(reused) == "reused");
+
+            test_check(!list.get({ }));
+            test_check(!list.get({ 100000, 1 }));
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    struct ConcurrentHandleListTestValue
+    {
+        ui64 id;
+        ui64 check;
+    };
+
+    // writers add and remove while readers get random shared handles, a value is never seen torn.
+    // collect runs between rounds, once every thread is joined
+    test_val concurrent_handle_list_threads_test()
+    {
+        constexpr ui32 writer_count = 4;
+        constexpr ui32 reader_count = 4;
+        constexpr ui64 add_count = 20000;
+        constexpr ui32 round_count = 4;
+
+        ConcurrentHandleList<ConcurrentHandleListTestValue> list(256);
+
+        std::vector<std::vector<Handle<ConcurrentHandleListTestValue>>> kept(writer_count);
+        std::vector<std::atomic<ui64>> shared(add_count);
+        std::atomic<ui32> failed = 0;
+
+        for(ui32 round = 0; round < round_count; round++)
+        {
+            for(auto& handle : shared) handle.store(invalid_handle_value, std::memory_order_relaxed);
+
+            std::atomic<ui32> writers_running = writer_count;
+            std::vector<std::thread> threads;
+
+            for(ui32 t = 0; t < writer_count; t++)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    for(ui64 i = 0; i < add_count; i++)
+                    {
+                        const ui64 id = ((ui64)round << 48) | ((ui64)t << 32) | i;
+                        auto handle = list.add({ id, ~id });
+
+                        auto value = list.get(handle);
+                        if(!value || value->id != id) failed++;
+
+                        shared[(i * writer_count + t) % add_count].store(handle.value, std::memory_order_release);
+
+                        // most handles are removed, kept ones can be removed by another writer through the shared ones
+                        if(i % 2 == 0 && i % 3) kept[t].push_back(handle);
+                        else list.remove(handle);
+
+                        if(i % 5 == 0)
+                        {
+                            const ui64 packed = shared[(i * 7) % add_count].load(std::memory_order_acquire);
+                            list.remove(Handle<ConcurrentHandleListTestValue>::from_value(packed));
+                        }
+                    }
+
+                    writers_running--;
+                });
+            }
+
+            for(ui32 t = 0; t < reader_count; t++)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    ui64 random = t + 1;
+                    while(writers_running.load(std::memory_order_relaxed))
+                    {
+                        test_random(random);
+
+                        const ui64 packed = shared[(random >> 33) % add_count].load(std::memory_order_acquire);
+                        if(packed == invalid_handle_value) continue;
+
+                        // removed values are still readable until collect
+                        auto value = list.get(Handle<ConcurrentHandleListTestValue>::from_value(packed));
+                        if(value && value->check != ~value->id) failed++;
+                    }
+                });
+            }
+
+            for(auto& thread : threads) thread.join();
+
+            list.collect();
+        }
+
+        test_check(failed == 0);
+
+        // the kept handles are the only alive ones, and every one of them is unique
+        ui64 kept_count = 0;
+        std::vector<bool> used_slots(list.slot_count());
+
+        for(ui32 t = 0; t < writer_count; t++)
+        {
+            for(auto handle : kept[t])
+            {
+                auto value = list.get(handle);
+                if(!value) continue;
+
+                test_silent_check(value->check == ~value->id);
+                test_silent_check(!used_slots[handle.index()]);
+
+                used_slots[handle.index()] = true;
+                kept_count++;
+            }
+        }
+
+        test_check(kept_count == list.size());
+
+        // freed slots were reused, the list didn't grow for every add
+        test_check(list.slot_count() < (ui64)round_count * writer_count * add_count);
+
+        test_success();
+    }
+
+    void add_concurrent_handle_list_tests(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(concurrent_handle_list_test_1));
+        test_system.add_test(get_test(concurrent_handle_list_threads_test));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Utils/FrameAllocator.h"
+
+#include <new>
+
+namespace hit
+{
+    test_val frame_allocator_test_1()
+    {
+        FrameAllocator allocator;
+        test_check(allocator.create(2, 1024 * 1024));
+
+        test_check(allocator.frame_count() == 2);
+        test_check(allocator.frame_used() == 0);
+
+        auto value = allocator.allocate_object<ui64>(42);
+        test_check(*value == 42);
+
+        auto aligned = allocator.allocate(24, 64);
+        test_check((ui64)aligned % 64 == 0);
+
+        auto values = allocator.allocate_array<f32>(100);
+        for(auto i = 0; i < 100; i++) test_silent_check(values[i] == 0.0f);
+
+        // previous frame memory survives one frame
+        allocator.begin_frame();
+        test_check(allocator.frame_used() == 0);
+        test_check(*value == 42);
+
+        allocator.begin_frame();
+        test_check(allocator.frame_used() == 0);
+
+        test_success();
+    }
+
+    test_val frame_allocator_high_water_mark_test()
+    {
+        FrameAllocator allocator(3, 1024 * 1024);
+
+        for(ui64 frame = 1; frame <= 10; frame++)
+        {
+            allocator.begin_frame();
+            allocator.allocate(frame * 1000);
+        }
+
+        allocator.begin_frame();
+
+        test_check(allocator.high_water_mark() == 10000);
+        test_check(allocator.frame_number() == 11);
+
+        // the current frame counts before it ends
+        allocator.allocate(20000);
+        test_check(allocator.high_water_mark() == 20000);
+
+        test_success();
+    }
+
+    test_val frame_allocator_stl_test()
+    {
+        FrameAllocator allocator(2, 1024 * 1024);
+
+        FrameVector<i32> values(&allocator);
+        for(auto i = 0; i < 1000; i++) values.push_back(i);
+
+        test_check(values.size() == 1000);
+        for(auto i = 0; i < 1000; i++) test_silent_check(values[i] == i);
+
+        // a container can't grow past the frame reserve
+        FrameVector<ui8> bytes(&allocator);
+
+        bool out_of_memory = false;
+        try
+        {
+            bytes.resize(2 * 1024 * 1024);
+        }
+        catch(const std::bad_alloc&)
+        {
+            out_of_memory = true;
+        }
+
+        test_check(out_of_memory && bytes.empty());
+
+        test_success();
+    }
+
+    void add_frame_allocator_tests(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(frame_allocator_test_1));
+        test_system.add_test(get_test(frame_allocator_high_water_mark_test));
+        test_system.add_test(get_test(frame_allocator_stl_test));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Utils/Freelist.h"
+#include "Utils/Tlsf.h"
+#include "Utils/Buddy.h"
+
+#include <vector>
+
+namespace hit
+{
+    struct FreelistBenchmarkResult
+    {
+        ui64 failed_count;
+        f64 fragmentation;
+    };
+
+    // a fixed set of allocation slots is randomly filled and freed, like meshes streamed in and out of a buffer.
+    // sizes are spread over powers of two from 16 bytes to 64KB, or are exactly them like texture tiles
+    template<typename Allocator>
+    FreelistBenchmarkResult freelist_benchmark_random(Allocator& allocator, ui64 slot_count, ui64 operation_count, bool power_of_two_sizes = false)
+    {
+        struct Slot { ui64 offset; ui64 size; };
+        std::vector<Slot> slots(slot_count, { 0, 0 });
+
+        ui64 random = 12345;
+        ui64 failed_count = 0;
+
+        for(ui64 i = 0; i < operation_count; i++)
+        {
+            test_random(random);
+            auto& slot = slots[(random >> 33) % slot_count];
+
+            if(slot.size)
+            {
+                allocator.pop_size(slot.size, slot.offset);
+                slot.size = 0;
+                continue;
+            }
+
+            const ui64 size_bits = 4 + (random >> 20) % 12;
+            const ui64 size = (1ull << size_bits) + (power_of_two_sizes ? 0 : (random >> 8) & ((1ull << size_bits) - 1));
+
+            if(allocator.push_size(size, slot.offset)) slot.size = size;
+            else failed_count++;
+        }
+
+        // how much of the free space can't be used by the biggest allocation
+        const f64 free_space = (f64)allocator.get_free_space();
+        const f64 fragmentation = free_space > 0 ? 1.0 - (f64)allocator.get_largest_free_block() / free_space : 0.0;
+
+        for(auto& slot : slots)
+        {
+            if(slot.size) allocator.pop_size(slot.size, slot.offset);
+        }
+
+        return { failed_count, fragmentation };
+    }
+
+    test_val freelist_benchmark_random_patterns()
+    {
+        constexpr ui64 buffer_size = 64 * 1024 * 1024;
+        constexpr ui64 operation_count = 200000;
+
+        for(ui64 slot_count : { (ui64)1000, (ui64)10000 })
+        {
+            FreelistBenchmarkResult results[2] = { };
+
+            FreelistCore freelist(buffer_size);
+            TlsfAllocator tlsf(buffer_size);
+
+            test_benchmark(std::format("FreelistCore random, {} slots", slot_count),
+                results[0] = freelist_benchmark_random(freelist, slot_count, operation_count));
+
+            test_benchmark(std::format("TlsfAllocator random, {} slots", slot_count),
+                results[1] = freelist_benchmark_random(tlsf, slot_count, operation_count));
+
+            hit_info("FreelistCore, {} slots: {} failed allocations, {:.1f}% fragmentation", slot_count, results[0].failed_count, results[0].fragmentation * 100.0);
+            hit_info("TlsfAllocator, {} slots: {} failed allocations, {:.1f}% fragmentation", slot_count, results[1].failed_count, results[1].fragmentation * 100.0);
+
+            // everything was given back
+            test_check(freelist.get_free_space() == buffer_size && freelist.get_largest_free_block() == buffer_size);
+            test_check(tlsf.get_free_space() == buffer_size && tlsf.get_largest_free_block() == buffer_size);
+        }
+
+        test_success();
+    }
+
+    test_val freelist_benchmark_power_of_two_patterns()
+    {
+        constexpr ui64 buffer_size = 64 * 1024 * 1024;
+        constexpr ui64 operation_count = 200000;
+
+        for(bool power_of_two_sizes : { true, false })
+        {
+            FreelistBenchmarkResult results[2] = { };
+
+            FreelistCore freelist(buffer_size);
+            BuddyAllocator buddy(buffer_size, 16);
+
+            const char* sizes_name = power_of_two_sizes ? "power of two sizes" : "any sizes";
+
+            test_benchmark(std::format("FreelistCore random, {}", sizes_name),
+                results[0] = freelist_benchmark_random(freelist, 10000, operation_count, power_of_two_sizes));
+
+            test_benchmark(std::format("BuddyAllocator random, {}", sizes_name),
+                results[1] = freelist_benchmark_random(buddy, 10000, operation_count, power_of_two_sizes));
+
+            hit_info("FreelistCore, {}: {} failed allocations, {:.1f}% fragmentation", sizes_name, results[0].failed_count, results[0].fragmentation * 100.0);
+            hit_info("BuddyAllocator, {}: {} failed allocations, {:.1f}% fragmentation", sizes_name, results[1].failed_count, results[1].fragmentation * 100.0);
+
+            test_check(freelist.get_free_space() == buffer_size && freelist.get_largest_free_block() == buffer_size);
+            test_check(buddy.get_free_space() == buffer_size && buddy.get_largest_free_block() == buffer_size);
+        }
+
+        test_success();
+    }
+
+    void add_freelist_benchmarks(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(freelist_benchmark_random_patterns));
+        test_system.add_test(get_test(freelist_benchmark_power_of_two_patterns));
+    }
+}
\ No newline at end of file
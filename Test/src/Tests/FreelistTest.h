@@ -2,7 +2,11 @@
 
 #include "../TestFramework.h"
 #include "Utils/Freelist.h"
+#include "Utils/Tlsf.h"
+#include "Utils/Buddy.h"
 
+#include <algorithm>
+#include <vector>
 
 namespace hit
 {
@@ -94,10 +98,338 @@ namespace hit
         test_success();
     }
 
+    test_val tlsf_test_1()
+    {
+        TlsfAllocator core(10);
+
+        ui64 out_offset;
+        test_check(core.push_size(5, out_offset));
+
+        test_check(out_offset == 0);
+
+        test_check(core.resize(20));
+
+        test_check(core.get_free_space() == 15);
+
+        test_check(core.push_size(10, out_offset));
+
+        test_check(out_offset == 5);
+
+        test_check(core.get_free_space() == 5);
+
+        test_check(!core.push_size(6, out_offset));
+
+        test_check(core.pop_size(10, 5));
+
+        test_check(core.pop_size(5, 0));
+
+        test_check(!core.pop_size(5, 0));
+
+        // everything was merged back in one block
+        test_check(core.get_free_space() == 20);
+        test_check(core.get_largest_free_block() == 20);
+
+        test_success();
+    }
+
+    test_val tlsf_alignment_test()
+    {
+        TlsfAllocator core(4096);
+
+        ui64 first, aligned, last;
+        test_check(core.push_size(3, first));
+        test_check(core.push_size(100, aligned, 256));
+        test_check(core.push_size(7, last, 16));
+
+        test_check(aligned % 256 == 0 && last % 16 == 0);
+
+        // the padding before an aligned block is still free
+        test_check(core.get_free_space() == 4096 - 110);
+
+        test_check(core.pop_size(100, aligned));
+        test_check(core.pop_size(3, first));
+        test_check(core.pop_size(7, last));
+
+        test_check(core.get_largest_free_block() == 4096);
+
+        test_success();
+    }
+
+    // random pushes and pops of aligned ranges on an allocator of size bytes, the allocations left
+    // are returned by offset and must not overlap
+    template<typename Core>
+    test_val random_allocations_workload(Core& core, ui64 size, std::vector<SubAllocation>& out_allocations)
+    {
+        ui64 random = 42;
+        for(ui64 i = 0; i < 20000; i++)
+        {
+            test_random(random);
+
+            if(!out_allocations.empty() && (random >> 60) < 7)
+            {
+                const ui64 index = (random >> 20) % out_allocations.size();
+
+                test_silent_check(core.pop_size(out_allocations[index].size, out_allocations[index].offset));
+
+                out_allocations[index] = out_allocations.back();
+                out_allocations.pop_back();
+            }
+            else
+            {
+                SubAllocation allocation = { 0, 1 + (random >> 33) % 4096, 1ull << ((random >> 40) % 8) };
+                if(core.push_size(allocation.size, allocation.offset, allocation.alignment))
+                {
+                    test_silent_check(allocation.offset % allocation.alignment == 0 && allocation.offset + allocation.size <= size);
+                    out_allocations.push_back(allocation);
+                }
+            }
+        }
+
+        std::sort(out_allocations.begin(), out_allocations.end(), [](const SubAllocation& a, const SubAllocation& b) { return a.offset < b.offset; });
+        for(ui64 i = 1; i < out_allocations.size(); i++) test_silent_check(out_allocations[i - 1].offset + out_allocations[i - 1].size <= out_allocations[i].offset);
+
+        test_success();
+    }
+
+    // freeing all of the random allocations leaves one block
+    test_val tlsf_random_test()
+    {
+        constexpr ui64 size = 1024 * 1024;
+
+        TlsfAllocator core(size);
+
+        std::vector<SubAllocation> allocations;
+        test_check(random_allocations_workload(core, size, allocations) == TEST_SUCCESS);
+
+        for(auto& allocation : allocations) test_silent_check(core.pop_size(allocation.size, allocation.offset));
+
+        test_check(core.get_free_space() == size);
+        test_check(core.get_largest_free_block() == size);
+
+        test_success();
+    }
+
+    test_val freelist_alignment_test()
+    {
+        FreelistCore core(4096);
+
+        ui64 first, aligned, last;
+        test_check(core.push_size(3, first));
+        test_check(core.push_size(100, aligned, 256));
+        test_check(core.push_size(7, last, 16));
+
+        test_check(first == 0 && aligned == 256 && last == 16);
+
+        // the padding before an aligned block is still free
+        test_check(core.get_free_space() == 4096 - 110);
+
+        test_check(core.pop_size(100, aligned));
+        test_check(core.pop_size(3, first));
+        test_check(core.pop_size(7, last));
+
+        test_check(core.get_largest_free_block() == 4096);
+
+        test_success();
+    }
+
+    test_val defragmentation_plan_test()
+    {
+        // given out of order, the first two are contiguous and stay so once moved
+        SubAllocation allocations[] =
+        {
+            { 300, 10, 1 },
+            { 100, 20, 1 },
+            { 120, 30, 1 },
+            { 500, 8, 64 }
+        };
+
+        auto plan = plan_defragmentation(allocations);
+
+        test_check(plan.allocations.size() == 4);
+        test_check(plan.allocations[1].offset == 0);
+        test_check(plan.allocations[2].offset == 20);
+        test_check(plan.allocations[0].offset == 50);
+        test_check(plan.allocations[3].offset == 64);
+        test_check(plan.used_size == 72);
+
+        test_check(plan.copies.size() == 3);
+        test_check(plan.copies[0].src_offset == 100 && plan.copies[0].dst_offset == 0 && plan.copies[0].size == 50);
+        test_check(plan.copies[1].src_offset == 300 && plan.copies[1].dst_offset == 50 && plan.copies[1].size == 10);
+        test_check(plan.copies[2].src_offset == 500 && plan.copies[2].dst_offset == 64 && plan.copies[2].size == 8);
+
+        test_success();
+    }
+
+    // a fragmented allocator rebuilt from the compacted layout has one free block at its end
+    template<typename Allocator>
+    test_val defragmentation_rebuild_test(Allocator& core, ui64 size)
+    {
+        std::vector<SubAllocation> allocations;
+
+        ui64 random = 7;
+        for(ui64 i = 0; i < 2000; i++)
+        {
+            test_random(random);
+
+            SubAllocation allocation = { 0, 1 + (random >> 33) % 512, 1ull << ((random >> 40) % 6) };
+            if(core.push_size(allocation.size, allocation.offset, allocation.alignment)) allocations.push_back(allocation);
+        }
+
+        // every other allocation is freed
+        std::vector<SubAllocation> live_allocations;
+        for(ui64 i = 0; i < allocations.size(); i++)
+        {
+            if(i % 2 == 0)
+            {
+                live_allocations.push_back(allocations[i]);
+                continue;
+            }
+
+            test_silent_check(core.pop_size(allocations[i].size, allocations[i].offset));
+        }
+
+        auto plan = plan_defragmentation(live_allocations);
+        test_check(core.rebuild(plan.allocations));
+
+        test_check(core.get_largest_free_block() == size - plan.used_size);
+
+        for(auto& allocation : plan.allocations)
+        {
+            test_silent_check(allocation.offset % allocation.alignment == 0);
+            test_silent_check(core.pop_size(allocation.size, allocation.offset));
+        }
+
+        test_check(core.get_free_space() == size);
+        test_check(core.get_largest_free_block() == size);
+
+        // overlapping allocations can't be rebuilt
+        SubAllocation overlapping[] = { { 0, 16, 1 }, { 8, 16, 1 } };
+        test_check(!core.rebuild(overlapping));
+        test_check(core.get_free_space() == size);
+
+        test_success();
+    }
+
+    test_val freelist_defragmentation_test()
+    {
+        FreelistCore core(1024 * 1024);
+        return defragmentation_rebuild_test(core, 1024 * 1024);
+    }
+
+    test_val tlsf_defragmentation_test()
+    {
+        TlsfAllocator core(1024 * 1024);
+        return defragmentation_rebuild_test(core, 1024 * 1024);
+    }
+
+    test_val buddy_test_1()
+    {
+        BuddyAllocator core(256, 16);
+
+        ui64 first, second, third;
+        test_check(core.push_size(16, first));
+        test_check(core.push_size(20, second));
+        test_check(core.push_size(100, third));
+
+        // sizes are rounded up to a block, which is aligned to its size
+        test_check(first == 0 && second == 32 && third == 128);
+        test_check(core.get_free_space() == 256 - 16 - 32 - 128);
+        test_check(core.get_largest_free_block() == 64);
+
+        test_check(!core.push_size(100, first, 1));
+        test_check(!core.pop_size(16, 16));
+        test_check(!core.pop_size(20, 48));
+
+        test_check(core.pop_size(20, second));
+        test_check(core.pop_size(16, 0));
+        test_check(!core.pop_size(16, 0));
+
+        // freed buddies were merged back
+        test_check(core.get_largest_free_block() == 128);
+
+        test_check(core.pop_size(100, third));
+        test_check(core.get_largest_free_block() == 256);
+
+        test_success();
+    }
+
+    test_val buddy_resize_test()
+    {
+        // the part past 1000 bytes is never handed out
+        BuddyAllocator core(1000, 16);
+        test_check(core.get_free_space() == 992);
+        test_check(core.get_largest_free_block() == 512);
+
+        ui64 offset;
+        test_check(core.push_size(512, offset) && offset == 0);
+        test_check(core.push_size(256, offset) && offset == 512);
+        test_check(!core.push_size(256, offset));
+
+        test_check(core.resize(3000));
+        test_check(core.get_free_space() == 2992 - 768);
+
+        test_check(core.push_size(1024, offset) && offset == 1024);
+        test_check(core.push_size(256, offset) && offset == 768);
+
+        test_check(core.pop_size(512, 0));
+        test_check(core.pop_size(256, 512));
+        test_check(core.pop_size(256, 768));
+        test_check(core.pop_size(1024, 1024));
+
+        test_check(core.get_free_space() == 2992);
+        test_check(core.get_largest_free_block() == 2048);
+
+        test_success();
+    }
+
+    // the random allocations compacted as whole blocks rebuild the tree, freeing them merges every buddy back
+    test_val buddy_random_test()
+    {
+        constexpr ui64 size = 1024 * 1024;
+
+        BuddyAllocator core(size, 16);
+
+        std::vector<SubAllocation> allocations;
+        test_check(random_allocations_workload(core, size, allocations) == TEST_SUCCESS);
+
+        // every allocation is a whole block, aligned to its power of two size
+        for(auto& allocation : allocations) test_silent_check(allocation.offset % core.get_block_size(allocation.size, allocation.alignment) == 0);
+
+        // whole blocks compacted and aligned to their size are valid blocks again
+        for(auto& allocation : allocations)
+        {
+            allocation.size = core.get_block_size(allocation.size, allocation.alignment);
+            allocation.alignment = allocation.size;
+        }
+
+        auto plan = plan_defragmentation(allocations);
+        test_check(core.rebuild(plan.allocations));
+
+        for(auto& allocation : plan.allocations) test_silent_check(core.pop_size(allocation.size, allocation.offset));
+
+        test_check(core.get_free_space() == size);
+        test_check(core.get_largest_free_block() == size);
+
+        test_success();
+    }
+
     void add_freelist_tests(TestSystem& test_system)
     {
         test_system.add_test(get_test(freelist_test_1));
         test_system.add_test(get_test(freelist_test_2));
         test_system.add_test(get_test(freelist_test_3));
+        test_system.add_test(get_test(freelist_alignment_test));
+
+        test_system.add_test(get_test(tlsf_test_1));
+        test_system.add_test(get_test(tlsf_alignment_test));
+        test_system.add_test(get_test(tlsf_random_test));
+
+        test_system.add_test(get_test(buddy_test_1));
+        test_system.add_test(get_test(buddy_resize_test));
+        test_system.add_test(get_test(buddy_random_test));
+
+        test_system.add_test(get_test(defragmentation_plan_test));
+        test_system.add_test(get_test(freelist_defragmentation_test));
+        test_system.add_test(get_test(tlsf_defragmentation_test));
     }
 }
\ No newline at end of file
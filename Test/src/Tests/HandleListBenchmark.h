@@ -0,0 +1,222 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Utils/HandleList.h"
+#include "Utils/FastHandleList.h"
+#include "Utils/ConcurrentHandleList.h"
+
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace hit
+{
+    struct HandleListBenchmarkValue
+    {
+        ui64 id;
+        f32 values[6];
+    };
+
+    // every round replaces a tenth of the handles at random and iterates everything, like resources of a running scene
+    template<typename List>
+    ui64 handle_list_benchmark_churn(ui64 count, ui64 rounds)
+    {
+        List list(count);
+        std::vector<Handle<HandleListBenchmarkValue>> handles(count);
+
+        for(ui64 i = 0; i < count; i++) handles[i] = list.add({ i });
+
+        ui64 random = 12345;
+        ui64 sum = 0;
+
+        for(ui64 round = 0; round < rounds; round++)
+        {
+            for(ui64 i = 0; i < count / 10; i++)
+            {
+                test_random(random);
+                const ui64 index = (random >> 33) % count;
+
+                list.remove(handles[index]);
+                handles[index] = list.add({ index });
+            }
+
+            for(const auto& value : list.data()) sum += value.id;
+        }
+
+        return sum;
+    }
+
+    // reference of a resource registry keyed by id, resources are scattered in the nodes
+    ui64 handle_list_benchmark_map_churn(ui64 count, ui64 rounds)
+    {
+        std::unordered_map<ui64, HandleListBenchmarkValue> map(count);
+        std::vector<ui64> keys(count);
+
+        ui64 next_key = 0;
+        for(ui64 i = 0; i < count; i++)
+        {
+            keys[i] = next_key++;
+            map[keys[i]] = { i };
+        }
+
+        ui64 random = 12345;
+        ui64 sum = 0;
+
+        for(ui64 round = 0; round < rounds; round++)
+        {
+            for(ui64 i = 0; i < count / 10; i++)
+            {
+                test_random(random);
+                const ui64 index = (random >> 33) % count;
+
+                map.erase(keys[index]);
+                keys[index] = next_key++;
+                map[keys[index]] = { index };
+            }
+
+            for(const auto& [key, value] : map) sum += value.id;
+        }
+
+        return sum;
+    }
+
+    test_val handle_list_benchmark_churn_sizes()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        // same amount of work for every size
+        for(ui64 count : { (ui64)1000, (ui64)100000, (ui64)1000000 })
+        {
+            const ui64 rounds = 10000000 / count;
+
+            ui64 sums[3] = { };
+
+            test_benchmark(std::format("HandleList churn, {} handles", count),
+                sums[0] = handle_list_benchmark_churn<HandleList<HandleListBenchmarkValue>>(count, rounds));
+
+            test_benchmark(std::format("FastHandleList churn, {} handles", count),
+                sums[1] = handle_list_benchmark_churn<FastHandleList<HandleListBenchmarkValue>>(count, rounds));
+
+            test_benchmark(std::format("unordered_map churn, {} handles", count),
+                sums[2] = handle_list_benchmark_map_churn(count, rounds));
+
+            test_check(sums[0] == sums[1] && sums[1] == sums[2]);
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    // a scene is loaded with emplace_n and destroyed at once, against adding and removing the handles one by one
+    test_val handle_list_benchmark_scene()
+    {
+        const ui64 count = 1000000;
+        const ui64 rounds = 10;
+
+        std::vector<Handle<HandleListBenchmarkValue>> handles(count);
+        HandleList<HandleListBenchmarkValue> list(count);
+
+        test_benchmark(std::format("HandleList one by one scene, {} handles", count),
+            for(ui64 round = 0; round < rounds; round++)
+            {
+                for(ui64 i = 0; i < count; i++) handles[i] = list.add({ i });
+                for(ui64 i = 0; i < count; i++) list.remove(handles[i]);
+            });
+
+        test_check(list.size() == 0);
+
+        test_benchmark(std::format("HandleList batch scene, {} handles", count),
+            for(ui64 round = 0; round < rounds; round++)
+            {
+                ArenaScope scope(get_scratch_arena());
+
+                auto scene = list.emplace_n(count, [](ui64 i) { return HandleListBenchmarkValue{ i }; });
+                list.remove_many(scene);
+            });
+
+        test_check(list.size() == 0);
+
+        test_success();
+    }
+
+    // every thread adds, gets and removes its share of the handles, the total work is the same for every thread count
+    template<typename Add, typename Get, typename Remove>
+    ui64 handle_list_benchmark_threads(ui32 thread_count, ui64 count, const Add& add, const Get& get, const Remove& remove)
+    {
+        std::atomic<ui64> sum = 0;
+        std::vector<std::thread> threads;
+
+        for(ui32 t = 0; t < thread_count; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                std::vector<Handle<HandleListBenchmarkValue>> handles(count / thread_count);
+                ui64 thread_sum = 0;
+
+                for(ui64 i = 0; i < handles.size(); i++) handles[i] = add({ i });
+
+                for(ui64 i = 0; i < handles.size(); i++)
+                {
+                    for(ui64 j = 0; j < 8; j++) thread_sum += get(handles[(i + j * 7919) % handles.size()]);
+                }
+
+                for(auto handle : handles) remove(handle);
+
+                sum += thread_sum;
+            });
+        }
+
+        for(auto& thread : threads) thread.join();
+
+        return sum;
+    }
+
+    test_val handle_list_benchmark_concurrent_scaling()
+    {
+        const ui64 count = 1000000;
+
+        for(ui32 thread_count : { 1u, 2u, 4u, 8u })
+        {
+            ui64 sums[2] = { };
+
+            {
+                ConcurrentHandleList<HandleListBenchmarkValue> list(64 * 1024);
+
+                test_benchmark(std::format("ConcurrentHandleList, {} threads", thread_count),
+                    sums[0] = handle_list_benchmark_threads(thread_count, count,
+                        [&](const HandleListBenchmarkValue& value) { return list.add(value); },
+                        [&](Handle<HandleListBenchmarkValue> handle) { return list.get(handle)->id; },
+                        [&](Handle<HandleListBenchmarkValue> handle) { list.remove(handle); });
+                    list.collect());
+
+                test_check(list.size() == 0);
+            }
+
+            {
+                FastHandleList<HandleListBenchmarkValue> list(count);
+                std::mutex mutex;
+
+                test_benchmark(std::format("FastHandleList with a mutex, {} threads", thread_count),
+                    sums[1] = handle_list_benchmark_threads(thread_count, count,
+                        [&](const HandleListBenchmarkValue& value) { std::lock_guard lock(mutex); return list.add(value); },
+                        [&](Handle<HandleListBenchmarkValue> handle) { std::lock_guard lock(mutex); return list.get(handle)->id; },
+                        [&](Handle<HandleListBenchmarkValue> handle) { std::lock_guard lock(mutex); list.remove(handle); }));
+
+                test_check(list.size() == 0);
+            }
+
+            test_check(sums[0] == sums[1]);
+        }
+
+        test_success();
+    }
+
+    void add_handle_list_benchmarks(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(handle_list_benchmark_churn_sizes));
+        test_system.add_test(get_test(handle_list_benchmark_scene));
+        test_system.add_test(get_test(handle_list_benchmark_concurrent_scaling));
+    }
+}
\ No newline at end of file
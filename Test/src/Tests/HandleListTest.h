@@ -4,8 +4,10 @@
 #include "Utils/HandleList.h"
 #include "Utils/FastHandleList.h"
 
-#include <vector>
+#include <algorithm>
 #include <span>
+#include <unordered_set>
+#include <vector>
 
 namespace hit
 {
@@ -88,10 +90,291 @@ namespace hit
         test_success();
     }
 
+    // HandleList with SegmentedArena resources test
+    test_val segmented_handle_list_test_1()
+    {
+        const int list_size = 100000;
+
+        HandleList<int, SegmentedArena<int>> list(1024);
+
+        Handle<int> first_handle = list.add(0);
+        int* first = list.get(first_handle);
+
+        std::vector<Handle<int>> handles;
+        for(auto i = 1; i < list_size; i++)
+        {
+            handles.push_back(list.emplace(i));
+            test_silent_check(handles.back().valid());
+        }
+
+        // adding never moves the resources
+        test_check(list.get(first_handle) == first);
+        test_check(*first == 0);
+
+        for(auto i = 0; i < 1000; i++)
+        {
+            list.remove(handles[i]);
+        }
+
+        for(auto i = 1000; i < (int)handles.size(); i++)
+        {
+            test_silent_check(*list.get(handles[i]) == i + 1);
+        }
+
+        ui64 count = 0;
+        for(ui64 i = 0; i < list.resources().chunk_count(); i++) count += list.resources().chunk(i).size();
+
+        test_check(count == list.size());
+        test_check(list.size() == list_size - 1000);
+
+        test_success();
+    }
+
+    // emplace_n, remove_many, reserve and iteration, for every kind of list
+    template<typename List>
+    test_val handle_list_batch_test(List& list)
+    {
+        const ui64 list_size = 10000;
+
+        list.reserve(list_size);
+        const ui64 capacity = list.resources().capacity();
+
+        ArenaScope scope(get_scratch_arena());
+
+        auto handles = list.emplace_n(list_size / 2, [](ui64 i) { return (int)i; });
+        auto copies = list.emplace_n(list_size / 2, -1);
+
+        test_check(handles.size() == list_size / 2 && copies.size() == list_size / 2);
+        test_check(list.size() == list_size);
+
+        // reserved room is enough, the storage didn't grow
+        test_check(list.resources().capacity() == capacity);
+
+        for(ui64 i = 0; i < handles.size(); i++)
+        {
+            test_silent_check(*list.get(handles[i]) == (int)i);
+            test_silent_check(*list.get(copies[i]) == -1);
+        }
+
+        // every entry handle resolves to its value
+        ui64 count = 0;
+        for(auto [handle, value] : list)
+        {
+            test_silent_check(list.get(handle) == &value);
+            count++;
+        }
+
+        test_check(count == list_size);
+
+        // removing the copies twice removes them once
+        std::vector<Handle<int>> removed(copies.begin(), copies.end());
+        removed.insert(removed.end(), copies.begin(), copies.end());
+
+        list.remove_many(removed);
+
+        test_check(list.size() == list_size / 2);
+        for(auto handle : copies) test_silent_check(!list.get(handle));
+
+        // the remaining resources keep their order
+        int previous = -1;
+        for(auto [handle, value] : list)
+        {
+            test_silent_check(value > previous);
+            previous = value;
+        }
+
+        // a few handles go through remove
+        list.remove_many(handles.subspan(0, 10));
+        test_check(list.size() == list_size / 2 - 10);
+
+        for(ui64 i = 10; i < handles.size(); i++) test_silent_check(*list.get(handles[i]) == (int)i);
+
+        // freed slots are reused by the next batch
+        auto reused = list.emplace_n(10, 7);
+        for(auto handle : reused) test_silent_check(handle.index() < list_size && *list.get(handle) == 7);
+
+        list.remove_many(handles);
+        list.remove_many(reused);
+
+        test_check(list.size() == 0);
+        test_check(list.begin() == list.end());
+
+        test_success();
+    }
+
+    test_val handle_list_batch_test_1()
+    {
+        HandleList<int> list;
+        return handle_list_batch_test(list);
+    }
+
+    test_val fast_handle_list_batch_test_1()
+    {
+        FastHandleList<int> list;
+        return handle_list_batch_test(list);
+    }
+
+    test_val segmented_handle_list_batch_test_1()
+    {
+        HandleList<int, SegmentedArena<int>> list(1024);
+        return handle_list_batch_test(list);
+    }
+
+    // handles kept across a reset don't resolve to the resources added after it
+    template<typename List>
+    test_val handle_list_reset_test(List& list)
+    {
+        const Handle<int> first = list.add(1);
+        const Handle<int> second = list.add(2);
+
+        list.reset();
+
+        test_check(list.size() == 0);
+        test_check(!list.get(first) && !list.get(second));
+
+        // the kept slots are reused in order with their new version
+        const Handle<int> reused = list.add(3);
+
+        test_check(reused.index() == first.index() && reused.version() != first.version());
+        test_check(!list.get(first) && *list.get(reused) == 3);
+
+        test_success();
+    }
+
+    test_val handle_list_reset_test_1()
+    {
+        HandleList<int> list;
+        return handle_list_reset_test(list);
+    }
+
+    test_val fast_handle_list_reset_test_1()
+    {
+        FastHandleList<int> list;
+        return handle_list_reset_test(list);
+    }
+
+    // a resource storage at its hard limit gives an invalid handle and leaves the list as it was
+    test_val handle_list_hard_limit_test()
+    {
+        HandleList<ui64> list(8, MemoryUsage::Platform);
+
+        Memory::set_usage_budget(MemoryUsage::Platform, { 0, Memory::get_memory_used(MemoryUsage::Platform) + 1024 });
+
+        std::vector<Handle<ui64>> handles;
+        for(Handle<ui64> handle = list.add(0); handle.valid(); handle = list.add(handles.size())) handles.push_back(handle);
+
+        test_check(handles.size() >= 8 && handles.size() < 256);
+        test_check(list.size() == handles.size());
+
+        ArenaScope scope(get_scratch_arena());
+        test_check(list.emplace_n(1024, (ui64)1).size() < 1024);
+
+        Memory::set_usage_budget(MemoryUsage::Platform, { });
+
+        for(ui64 i = 0; i < handles.size(); i++) test_silent_check(*list.get(handles[i]) == i);
+
+        // the rolled back slots are reused
+        const Handle<ui64> next = list.add(42);
+        test_check(next.valid() && *list.get(next) == 42);
+
+        for(auto [handle, value] : list) test_silent_check(list.get(handle) == &value);
+
+        test_success();
+    }
+
+    test_val handle_pack_test()
+    {
+        constexpr Handle<int> handle(123456, 789, 42);
+
+        static_assert(sizeof(Handle<int>) == sizeof(ui64));
+        static_assert(handle.index() == 123456 && handle.version() == 789 && handle.pool() == 42);
+        static_assert(Handle<int>::from_value(handle.value) == handle);
+        static_assert(!Handle<int>().valid() && Handle<int>().value == invalid_handle_value);
+
+        // versions only keep their low bits
+        test_check(Handle<int>(1, invalid_handle_version + 2).version() == 1);
+
+        // every field takes part in the comparison
+        test_check(Handle<int>(1, 2, 3) != Handle<int>(2, 1, 3));
+        test_check(Handle<int>(1, 2, 3) != Handle<int>(1, 2, 4));
+
+        // casting keeps the packed value
+        Handle<float> cast(handle);
+        test_check(cast.value == handle.value);
+
+        // sorted by pool, then by slot
+        std::vector<Handle<int>> handles = { { 5, 0, 2 }, { 9, 3, 1 }, { 1, 7, 2 }, { 2, 1, 1 } };
+        std::sort(handles.begin(), handles.end());
+
+        test_check(handles[0].index() == 2 && handles[1].index() == 9 && handles[2].index() == 1 && handles[3].index() == 5);
+
+        std::unordered_set<Handle<int>> set(handles.begin(), handles.end());
+        test_check(set.size() == 4 && set.contains({ 9, 3, 1 }) && !set.contains({ 9, 3, 2 }));
+
+        test_success();
+    }
+
+    test_val handle_registry_test()
+    {
+        Handle<int> handle;
+        Handle<float> float_handle;
+
+        {
+            HandleList<int> list;
+            FastHandleList<float> float_list;
+
+            handle = list.add(42);
+            float_handle = float_list.add(4.2f);
+
+            test_check(handle.pool() != 0 && handle.pool() != float_handle.pool());
+            test_check(get_handle_pool(handle.pool()) == &list);
+
+            test_check(resolve_handle(handle) == list.get(handle));
+            test_check(*resolve_handle(float_handle) == 4.2f);
+
+            // a handle of another type doesn't resolve, neither does it in the wrong list
+            test_check(!resolve_handle(Handle<float>(handle)));
+            test_check(!list.get(Handle<int>(handle.index(), handle.version(), float_handle.pool())));
+
+            // a moved list keeps its pool id
+            HandleList<int> moved = std::move(list);
+            test_check(get_handle_pool(handle.pool()) == &moved);
+            test_check(*resolve_handle(handle) == 42);
+
+            moved.remove(handle);
+            test_check(!resolve_handle(handle));
+        }
+
+        // the pools are unregistered with their lists
+        test_check(!get_handle_pool(handle.pool()) && !resolve_handle(float_handle));
+
+        // the next list doesn't take the id right away, so the stale handle stays invalid
+        HandleList<int> next_list;
+        const Handle<int> next_handle = next_list.add(7);
+
+        test_check(next_handle.pool() != handle.pool());
+        test_check(!next_list.get(handle) && !resolve_handle(handle));
+
+        test_success();
+    }
+
     void add_handle_list_tests(TestSystem& test_system)
     {
         test_system.add_test(get_test(handle_list_test_1));
 
         test_system.add_test(get_test(fast_handle_list_test_1));
+
+        test_system.add_test(get_test(segmented_handle_list_test_1));
+
+        test_system.add_test(get_test(handle_list_batch_test_1));
+        test_system.add_test(get_test(fast_handle_list_batch_test_1));
+        test_system.add_test(get_test(segmented_handle_list_batch_test_1));
+
+        test_system.add_test(get_test(handle_list_reset_test_1));
+        test_system.add_test(get_test(fast_handle_list_reset_test_1));
+        test_system.add_test(get_test(handle_list_hard_limit_test));
+
+        test_system.add_test(get_test(handle_pack_test));
+        test_system.add_test(get_test(handle_registry_test));
     }
 }
\ No newline at end of file
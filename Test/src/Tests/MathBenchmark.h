@@ -0,0 +1,252 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Math/Math.h"
+#include "Math/Simd.h"
+
+#include <vector>
+
+namespace hit
+{
+    // each kernel goes over the same matrices on every supported simd level, results are summed so they aren't optimized away
+    test_val math_benchmark_mat4_kernels()
+    {
+        constexpr ui64 matrix_count = 1024;
+        constexpr ui64 round_count = 1000;
+
+        std::vector<Mat4> matrices(matrix_count);
+        std::vector<Vec4> vectors(matrix_count);
+
+        for(ui64 i = 0; i < matrix_count; i++)
+        {
+            const f32 value = (f32)i / (f32)matrix_count;
+
+            matrices[i] = mat4_translation(value, -value, 2.0f * value) * mat4_euler_rotation(value * 90.0f, value * 45.0f, value * 30.0f) * mat4_scale(1.0f + value);
+            vectors[i] = { value, 1.0f - value, 0.5f, 1.0f };
+        }
+
+        const SimdLevel supported_level = get_supported_simd_level();
+
+        for(ui32 level = 0; level <= (ui32)supported_level; level++)
+        {
+            set_simd_level((SimdLevel)level);
+            const char* level_name = get_simd_level_name((SimdLevel)level);
+
+            f32 sum = 0.0f;
+
+            test_benchmark(std::format("mat4_mul, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                    for(ui64 i = 0; i < matrix_count; i++) sum += mat4_mul(matrices[i], matrices[(i + round) % matrix_count]).data[5]);
+
+            test_benchmark(std::format("Mat4::inverse, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                    for(ui64 i = 0; i < matrix_count; i++) sum += matrices[i].inverse().data[5]);
+
+            test_benchmark(std::format("Mat4::affine_inverse, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                    for(ui64 i = 0; i < matrix_count; i++) sum += matrices[i].affine_inverse().data[5]);
+
+            test_benchmark(std::format("Mat4::transposed, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                    for(ui64 i = 0; i < matrix_count; i++) sum += matrices[i].transposed().data[5]);
+
+            test_benchmark(std::format("mat4_mult_vec4, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                    for(ui64 i = 0; i < matrix_count; i++) sum += mat4_mult_vec4(vectors[(i + round) % matrix_count], matrices[i]).y);
+
+            hit_info("Checksum for {}: {}", level_name, sum);
+        }
+
+        set_simd_level(supported_level);
+
+        test_success();
+    }
+
+    // the same points as Vec3s one by one and as structure of arrays
+    test_val math_benchmark_transform_points()
+    {
+        const Mat4 transform = mat4_translation(3.0f, -2.0f, 1.0f) * mat4_euler_rotation(30.0f, 60.0f, 90.0f) * mat4_scale(2.0f);
+        const SimdLevel supported_level = get_supported_simd_level();
+
+        for(ui64 point_count : { 10000, 1000000 })
+        {
+            const ui64 round_count = 10000000 / point_count;
+
+            std::vector<Vec3> points(point_count), out_points(point_count);
+            std::vector<f32> xs(point_count), ys(point_count), zs(point_count);
+            std::vector<f32> out_xs(point_count), out_ys(point_count), out_zs(point_count);
+
+            for(ui64 i = 0; i < point_count; i++)
+            {
+                const f32 value = (f32)i / (f32)point_count;
+
+                points[i] = { value, 1.0f - value, 0.5f };
+                xs[i] = points[i].x;
+                ys[i] = points[i].y;
+                zs[i] = points[i].z;
+            }
+
+            f32 sum = 0.0f;
+
+            set_simd_level(SimdLevel::Scalar);
+            test_benchmark(std::format("{} points, Vec3 * Mat4", point_count),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    for(ui64 i = 0; i < point_count; i++) out_points[i] = points[i] * transform;
+                    sum += out_points[round % point_count].y;
+                });
+
+            for(ui32 level = 0; level <= (ui32)supported_level; level++)
+            {
+                set_simd_level((SimdLevel)level);
+
+                test_benchmark(std::format("{} points, transform_points, {}", point_count, get_simd_level_name((SimdLevel)level)),
+                    for(ui64 round = 0; round < round_count; round++)
+                    {
+                        transform_points(transform, xs, ys, zs, out_xs, out_ys, out_zs);
+                        sum += out_ys[round % point_count];
+                    });
+            }
+
+            hit_info("Checksum for {} points: {}", point_count, sum);
+        }
+
+        constexpr ui64 matrix_count = 10000;
+        constexpr ui64 round_count = 100;
+
+        std::vector<Mat4> m1(matrix_count), m2(matrix_count), out_m(matrix_count);
+        for(ui64 i = 0; i < matrix_count; i++)
+        {
+            const f32 value = (f32)i / (f32)matrix_count;
+
+            m1[i] = mat4_translation(value, -value, 2.0f * value) * mat4_scale(1.0f + value);
+            m2[i] = mat4_euler_rotation(value * 90.0f, value * 45.0f, value * 30.0f);
+        }
+
+        f32 sum = 0.0f;
+
+        for(ui32 level = 0; level <= (ui32)supported_level; level++)
+        {
+            set_simd_level((SimdLevel)level);
+            const char* level_name = get_simd_level_name((SimdLevel)level);
+
+            test_benchmark(std::format("{} matrices, mat4_mul loop, {}", matrix_count, level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    for(ui64 i = 0; i < matrix_count; i++) out_m[i] = mat4_mul(m1[i], m2[i]);
+                    sum += out_m[round].data[5];
+                });
+
+            test_benchmark(std::format("{} matrices, mat4_mul_batch, {}", matrix_count, level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    mat4_mul_batch(m1, m2, out_m);
+                    sum += out_m[round].data[5];
+                });
+        }
+
+        hit_info("Checksum for matrices: {}", sum);
+
+        set_simd_level(supported_level);
+
+        test_success();
+    }
+
+    // per object matrices from euler angles against stored transforms, and composing both ways
+    test_val math_benchmark_transform()
+    {
+        constexpr ui64 object_count = 10000;
+        constexpr ui64 round_count = 100;
+
+        std::vector<Vec3> translations(object_count), angles(object_count), scales(object_count);
+        std::vector<Transform> transforms(object_count);
+        std::vector<Mat4> matrices(object_count), out_m(object_count);
+        std::vector<Transform> out_t(object_count);
+
+        for(ui64 i = 0; i < object_count; i++)
+        {
+            const f32 value = (f32)i / (f32)object_count;
+
+            translations[i] = { value, -value, 2.0f * value };
+            angles[i] = { value * 90.0f, value * 45.0f, value * 30.0f };
+            scales[i] = Vec3(1.0f + value);
+
+            transforms[i] = { translations[i], quat_from_euler(angles[i]), scales[i] };
+            matrices[i] = transform_to_mat4(transforms[i]);
+        }
+
+        hit_info("Transform is {} bytes, Mat4 is {} bytes", sizeof(Transform), sizeof(Mat4));
+
+        const SimdLevel supported_level = get_supported_simd_level();
+
+        for(ui32 level = 0; level <= (ui32)supported_level; level++)
+        {
+            set_simd_level((SimdLevel)level);
+            const char* level_name = get_simd_level_name((SimdLevel)level);
+
+            f32 sum = 0.0f;
+
+            test_benchmark(std::format("translation * euler rotation * scale, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    for(ui64 i = 0; i < object_count; i++) out_m[i] = mat4_translation(translations[i]) * mat4_euler_rotation(angles[i]) * mat4_scale(scales[i]);
+                    sum += out_m[round].data[5];
+                });
+
+            test_benchmark(std::format("quat_from_euler and transform_to_mat4, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    for(ui64 i = 0; i < object_count; i++) out_m[i] = transform_to_mat4({ translations[i], quat_from_euler(angles[i]), scales[i] });
+                    sum += out_m[round].data[5];
+                });
+
+            test_benchmark(std::format("transform_to_mat4_batch, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    transform_to_mat4_batch(transforms, out_m);
+                    sum += out_m[round].data[5];
+                });
+
+            test_benchmark(std::format("Mat4 composition, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    for(ui64 i = 0; i < object_count; i++) out_m[i] = matrices[i] * matrices[(i + round) % object_count];
+                    sum += out_m[round].data[5];
+                });
+
+            test_benchmark(std::format("Transform composition, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    for(ui64 i = 0; i < object_count; i++) out_t[i] = transforms[i] * transforms[(i + round) % object_count];
+                    sum += out_t[round].rotation.y;
+                });
+
+            test_benchmark(std::format("Mat4::affine_inverse, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    for(ui64 i = 0; i < object_count; i++) out_m[i] = matrices[i].affine_inverse();
+                    sum += out_m[round].data[5];
+                });
+
+            test_benchmark(std::format("transform_inverse, {}", level_name),
+                for(ui64 round = 0; round < round_count; round++)
+                {
+                    for(ui64 i = 0; i < object_count; i++) out_t[i] = transform_inverse(transforms[i]);
+                    sum += out_t[round].rotation.y;
+                });
+
+            hit_info("Checksum for {}: {}", level_name, sum);
+        }
+
+        set_simd_level(supported_level);
+
+        test_success();
+    }
+
+    void add_math_benchmarks(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(math_benchmark_mat4_kernels));
+        test_system.add_test(get_test(math_benchmark_transform_points));
+        test_system.add_test(get_test(math_benchmark_transform));
+    }
+}
\ No newline at end of file
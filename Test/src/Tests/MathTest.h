@@ -2,6 +2,9 @@
 
 #include "../TestFramework.h"
 #include "Math/Math.h"
+#include "Math/Simd.h"
+
+#include <vector>
 
 namespace hit
 {
@@ -77,10 +80,295 @@ namespace hit
         test_success();
     }
 
+    test_val math_mat4_test()
+    {
+        const Mat4 transform = mat4_translation(1.0f, 2.0f, 3.0f) * mat4_euler_rotation(30.0f, 45.0f, 60.0f) * mat4_scale(2.0f, 3.0f, 4.0f);
+
+        test_check((transform * mat4_identity()).compare_to(transform));
+        test_check((transform * transform.inverse()).compare_to(mat4_identity()));
+        test_check(transform.affine_inverse().compare_to(transform.inverse()));
+        test_check(transform.transposed().transposed().compare_to(transform));
+
+        // M * v takes the columns, v * M the rows
+        const Vec4 point = { 1.0f, -2.0f, 0.5f, 1.0f };
+        test_check(mat4_mult_vec4(point, transform) == transform[0] * point.x + transform[1] * point.y + transform[2] * point.z + transform[3] * point.w);
+        test_check(mat4_mult_vec4(transform, point) == Vec4(transform[0].dot(point), transform[1].dot(point), transform[2].dot(point), transform[3].dot(point)));
+
+        // singular matrices give back the identity
+        test_check(Mat4().inverse().compare_to(mat4_identity()));
+        test_check(Mat4().affine_inverse().compare_to(mat4_identity()));
+
+        test_success();
+    }
+
+    // every simd level supported by the cpu gives the results of the scalar kernels
+    test_val math_mat4_simd_test()
+    {
+        const SimdLevel supported_level = get_supported_simd_level();
+        hit_info("Supported simd level: {}", get_simd_level_name(supported_level));
+
+        ui64 random = 99;
+        auto random_f32 = [&random]()
+        {
+            test_random(random);
+            return (f32)((random >> 40) & 0xFFFF) / 32768.0f - 1.0f;
+        };
+
+        std::vector<Mat4> matrices(256);
+        std::vector<Mat4> affine_matrices(256);
+        std::vector<Vec4> vectors(256);
+
+        for(ui64 i = 0; i < matrices.size(); i++)
+        {
+            // a strong diagonal keeps them invertible
+            for(f32& value : matrices[i].data) value = random_f32();
+            for(ui32 j = 0; j < 4; j++) matrices[i][j][j] += 4.0f;
+
+            affine_matrices[i] = mat4_translation(random_f32() * 10.0f, random_f32() * 10.0f, random_f32() * 10.0f) *
+                mat4_euler_rotation(random_f32() * 180.0f, random_f32() * 180.0f, random_f32() * 180.0f) *
+                mat4_scale(2.0f + random_f32(), 2.0f + random_f32(), 2.0f + random_f32());
+
+            vectors[i] = { random_f32(), random_f32(), random_f32(), random_f32() };
+        }
+
+        for(ui32 level = (ui32)SimdLevel::Sse41; level <= (ui32)supported_level; level++)
+        {
+            for(ui64 i = 0; i < matrices.size(); i++)
+            {
+                const Mat4& m1 = matrices[i];
+                const Mat4& m2 = matrices[(i + 1) % matrices.size()];
+                const Mat4& affine = affine_matrices[i];
+                const Vec4& v = vectors[i];
+
+                set_simd_level(SimdLevel::Scalar);
+                const Mat4 mul = m1 * m2;
+                const Mat4 inverse = m1.inverse();
+                const Mat4 affine_inverse = affine.affine_inverse();
+                const Mat4 transposed = m1.transposed();
+                const Vec4 mult_vec4 = m1 * v;
+                const Vec4 vec4_mult = v * m1;
+
+                set_simd_level((SimdLevel)level);
+                test_silent_check((m1 * m2).compare_to(mul, 0.0001f));
+                test_silent_check(m1.inverse().compare_to(inverse, 0.0001f));
+                test_silent_check(affine.affine_inverse().compare_to(affine_inverse, 0.0001f));
+                test_silent_check(m1.transposed().compare_to(transposed, 0.0f));
+                test_silent_check((m1 * v).compare_to(mult_vec4, 0.0001f));
+                test_silent_check((v * m1).compare_to(vec4_mult, 0.0001f));
+            }
+
+            hit_info("Simd level {} matches the scalar kernels.", get_simd_level_name((SimdLevel)level));
+        }
+
+        set_simd_level(supported_level);
+
+        test_success();
+    }
+
+    // the counts go through the vector lanes alone, the tails alone and both
+    test_val math_batch_test()
+    {
+        const SimdLevel supported_level = get_supported_simd_level();
+
+        ui64 random = 7;
+        auto random_f32 = [&random]()
+        {
+            test_random(random);
+            return (f32)((random >> 40) & 0xFFFF) / 32768.0f - 1.0f;
+        };
+
+        const Mat4 transform = mat4_translation(3.0f, -2.0f, 1.0f) * mat4_euler_rotation(30.0f, 60.0f, 90.0f) * mat4_scale(2.0f);
+
+        for(ui64 count : { 0, 1, 7, 8, 13, 1000 })
+        {
+            std::vector<f32> xs(count), ys(count), zs(count);
+            std::vector<Mat4> m1(count), m2(count);
+
+            for(ui64 i = 0; i < count; i++)
+            {
+                xs[i] = random_f32() * 10.0f;
+                ys[i] = random_f32() * 10.0f;
+                zs[i] = random_f32() * 10.0f;
+
+                for(f32& value : m1[i].data) value = random_f32();
+                for(f32& value : m2[i].data) value = random_f32();
+            }
+
+            for(ui32 level = 0; level <= (ui32)supported_level; level++)
+            {
+                set_simd_level((SimdLevel)level);
+
+                std::vector<f32> out_xs(count), out_ys(count), out_zs(count);
+                std::vector<Mat4> out_m(count);
+
+                transform_points(transform, xs, ys, zs, out_xs, out_ys, out_zs);
+                mat4_mul_batch(m1, m2, out_m);
+
+                set_simd_level(SimdLevel::Scalar);
+                for(ui64 i = 0; i < count; i++)
+                {
+                    test_silent_check(Vec3(out_xs[i], out_ys[i], out_zs[i]).compare_to(Vec3(xs[i], ys[i], zs[i]) * transform, 0.0001f));
+                    test_silent_check(out_m[i].compare_to(m1[i] * m2[i], 0.0001f));
+                }
+            }
+        }
+
+        // in place
+        std::vector<f32> xs = { 1.0f, 2.0f, 3.0f }, ys = { 0.0f, 0.0f, 0.0f }, zs = { -1.0f, -2.0f, -3.0f };
+        set_simd_level(supported_level);
+        transform_points(mat4_translation(1.0f, 2.0f, 3.0f), xs, ys, zs, xs, ys, zs);
+
+        test_check(xs[2] == 4.0f && ys[2] == 2.0f && zs[2] == 0.0f);
+
+        test_success();
+    }
+
+    test_val math_quat_test()
+    {
+        // quarter turn around z takes x to y
+        const Quat quarter_z = quat_from_axis_angle({ 0.0f, 0.0f, 1.0f }, 90.0f);
+        test_check((quarter_z * Vec3(1.0f, 0.0f, 0.0f)).compare_to({ 0.0f, 1.0f, 0.0f }));
+        test_check(quat_to_mat4(quarter_z).compare_to(mat4_euler_z(90.0f)));
+
+        test_check((quarter_z * quarter_z.conjugate()).compare_to(quat_identity()));
+        test_check((quarter_z * quarter_z.inverse()).compare_to(quat_identity()));
+        test_check(quat_to_mat4(quat_identity()).compare_to(mat4_identity(), 0.0f));
+
+        for(f32 angle = -180.0f; angle <= 180.0f; angle += 45.0f)
+        {
+            const Vec3 angles(angle, angle * 0.5f + 10.0f, 30.0f - angle);
+            const Quat q = quat_from_euler(angles);
+            const Mat4 rotation = mat4_euler_rotation(angles);
+            const Vec3 v(1.0f, -2.0f, 3.0f);
+
+            test_silent_check(q.length() > 0.999f && q.length() < 1.001f);
+            test_silent_check(quat_to_mat4(q).compare_to(rotation));
+            test_silent_check((q * v).compare_to(v * rotation));
+            test_silent_check(quat_to_mat4(q * quarter_z).compare_to(rotation * mat4_euler_z(90.0f)));
+        }
+
+        // the ends, the middle and the shorter way around
+        const Quat eighth_z = quat_from_axis_angle({ 0.0f, 0.0f, 1.0f }, 45.0f);
+        test_check(quat_slerp(quat_identity(), quarter_z, 0.0f).compare_to(quat_identity()));
+        test_check(quat_slerp(quat_identity(), quarter_z, 1.0f).compare_to(quarter_z));
+        test_check(quat_slerp(quat_identity(), quarter_z, 0.5f).compare_to(eighth_z));
+        test_check(quat_nlerp(quat_identity(), quarter_z, 0.5f).compare_to(eighth_z));
+
+        const Quat flipped(-quarter_z.x, -quarter_z.y, -quarter_z.z, -quarter_z.w);
+        test_check(quat_to_mat4(quat_slerp(quat_identity(), flipped, 0.5f)).compare_to(quat_to_mat4(eighth_z)));
+        test_check(quat_to_mat4(quat_nlerp(quat_identity(), flipped, 0.5f)).compare_to(quat_to_mat4(eighth_z)));
+
+        // constant speed, a third of the way is a third of the angle
+        const Quat third_x = quat_from_axis_angle({ 1.0f, 0.0f, 0.0f }, 120.0f);
+        test_check(quat_slerp(quat_identity(), third_x, 0.25f).compare_to(quat_from_axis_angle({ 1.0f, 0.0f, 0.0f }, 30.0f)));
+
+        test_success();
+    }
+
+    test_val math_transform_test()
+    {
+        Transform transform;
+        transform.translation = { 3.0f, -2.0f, 1.0f };
+        transform.rotation = quat_from_euler(30.0f, 60.0f, 90.0f);
+        transform.scale = { 2.0f, 3.0f, 4.0f };
+
+        const Mat4 trs = mat4_translation(transform.translation) * mat4_euler_rotation(30.0f, 60.0f, 90.0f) * mat4_scale(transform.scale);
+        test_check(transform_to_mat4(transform).compare_to(trs));
+        test_check(transform_to_mat4(transform_identity()).compare_to(mat4_identity(), 0.0f));
+
+        const Vec3 point(1.0f, 2.0f, 3.0f);
+        test_check((transform * point).compare_to(point * trs));
+
+        // composition and inverse match the matrices for uniform scales
+        Transform child;
+        child.translation = { -1.0f, 0.5f, 2.0f };
+        child.rotation = quat_from_euler(-45.0f, 10.0f, 20.0f);
+        child.scale = Vec3(0.5f);
+
+        Transform parent = transform;
+        parent.scale = Vec3(2.0f);
+
+        test_check(transform_to_mat4(parent * child).compare_to(transform_to_mat4(parent) * transform_to_mat4(child)));
+        test_check(((parent * child) * point).compare_to(parent * (child * point)));
+        test_check(transform_to_mat4(transform_inverse(parent)).compare_to(transform_to_mat4(parent).inverse()));
+        test_check((parent * transform_inverse(parent)).compare_to(transform_identity()));
+
+        test_check(transform_lerp(parent, child, 0.0f).compare_to(parent));
+        test_check(transform_lerp(parent, child, 1.0f).compare_to(child));
+
+        std::vector<Transform> transforms = { transform, parent, child };
+        std::vector<Mat4> matrices(transforms.size());
+        transform_to_mat4_batch(transforms, matrices);
+
+        for(ui64 i = 0; i < transforms.size(); i++) test_silent_check(matrices[i].compare_to(transform_to_mat4(transforms[i]), 0.0f));
+
+        test_success();
+    }
+
+    test_val math_transform_simd_test()
+    {
+        const SimdLevel supported_level = get_supported_simd_level();
+
+        ui64 random = 13;
+        auto random_f32 = [&random]()
+        {
+            test_random(random);
+            return (f32)((random >> 40) & 0xFFFF) / 32768.0f - 1.0f;
+        };
+
+        std::vector<Transform> transforms(256);
+        std::vector<Vec3> points(256);
+
+        for(ui64 i = 0; i < transforms.size(); i++)
+        {
+            transforms[i].translation = { random_f32() * 10.0f, random_f32() * 10.0f, random_f32() * 10.0f };
+            transforms[i].rotation = quat_from_euler(random_f32() * 180.0f, random_f32() * 180.0f, random_f32() * 180.0f);
+            transforms[i].scale = { 2.0f + random_f32(), 2.0f + random_f32(), 2.0f + random_f32() };
+
+            points[i] = { random_f32(), random_f32(), random_f32() };
+        }
+
+        for(ui32 level = (ui32)SimdLevel::Sse41; level <= (ui32)supported_level; level++)
+        {
+            for(ui64 i = 0; i < transforms.size(); i++)
+            {
+                const Transform& t1 = transforms[i];
+                const Transform& t2 = transforms[(i + 1) % transforms.size()];
+                const Vec3& point = points[i];
+
+                set_simd_level(SimdLevel::Scalar);
+                const Quat quat_mul = t1.rotation * t2.rotation;
+                const Vec3 quat_rotate = t1.rotation * point;
+                const Transform mul = t1 * t2;
+                const Transform inverse = transform_inverse(t1);
+                const Mat4 to_mat4 = transform_to_mat4(t1);
+
+                set_simd_level((SimdLevel)level);
+                test_silent_check((t1.rotation * t2.rotation).compare_to(quat_mul, 0.0001f));
+                test_silent_check((t1.rotation * point).compare_to(quat_rotate, 0.0001f));
+                test_silent_check((t1 * t2).compare_to(mul, 0.0001f));
+                test_silent_check(transform_inverse(t1).compare_to(inverse, 0.0001f));
+                test_silent_check(transform_to_mat4(t1).compare_to(to_mat4, 0.0001f));
+            }
+
+            hit_info("Simd level {} matches the scalar transform kernels.", get_simd_level_name((SimdLevel)level));
+        }
+
+        set_simd_level(supported_level);
+
+        test_success();
+    }
+
     void add_math_tests(TestSystem& test_system)
     {
         test_system.add_test(get_test(math_vec2_test));
         test_system.add_test(get_test(math_vec3_test));
         test_system.add_test(get_test(math_vec4_test));
+        test_system.add_test(get_test(math_mat4_test));
+        test_system.add_test(get_test(math_mat4_simd_test));
+        test_system.add_test(get_test(math_batch_test));
+        test_system.add_test(get_test(math_quat_test));
+        test_system.add_test(get_test(math_transform_test));
+        test_system.add_test(get_test(math_transform_simd_test));
     }
 }
\ No newline at end of file
@@ -0,0 +1,286 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Core/Memory.h"
+#include "Utils/Arena.h"
+
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <string.h>
+
+namespace hit
+{
+    // reference of the old memory system tracking, which looks up every allocation in a global map.
+    // it was not thread safe, so a mutex is used when running it with multiple threads
+    struct MapMemoryTracker
+    {
+        std::unordered_map<ui8*, Memory::Usage> usages;
+        std::mutex mutex;
+
+        ui8* allocate_memory(ui64 size, Memory::Usage::Type usage)
+        {
+            ui8* memory = (ui8*)::operator new(size);
+            std::memset(memory, 0, size);
+
+            std::lock_guard lock(mutex);
+            usages[memory] = { usage, size, memory };
+
+            return memory;
+        }
+
+        void deallocate_memory(ui8* memory)
+        {
+            {
+                std::lock_guard lock(mutex);
+                usages.erase(usages.find(memory));
+            }
+
+            ::operator delete(memory);
+        }
+    };
+
+    // reference of the malloc backend, used before size class slabs
+    struct MallocMemoryBackend
+    {
+        static ui8* allocate_memory(ui64 size)
+        {
+            ui8* memory = (ui8*)std::malloc(16 + size);
+            std::memset(memory + 16, 0, size);
+            return memory + 16;
+        }
+
+        static void deallocate_memory(ui8* memory)
+        {
+            std::free(memory - 16);
+        }
+    };
+
+    constexpr ui64 memory_benchmark_rounds = 200;
+    constexpr ui64 memory_benchmark_batch = 1000;
+
+    template<typename Allocate, typename Deallocate>
+    void memory_benchmark_workload(Allocate&& allocate, Deallocate&& deallocate)
+    {
+        std::vector<ui8*> memories(memory_benchmark_batch);
+
+        for(ui64 round = 0; round < memory_benchmark_rounds; round++)
+        {
+            for(ui64 i = 0; i < memory_benchmark_batch; i++)
+            {
+                memories[i] = allocate(16 + (i % 16) * 16);
+            }
+
+            for(auto memory : memories)
+            {
+                deallocate(memory);
+            }
+        }
+    }
+
+    template<typename Workload>
+    void memory_benchmark_run_threads(ui32 thread_count, Workload&& workload)
+    {
+        std::vector<std::thread> threads;
+
+        for(ui32 i = 0; i < thread_count; i++)
+        {
+            threads.emplace_back(workload);
+        }
+
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    test_val memory_benchmark_single_thread()
+    {
+        MapMemoryTracker map_tracker;
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        test_benchmark("map tracking, 1 thread", memory_benchmark_workload(
+            [&](ui64 size) { return map_tracker.allocate_memory(size, MemoryUsage::Any); },
+            [&](ui8* memory) { map_tracker.deallocate_memory(memory); }));
+
+        test_benchmark("header tracking, 1 thread", memory_benchmark_workload(
+            [](ui64 size) { return Memory::allocate_memory(size, MemoryUsage::Any); },
+            [](ui8* memory) { Memory::deallocate_memory(memory); }));
+
+        test_check(map_tracker.usages.empty());
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    test_val memory_benchmark_multi_thread()
+    {
+        constexpr ui32 thread_count = 8;
+
+        MapMemoryTracker map_tracker;
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        test_benchmark("map tracking, 8 threads", memory_benchmark_run_threads(thread_count, [&]()
+        {
+            memory_benchmark_workload(
+                [&](ui64 size) { return map_tracker.allocate_memory(size, MemoryUsage::Any); },
+                [&](ui8* memory) { map_tracker.deallocate_memory(memory); });
+        }));
+
+        test_benchmark("header tracking, 8 threads", memory_benchmark_run_threads(thread_count, []()
+        {
+            memory_benchmark_workload(
+                [](ui64 size) { return Memory::allocate_memory(size, MemoryUsage::Any); },
+                [](ui8* memory) { Memory::deallocate_memory(memory); });
+        }));
+
+        test_check(map_tracker.usages.empty());
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    // small blocks released in an interleaved order, like handle lists and serializer buffers do
+    template<typename Allocate, typename Deallocate>
+    void memory_benchmark_small_blocks_workload(Allocate&& allocate, Deallocate&& deallocate)
+    {
+        std::vector<ui8*> memories(memory_benchmark_batch);
+
+        for(ui64 i = 0; i < memories.size(); i++)
+        {
+            memories[i] = allocate(8 + (i * 7) % 248);
+        }
+
+        for(ui64 round = 0; round < memory_benchmark_rounds * 4; round++)
+        {
+            for(ui64 i = round % 3; i < memories.size(); i += 3)
+            {
+                deallocate(memories[i]);
+                memories[i] = allocate(8 + (i * round) % 248);
+            }
+        }
+
+        for(auto memory : memories)
+        {
+            deallocate(memory);
+        }
+    }
+
+    test_val memory_benchmark_small_blocks()
+    {
+        constexpr ui32 thread_count = 8;
+
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        test_benchmark("malloc backend, 1 thread", memory_benchmark_small_blocks_workload(
+            MallocMemoryBackend::allocate_memory, MallocMemoryBackend::deallocate_memory));
+
+        test_benchmark("slab backend, 1 thread", memory_benchmark_small_blocks_workload(
+            [](ui64 size) { return Memory::allocate_memory(size, MemoryUsage::Any); },
+            [](ui8* memory) { Memory::deallocate_memory(memory); }));
+
+        test_benchmark("malloc backend, 8 threads", memory_benchmark_run_threads(thread_count, []()
+        {
+            memory_benchmark_small_blocks_workload(
+                MallocMemoryBackend::allocate_memory, MallocMemoryBackend::deallocate_memory);
+        }));
+
+        test_benchmark("slab backend, 8 threads", memory_benchmark_run_threads(thread_count, []()
+        {
+            memory_benchmark_small_blocks_workload(
+                [](ui64 size) { return Memory::allocate_memory(size, MemoryUsage::Any); },
+                [](ui8* memory) { Memory::deallocate_memory(memory); });
+        }));
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    // cost of leaving the call site tracing on, sampled and for every allocation
+    test_val memory_benchmark_tracing()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        auto allocate = [](ui64 size) { return Memory::allocate_memory(size, MemoryUsage::Any); };
+        auto deallocate = [](ui8* memory) { Memory::deallocate_memory(memory); };
+
+        test_benchmark("not traced", memory_benchmark_small_blocks_workload(allocate, deallocate));
+
+        Memory::enable_allocation_tracing(64);
+        test_benchmark("1 in 64 traced", memory_benchmark_small_blocks_workload(allocate, deallocate));
+
+        Memory::enable_allocation_tracing(1);
+        test_benchmark("all traced", memory_benchmark_small_blocks_workload(allocate, deallocate));
+
+        Memory::enable_allocation_tracing(64, true);
+        test_benchmark("1 in 64 traced with backtraces", memory_benchmark_small_blocks_workload(allocate, deallocate));
+
+        Memory::disable_allocation_tracing();
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    // creates a big arena and fills it once, like a loaded file or a staging buffer
+    template<typename Create>
+    void memory_benchmark_arena_fill_workload(Create&& create)
+    {
+        constexpr ui64 arena_size = 32 * 1024 * 1024;
+
+        for(ui64 round = 0; round < 8; round++)
+        {
+            Arena arena = create(arena_size);
+
+            auto memory = arena.push_memory(arena_size - 1);
+            std::memset(memory, (i32)round, arena_size - 1);
+        }
+    }
+
+    test_val memory_benchmark_arena_creation()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        test_benchmark("memset arena", memory_benchmark_arena_fill_workload([](ui64 size)
+        {
+            // what arenas did before, touching the whole block on creation
+            Arena arena(size, MemoryUsage::Any, Memory::uninitialized_allocation);
+            std::memset((ui8*)arena.memory(), 0, arena.capacity());
+            return arena;
+        }));
+
+        test_benchmark("zeroed arena", memory_benchmark_arena_fill_workload([](ui64 size)
+        {
+            return Arena(size);
+        }));
+
+        test_benchmark("uninitialized arena", memory_benchmark_arena_fill_workload([](ui64 size)
+        {
+            return Arena(size, MemoryUsage::Any, Memory::uninitialized_allocation);
+        }));
+
+        Memory::AllocationOptions huge_page_options = Memory::uninitialized_allocation;
+        huge_page_options.huge_pages = true;
+
+        test_benchmark("uninitialized huge page arena", memory_benchmark_arena_fill_workload([&](ui64 size)
+        {
+            return Arena(size, MemoryUsage::Any, huge_page_options);
+        }));
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    void add_memory_benchmarks(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(memory_benchmark_single_thread));
+        test_system.add_test(get_test(memory_benchmark_multi_thread));
+        test_system.add_test(get_test(memory_benchmark_small_blocks));
+        test_system.add_test(get_test(memory_benchmark_tracing));
+        test_system.add_test(get_test(memory_benchmark_arena_creation));
+    }
+}
\ No newline at end of file
@@ -3,6 +3,12 @@
 #include "../TestFramework.h"
 #include "Core/Memory.h"
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace hit
 {
     // raw memory test
@@ -50,6 +56,437 @@ namespace hit
         test_success();
     }
 
+    test_val memory_get_usage_test()
+    {
+        const ui64 memory_used = Memory::get_memory_used(Memory::Usage::Renderer);
+
+        auto memory = Memory::allocate_memory(48, Memory::Usage::Renderer);
+        auto usage = Memory::get_usage(memory);
+
+        test_check(Memory::has_memory(memory));
+        test_check(usage.memory == memory);
+        test_check(usage.size == 48);
+        test_check(usage.usage == Memory::Usage::Renderer);
+        test_check(Memory::get_memory_used(Memory::Usage::Renderer) == memory_used + 48);
+
+        memory = Memory::reallocate_memory(memory, 96);
+        test_check(Memory::get_usage(memory).size == 96);
+        test_check(Memory::get_memory_used(Memory::Usage::Renderer) == memory_used + 96);
+
+        Memory::deallocate_memory(memory);
+        test_check(Memory::get_memory_used(Memory::Usage::Renderer) == memory_used);
+
+        test_success();
+    }
+
+    test_val memory_realloc_size_class_test()
+    {
+        // grows from a small slab block, to a bigger one and then to a large allocation
+        auto memory = Memory::allocate_memory(20, Memory::Usage::Any);
+        for(ui8 i = 0; i < 20; i++) memory[i] = i;
+
+        for(ui64 new_size : { 24, 100, 700, 4096, 64 })
+        {
+            memory = Memory::reallocate_memory(memory, new_size);
+            test_check(memory);
+            test_check(Memory::get_usage(memory).size == new_size);
+
+            for(ui8 i = 0; i < 20; i++) test_silent_check(memory[i] == i);
+        }
+
+        Memory::deallocate_memory(memory);
+
+        test_success();
+    }
+
+    test_val memory_allocation_options_test()
+    {
+        // over aligned blocks keep its alignment when moved by a reallocation
+        Memory::AllocationOptions aligned_options;
+        aligned_options.alignment = 64;
+
+        auto aligned = Memory::allocate_memory(40, Memory::Usage::Any, aligned_options);
+        test_check((ui64)aligned % 64 == 0);
+        test_check(Memory::get_usage(aligned).size == 40);
+
+        for(ui8 i = 0; i < 40; i++) aligned[i] = i;
+
+        aligned = Memory::reallocate_memory(aligned, 5000);
+        test_check((ui64)aligned % 64 == 0);
+        for(ui8 i = 0; i < 40; i++) test_silent_check(aligned[i] == i);
+
+        Memory::deallocate_memory(aligned);
+
+        // big zeroed blocks and huge page hinted ones
+        constexpr ui64 big_size = 4 * 1024 * 1024;
+
+        auto zeroed = Memory::allocate_memory(big_size, Memory::Usage::Any);
+        for(ui64 i = 0; i < big_size; i += 4096) test_silent_check(zeroed[i] == 0);
+
+        Memory::AllocationOptions huge_page_options;
+        huge_page_options.huge_pages = true;
+
+        auto huge_page = Memory::allocate_memory(big_size, Memory::Usage::Any, huge_page_options);
+        for(ui64 i = 0; i < big_size; i += 4096) test_silent_check(huge_page[i] == 0);
+
+        auto uninitialized = Memory::allocate_memory(big_size, Memory::Usage::Any, Memory::uninitialized_allocation);
+        test_check(Memory::get_usage(uninitialized).size == big_size);
+
+        Memory::deallocate_memory(zeroed);
+        Memory::deallocate_memory(huge_page);
+        Memory::deallocate_memory(uninitialized);
+
+        test_success();
+    }
+
+    test_val memory_multi_thread_test()
+    {
+        const ui64 memory_used = Memory::get_memory_used(Memory::Usage::Platform);
+
+        // memory allocated in one thread and released in another one
+        std::vector<ui8*> memories(1000);
+        std::thread producer([&]()
+        {
+            for(auto& memory : memories) memory = Memory::allocate_memory(64, Memory::Usage::Platform);
+        });
+        producer.join();
+
+        test_check(Memory::get_memory_used(Memory::Usage::Platform) == memory_used + 64 * memories.size());
+
+        std::vector<std::thread> consumers;
+        for(ui64 i = 0; i < 4; i++)
+        {
+            consumers.emplace_back([&, i]()
+            {
+                for(ui64 j = i; j < memories.size(); j += 4) Memory::deallocate_memory(memories[j]);
+            });
+        }
+
+        for(auto& consumer : consumers) consumer.join();
+
+        test_check(Memory::get_memory_used(Memory::Usage::Platform) == memory_used);
+
+        test_success();
+    }
+
+    test_val memory_statistics_test()
+    {
+        const auto before = Memory::get_usage_statistics(Memory::Usage::Platform);
+
+        auto small = Memory::allocate_memory(24, Memory::Usage::Platform);
+        auto big = Memory::allocate_memory(1024 * 1024, Memory::Usage::Platform);
+
+        auto statistics = Memory::get_usage_statistics(Memory::Usage::Platform);
+        test_check(statistics.live_bytes == before.live_bytes + 24 + 1024 * 1024);
+        test_check(statistics.peak_bytes >= statistics.live_bytes);
+        test_check(statistics.live_allocations == before.live_allocations + 2);
+        test_check(statistics.total_allocations == before.total_allocations + 2);
+
+        // 24 bytes go in the 32 bytes bucket and 1MB in its own
+        test_check(statistics.size_histogram[1] == before.size_histogram[1] + 1);
+        test_check(statistics.size_histogram[16] == before.size_histogram[16] + 1);
+        test_check(Memory::get_size_histogram_bucket_size(16) == 1024 * 1024);
+
+        Memory::deallocate_memory(big);
+        Memory::deallocate_memory(small);
+
+        // the peak stays after the memory is released
+        const auto after = Memory::get_usage_statistics(Memory::Usage::Platform);
+        test_check(after.live_bytes == before.live_bytes);
+        test_check(after.peak_bytes >= before.live_bytes + 1024 * 1024);
+        test_check(after.total_frees == before.total_frees + 2);
+
+        test_success();
+    }
+
+    test_val memory_frame_statistics_test()
+    {
+        Memory::end_memory_frame();
+        const ui64 frame = Memory::get_memory_frame();
+
+        std::vector<ui8*> memories;
+        for(ui32 i = 0; i < 10; i++) memories.push_back(Memory::allocate_memory(64, Memory::Usage::Renderer));
+        for(ui32 i = 0; i < 4; i++) Memory::deallocate_memory(memories[i]);
+
+        Memory::end_memory_frame();
+        test_check(Memory::get_memory_frame() == frame + 1);
+
+        auto statistics = Memory::get_usage_statistics(Memory::Usage::Renderer);
+        test_check(statistics.frame_allocations == 10);
+        test_check(statistics.frame_frees == 4);
+
+        for(ui32 i = 4; i < 10; i++) Memory::deallocate_memory(memories[i]);
+
+        Memory::end_memory_frame();
+
+        statistics = Memory::get_usage_statistics(Memory::Usage::Renderer);
+        test_check(statistics.frame_allocations == 0);
+        test_check(statistics.frame_frees == 6);
+
+        test_success();
+    }
+
+    test_val memory_usage_tag_test()
+    {
+        const auto tag = Memory::register_usage_tag("Test_Tag");
+        test_check((ui32)tag >= Memory::Usage::MaxUsageCount);
+        test_check(Memory::register_usage_tag("Test_Tag") == tag);
+        test_check(Memory::get_usage_name(tag) == "Test_Tag");
+
+        const ui64 total_memory_used = Memory::get_total_memory_used();
+
+        auto memory = Memory::allocate_memory(100, tag);
+        test_check(Memory::get_usage(memory).usage == tag);
+        test_check(Memory::get_memory_used(tag) == 100);
+        test_check(Memory::get_total_memory_used() == total_memory_used + 100);
+
+        Memory::deallocate_memory(memory);
+        test_check(Memory::get_usage_statistics(tag).live_allocations == 0);
+
+        test_success();
+    }
+
+    test_val memory_statistics_dump_test()
+    {
+        const std::string filename = "memory_statistics_test.csv";
+        std::remove(filename.c_str());
+
+        Memory::set_memory_statistics_dump(filename, 2);
+        for(ui32 i = 0; i < 4; i++) Memory::end_memory_frame();
+        Memory::set_memory_statistics_dump(filename, 0);
+
+        // a header and a row per usage for each of the two dumps
+        std::ifstream file(filename);
+        test_check(file.is_open());
+
+        ui32 line_count = 0;
+        for(std::string line; std::getline(file, line);) line_count++;
+
+        file.close();
+        std::remove(filename.c_str());
+
+        test_check(line_count == 1 + 2 * Memory::get_usage_count());
+
+        test_success();
+    }
+
+    test_val memory_tracing_test()
+    {
+        Memory::enable_allocation_tracing();
+        test_check(Memory::is_allocation_tracing_enabled());
+
+        std::vector<ui8*> memories;
+        for(ui32 i = 0; i < 10; i++) memories.push_back(Memory::allocate_memory(100, Memory::Usage::Platform));
+        const ui32 first_line = std::source_location::current().line() - 1;
+
+        auto retained = Memory::allocate_memory(5000, Memory::Usage::Renderer);
+        const ui32 second_line = std::source_location::current().line() - 1;
+
+        // moved by a reallocation, still counted to the same site
+        retained = Memory::reallocate_memory(retained, 10000);
+
+        for(auto memory : memories) Memory::deallocate_memory(memory);
+
+        Memory::end_memory_frame();
+
+        auto sites = Memory::get_allocation_sites();
+        test_check(sites.size() == 2);
+
+        const auto& first = sites[0].location.line() == first_line ? sites[0] : sites[1];
+        const auto& second = sites[0].location.line() == second_line ? sites[0] : sites[1];
+
+        test_check(first.location.line() == first_line && second.location.line() == second_line);
+        test_check(first.usage == Memory::Usage::Platform);
+        test_check(first.total_allocations == 10 && first.total_bytes == 1000);
+        test_check(first.live_allocations == 0 && first.live_bytes == 0);
+        test_check(first.frame_allocations == 10);
+        test_check(second.live_allocations == 1 && second.live_bytes == 10000);
+
+        const std::string filename = "allocation_report_test.txt";
+        test_check(Memory::write_allocation_report(filename));
+
+        std::ifstream file(filename);
+        const std::string report((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::remove(filename.c_str());
+
+        test_check(report.find("10 allocations, 1000 bytes") != std::string::npos);
+        test_check(report.find("10000 bytes in 1 allocations") != std::string::npos);
+
+        Memory::deallocate_memory(retained);
+        Memory::disable_allocation_tracing();
+
+        test_check(Memory::get_allocation_sites()[0].live_bytes == 0 && Memory::get_allocation_sites()[1].live_bytes == 0);
+
+        test_success();
+    }
+
+    test_val memory_sampled_tracing_test()
+    {
+        Memory::enable_allocation_tracing(8, true);
+
+        std::vector<ui8*> memories;
+        for(ui32 i = 0; i < 800; i++) memories.push_back(Memory::allocate_memory(32, Memory::Usage::Any));
+
+        auto sites = Memory::get_allocation_sites();
+        test_check(sites.size() >= 1);
+
+        // every sample stands for 8 allocations
+        ui64 total_allocations = 0;
+        for(const auto& site : sites) total_allocations += site.total_allocations;
+        test_check(total_allocations >= 792 && total_allocations <= 800);
+        test_check(total_allocations % 8 == 0);
+
+        for(auto memory : memories) Memory::deallocate_memory(memory);
+        Memory::disable_allocation_tracing();
+
+        for(const auto& site : Memory::get_allocation_sites()) test_check(site.live_allocations == 0);
+
+        test_success();
+    }
+
+    test_val memory_snapshot_test()
+    {
+        Memory::enable_allocation_tracing();
+
+        auto freed = Memory::allocate_memory(64, Memory::Usage::Platform);
+        const auto first = Memory::take_snapshot();
+
+        std::vector<ui8*> memories;
+        for(ui32 i = 0; i < 4; i++) memories.push_back(Memory::allocate_memory(1000, Memory::Usage::Renderer));
+        const ui32 grown_line = std::source_location::current().line() - 1;
+
+        Memory::deallocate_memory(freed);
+        Memory::end_memory_frame();
+
+        const auto last = Memory::take_snapshot();
+        test_check(last.frame == first.frame + 1);
+
+        const auto snapshot_diff = Memory::diff(first, last);
+        test_check(snapshot_diff.usages.size() == 2);
+
+        // the biggest growth comes first
+        test_check(snapshot_diff.usages[0].usage == Memory::Usage::Renderer);
+        test_check(snapshot_diff.usages[0].grown_bytes == 4000 && snapshot_diff.usages[0].new_allocations == 4);
+        test_check(snapshot_diff.usages[1].usage == Memory::Usage::Platform);
+        test_check(snapshot_diff.usages[1].grown_bytes == -64 && snapshot_diff.usages[1].freed_allocations == 1);
+
+        test_check(snapshot_diff.sites.size() == 2);
+        test_check(snapshot_diff.sites[0].site.location.line() == grown_line && snapshot_diff.sites[0].grown_bytes == 4000);
+        test_check(snapshot_diff.sites[1].grown_bytes == -64 && snapshot_diff.sites[1].freed_allocations == 1);
+
+        const std::string filename = "memory_snapshot_test.txt";
+        std::remove(filename.c_str());
+        test_check(Memory::write_snapshot_diff(filename, snapshot_diff));
+        std::remove(filename.c_str());
+
+        for(auto memory : memories) Memory::deallocate_memory(memory);
+        Memory::disable_allocation_tracing();
+
+        // nothing changed
+        const auto same = Memory::take_snapshot();
+        test_check(Memory::diff(same, same).usages.empty() && Memory::diff(same, same).sites.empty());
+
+        test_success();
+    }
+
+    test_val memory_allocation_guard_test()
+    {
+        // checked out of the scope, logging a test allocates
+        bool allocated = true;
+        {
+            Memory::AllocationGuard guard("no allocations");
+
+            ui64 values[16];
+            for(ui64 i = 0; i < 16; i++) values[i] = i;
+
+            allocated = guard.exceeded();
+        }
+
+        test_check(!allocated);
+
+        ui64 counts[3] = { };
+        bool exceeded[2] = { };
+        {
+            Memory::AllocationGuard guard("allocations over budget", 1, false);
+
+            auto memory = Memory::allocate_memory(32, Memory::Usage::Any);
+            exceeded[0] = guard.exceeded();
+
+            memory = Memory::reallocate_memory(memory, 64);
+            counts[0] = guard.allocation_count();
+            exceeded[1] = guard.exceeded();
+
+            // a nested guard only counts its own scope
+            {
+                Memory::AllocationGuard nested_guard("nested", 0, false);
+                counts[1] = nested_guard.allocation_count();
+            }
+
+            Memory::deallocate_memory(memory);
+        }
+
+        // test.cpp counts global operator new too
+        {
+            Memory::AllocationGuard guard("global new", 0, false);
+
+            std::vector<ui64> values(16);
+            counts[2] = guard.allocation_count();
+        }
+
+        test_check(!exceeded[0] && exceeded[1]);
+        test_check(counts[0] == 2 && counts[1] == 0);
+        test_check(counts[2] == 1);
+
+        test_success();
+    }
+
+    test_val memory_budget_test()
+    {
+        const ui64 memory_used = Memory::get_memory_used(Memory::Usage::Platform);
+        Memory::set_usage_budget(Memory::Usage::Platform, { memory_used + 1000, memory_used + 4000 });
+
+        // a cache the callback drops when the soft limit is crossed
+        ui8* cached = Memory::allocate_memory(600, Memory::Usage::Platform);
+        ui32 eviction_count = 0;
+
+        const ui32 callback_id = Memory::add_eviction_callback(Memory::Usage::Platform, [&](MemoryUsage usage, ui64 excess_bytes)
+        {
+            eviction_count++;
+
+            if(!cached) return;
+
+            Memory::deallocate_memory(cached);
+            cached = nullptr;
+        });
+
+        auto m1 = Memory::allocate_memory(300, Memory::Usage::Platform);
+        test_check(eviction_count == 0);
+
+        auto m2 = Memory::allocate_memory(300, Memory::Usage::Platform);
+        test_check(eviction_count == 1 && !cached);
+        test_check(Memory::get_memory_used(Memory::Usage::Platform) == memory_used + 600);
+
+        // under the soft limit again, so crossing it evicts again
+        auto m3 = Memory::allocate_memory(300, Memory::Usage::Platform);
+        auto m4 = Memory::allocate_memory(3000, Memory::Usage::Platform);
+        test_check(eviction_count == 2);
+
+        // nothing left to evict, the allocation fails without asserting
+        auto failed = Memory::allocate_memory(200, Memory::Usage::Platform);
+        test_check(!failed);
+        test_check(eviction_count == 3);
+        test_check(!Memory::reallocate_memory(m1, 500));
+
+        Memory::remove_eviction_callback(callback_id);
+        Memory::set_usage_budget(Memory::Usage::Platform, { });
+
+        for(auto memory : { m1, m2, m3, m4 }) Memory::deallocate_memory(memory);
+        test_check(Memory::get_memory_used(Memory::Usage::Platform) == memory_used);
+
+        test_success();
+    }
+
     // memory usages tests
     test_val memory_allocation_deallocation_usage_test()
     {
@@ -104,6 +541,19 @@ namespace hit
             test_system.add_test(get_test(memory_leak_test));
             test_system.add_test(get_test(memory_realloc_test));
             test_system.add_test(get_test(memory_copy_set_test));
+            test_system.add_test(get_test(memory_get_usage_test));
+            test_system.add_test(get_test(memory_realloc_size_class_test));
+            test_system.add_test(get_test(memory_allocation_options_test));
+            test_system.add_test(get_test(memory_multi_thread_test));
+            test_system.add_test(get_test(memory_statistics_test));
+            test_system.add_test(get_test(memory_frame_statistics_test));
+            test_system.add_test(get_test(memory_usage_tag_test));
+            test_system.add_test(get_test(memory_statistics_dump_test));
+            test_system.add_test(get_test(memory_tracing_test));
+            test_system.add_test(get_test(memory_sampled_tracing_test));
+            test_system.add_test(get_test(memory_snapshot_test));
+            test_system.add_test(get_test(memory_allocation_guard_test));
+            test_system.add_test(get_test(memory_budget_test));
         }
 
         // memory test usages
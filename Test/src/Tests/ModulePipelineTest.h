@@ -0,0 +1,100 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Core/Engine.h"
+#include "Utils/Arena.h"
+#include "Utils/FrameAllocator.h"
+#include "Utils/HandleList.h"
+#include "Utils/TypedArena.h"
+
+namespace hit
+{
+    // does the per frame work of a module with the engine containers, after its first frames it must not allocate
+    class SteadyStateTestModule : public Module
+    {
+    protected:
+        bool initialize() override
+        {
+            if(!m_frame_allocator.create(2, 1024 * 1024)) return false;
+            if(!m_draws.create(256)) return false;
+
+            for(ui32 i = 0; i < 64; i++) m_handles.push_back(m_resources.add(i));
+
+            return true;
+        }
+
+        void shutdown() override
+        {
+            m_frame_allocator.destroy();
+            m_draws.destroy();
+        }
+
+        bool execute() override
+        {
+            m_frame_allocator.begin_frame();
+
+            auto transforms = m_frame_allocator.allocate_array<f32>(16 * 64);
+            for(ui32 i = 0; i < 16 * 64; i++) transforms[i] = (f32)i;
+
+            ArenaScope scope(get_scratch_arena());
+            auto visible = (ui32*)get_scratch_arena().push_memory(64 * sizeof(ui32));
+
+            m_draws.clear();
+            for(ui32 i = 0; i < 64; i++)
+            {
+                visible[i] = *m_resources.get(m_handles[i]);
+                m_draws.push_back(visible[i]);
+            }
+
+            return m_draws.size() == 64;
+        }
+
+    private:
+        FrameAllocator m_frame_allocator;
+        TypedArena<ui32> m_draws;
+        HandleList<ui32> m_resources;
+        std::vector<Handle<ui32>> m_handles;
+    };
+
+    test_val module_pipeline_zero_allocation_test()
+    {
+        constexpr ui32 warmup_frame_count = 3;
+        constexpr ui32 frame_count = 100;
+
+        Engine engine;
+
+        ModulePipeline pipeline;
+        pipeline.set_engine(&engine);
+        test_check(pipeline.add_module("Steady state 1", create_ref<SteadyStateTestModule>()));
+        test_check(pipeline.add_module("Steady state 2", create_ref<SteadyStateTestModule>()));
+        test_check(pipeline.initialize_pipeline());
+
+        // the first frames create the scratch arena and commit the frame memory
+        for(ui32 i = 0; i < warmup_frame_count; i++) test_check(pipeline.execute_modules());
+
+        // logging a test allocates, so the count is checked out of the guard
+        ui64 allocation_count = 0;
+        {
+            Memory::AllocationGuard guard("module pipeline steady state", 0, false);
+
+            for(ui32 i = 0; i < frame_count; i++)
+            {
+                test_silent_check(pipeline.execute_modules());
+                Memory::end_memory_frame();
+            }
+
+            allocation_count = guard.allocation_count();
+        }
+
+        test_check(allocation_count == 0);
+
+        pipeline.shutdown_pipeline();
+
+        test_success();
+    }
+
+    void add_module_pipeline_tests(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(module_pipeline_zero_allocation_test));
+    }
+}
\ No newline at end of file
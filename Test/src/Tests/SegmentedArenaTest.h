@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../TestFramework.h"
+#include "Utils/SegmentedArena.h"
+
+#include <string>
+#include <vector>
+
+namespace hit
+{
+    test_val segmented_arena_test_1()
+    {
+        SegmentedArena<ui64> t_arena;
+        test_check(t_arena.create(100));
+
+        // rounded up to a power of two
+        test_check(t_arena.chunk_size() == 128);
+        test_check(t_arena.capacity() == 0);
+
+        std::vector<ui64*> pointers;
+        for(ui64 i = 0; i < 1000; i++)
+        {
+            pointers.push_back(t_arena.push_back(i));
+        }
+
+        test_check(t_arena.size() == 1000);
+        test_check(t_arena.chunk_count() == 8);
+        test_check(t_arena.capacity() == 1024);
+
+        // growing never moves the elements
+        for(ui64 i = 0; i < 1000; i++)
+        {
+            test_silent_check(t_arena[i] == pointers[i]);
+            test_silent_check(*t_arena[i] == i);
+        }
+
+        ui64 index = 0;
+        for(ui64 i = 0; i < t_arena.chunk_count(); i++)
+        {
+            for(auto value : t_arena.chunk(i)) test_silent_check(value == index++);
+        }
+
+        test_check(index == 1000);
+        test_check(t_arena.chunk(7).size() == 1000 - 7 * 128);
+
+        test_success();
+    }
+
+    test_val segmented_arena_test_2()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        {
+            SegmentedArena<std::string> t_arena(16);
+            for(auto i = 0; i < 100; i++)
+                test_check(t_arena.emplace_back(std::format("a string long enough to be on the heap {}", i)));
+
+            SegmentedArena<std::string> t_copy = t_arena;
+            test_check(t_copy.size() == 100);
+            test_check(*t_copy[99] == *t_arena[99]);
+
+            t_copy.rewind(10);
+            test_check(t_copy.size() == 10);
+            test_check(t_copy.chunk_count() == 1);
+
+            SegmentedArena<std::string> t_moved = std::move(t_arena);
+            test_check(t_moved.size() == 100);
+            test_check(t_arena.size() == 0);
+        }
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    test_val segmented_arena_recycle_test()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        SegmentedArena<ui64> recycled(64);
+        SegmentedArena<ui64> released(64, MemoryUsage::Any, false);
+
+        for(ui64 i = 0; i < 1000; i++)
+        {
+            recycled.push_back(i);
+            released.push_back(i);
+        }
+
+        recycled.clear();
+        released.clear();
+
+        test_check(recycled.empty() && released.empty());
+        test_check(recycled.capacity() == 1024);
+        test_check(released.capacity() == 0);
+
+        // recycled chunks are reused, nothing is allocated again
+        const ui64 recycled_memory_used = Memory::get_memory_used(MemoryUsage::Any);
+        for(ui64 i = 0; i < 1000; i++) recycled.push_back(i);
+
+        test_check(*recycled[999] == 999);
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == recycled_memory_used);
+
+        recycled.destroy();
+        released.destroy();
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    void add_segmented_arena_tests(TestSystem& test_system)
+    {
+        test_system.add_test(get_test(segmented_arena_test_1));
+        test_system.add_test(get_test(segmented_arena_test_2));
+        test_system.add_test(get_test(segmented_arena_recycle_test));
+    }
+}
\ No newline at end of file
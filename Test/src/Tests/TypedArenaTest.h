@@ -4,6 +4,7 @@
 #include "Utils/TypedArena.h"
 
 #include <string.h>
+#include <string>
 
 namespace hit
 {
@@ -109,6 +110,99 @@ namespace hit
         test_success();
     }
 
+    test_val typed_arena_alignment_test()
+    {
+        struct alignas(32) AlignedValue
+        {
+            f32 values[8];
+        };
+
+        TypedArena<AlignedValue> t_arena(4);
+        for(auto i = 0; i < 100; i++)
+        {
+            auto value = t_arena.emplace_back();
+            test_silent_check((ui64)value % 32 == 0);
+        }
+
+        test_success();
+    }
+
+    test_val typed_arena_virtual_test()
+    {
+        const ui64 memory_used = Memory::get_memory_used(MemoryUsage::Any);
+
+        TypedArena<ui64> t_arena;
+        test_check(t_arena.create_virtual(1000000, MemoryUsage::Any, true));
+        test_check(t_arena.capacity() == 1000000);
+
+        // growing never moves the elements
+        auto first = t_arena.push_back(0);
+        for(ui64 i = 1; i < 100000; i++)
+        {
+            test_silent_check(t_arena.push_back(i));
+        }
+
+        test_check(first == t_arena.get(0));
+        for(ui64 i = 0; i < 100000; i++) test_silent_check(*t_arena[i] == i);
+
+        test_check(Memory::get_memory_used(MemoryUsage::Any) >= memory_used + 100000 * sizeof(ui64));
+
+        // decommitted on reset
+        t_arena.clear();
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_check(*t_arena.push_back(7) == 7);
+
+        t_arena.destroy();
+        test_check(Memory::get_memory_used(MemoryUsage::Any) == memory_used);
+
+        test_success();
+    }
+
+    // counts live instances, so growing must move each element once and destroy the old one
+    struct TypedArenaCountedString
+    {
+        inline static i64 live_count = 0;
+
+        std::string value;
+
+        TypedArenaCountedString(const std::string& value) : value(value) { live_count++; }
+        TypedArenaCountedString(const TypedArenaCountedString& other) : value(other.value) { live_count++; }
+        TypedArenaCountedString(TypedArenaCountedString&& other) noexcept : value(std::move(other.value)) { live_count++; }
+        ~TypedArenaCountedString() { live_count--; }
+    };
+
+    test_val typed_arena_non_trivial_test()
+    {
+        static_assert(!is_trivially_relocatable_v<TypedArenaCountedString>);
+
+        {
+            TypedArena<TypedArenaCountedString> t_arena(2);
+            for(auto i = 0; i < 1000; i++)
+            {
+                test_silent_check(t_arena.emplace_back(std::format("a string long enough to be on the heap {}", i)));
+            }
+
+            test_check(TypedArenaCountedString::live_count == 1000);
+            for(auto i = 0; i < 1000; i++)
+            {
+                test_silent_check(t_arena[i]->value == std::format("a string long enough to be on the heap {}", i));
+            }
+
+            TypedArena<TypedArenaCountedString> t_copy = t_arena;
+            test_check(TypedArenaCountedString::live_count == 2000);
+            test_check(t_copy.size() == 1000);
+            test_check(t_copy[999]->value == t_arena[999]->value);
+
+            t_copy.pop_array_back(500);
+            test_check(TypedArenaCountedString::live_count == 1500);
+        }
+
+        test_check(TypedArenaCountedString::live_count == 0);
+
+        test_success();
+    }
+
     void add_typed_arena_tests(TestSystem& test_system)
     {
         test_system.add_test(get_test(typed_arena_test_1));
@@ -116,5 +210,8 @@ namespace hit
         test_system.add_test(get_test(typed_arena_test_3));
         test_system.add_test(get_test(typed_arena_test_4));
         test_system.add_test(get_test(typed_arena_test_5));
+        test_system.add_test(get_test(typed_arena_alignment_test));
+        test_system.add_test(get_test(typed_arena_virtual_test));
+        test_system.add_test(get_test(typed_arena_non_trivial_test));
     }
 }
\ No newline at end of file
@@ -1,11 +1,25 @@
 #include "TestFramework.h"
 #include "Tests/MemoryTest.h"
+#include "Tests/MemoryBenchmark.h"
+#include "Tests/ArenaBenchmark.h"
+#include "Tests/ArenaTest.h"
 #include "Tests/TypedArenaTest.h"
 #include "Tests/FastTypedArenaTest.h"
+#include "Tests/SegmentedArenaTest.h"
+#include "Tests/ConcurrentArenaTest.h"
+#include "Tests/FrameAllocatorTest.h"
 #include "Tests/HandleListTest.h"
+#include "Tests/ConcurrentHandleListTest.h"
+#include "Tests/HandleListBenchmark.h"
 #include "Tests/MathTest.h"
+#include "Tests/MathBenchmark.h"
 #include "Tests/ConfigurationFileTest.h"
 #include "Tests/FreelistTest.h"
+#include "Tests/FreelistBenchmark.h"
+#include "Tests/ModulePipelineTest.h"
+
+// allocation guards count std containers too
+hit_count_global_new()
 
 using namespace hit;
 
@@ -29,12 +43,23 @@ int main()
     test_system.initialize();
 
     //add_memory_system_tests(test_system);
+    //add_memory_benchmarks(test_system);
+    //add_arena_benchmarks(test_system);
+    //add_arena_tests(test_system);
     //add_typed_arena_tests(test_system);
     //add_fast_typed_arena_tests(test_system);
+    //add_segmented_arena_tests(test_system);
+    //add_concurrent_arena_tests(test_system);
+    //add_frame_allocator_tests(test_system);
     //add_handle_list_tests(test_system);
+    //add_concurrent_handle_list_tests(test_system);
+    //add_handle_list_benchmarks(test_system);
     //add_math_tests(test_system);
+    //add_math_benchmarks(test_system);
     add_config_file_tests(test_system);
     //add_freelist_tests(test_system);
+    //add_freelist_benchmarks(test_system);
+    //add_module_pipeline_tests(test_system);
 
     test_system.run_all();
     